@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Shared helpers for the benchmark executables
+
+namespace benchmark
+{
+    /// Wall-clock time spent processing a known amount of audio
+    struct Measurement
+    {
+        double seconds = 0.0;           // Time spent in the timed blocks
+        juce::int64 numSamples = 0;     // Sample frames processed (all channels at once)
+
+        double getNanosecondsPerSample() const { return numSamples > 0 ? seconds * 1.0e9 / static_cast<double>(numSamples) : 0.0; }
+        double getSamplesPerSecond() const     { return seconds > 0.0 ? static_cast<double>(numSamples) / seconds : 0.0; }
+        double getRealtimeFactor(double sampleRate) const { return getSamplesPerSecond() / sampleRate; }
+    };
+
+    template <typename SampleType>
+    void fillWithNoise(juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+                data[sample] = static_cast<SampleType>(random.nextFloat() * 2.0f - 1.0f) * SampleType(0.5);
+        }
+    }
+
+    inline juce::dsp::ProcessSpec makeSpec(double sampleRate, int blockSize, int numChannels)
+    {
+        return { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+    }
+
+    /// Runs processBlock over the given amount of audio, after a short warm-up that
+    /// settles caches and filter states. The noise block is processed in place over and
+    /// over, like a plugin fed its own output; denormals are flushed as in the plugin.
+    template <typename SampleType, typename ProcessFunction>
+    Measurement measure(int numChannels, int blockSize, double sampleRate, double secondsOfAudio,
+                        ProcessFunction&& processBlock)
+    {
+        juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+        juce::Random random(1234);
+        fillWithNoise(buffer, random);
+
+        const auto numBlocks = juce::jmax(1, static_cast<int>(secondsOfAudio * sampleRate / blockSize));
+        juce::ScopedNoDenormals noDenormals;
+
+        for (int i = 0; i < 16; ++i)
+            processBlock(buffer);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numBlocks; ++i)
+            processBlock(buffer);
+
+        Measurement result;
+        result.seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        result.numSamples = static_cast<juce::int64>(numBlocks) * blockSize;
+        return result;
+    }
+}
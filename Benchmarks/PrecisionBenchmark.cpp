@@ -0,0 +1,134 @@
+#include <JuceHeader.h>
+#include "BenchmarkUtils.h"
+#include "DSP/SaturationProcessor.h"
+#include "DSP/Oversampling.h"
+#include "DSP/FilterChain.h"
+#include "DSP/CabinetSimulator.h"
+#include "DSP/MidSideProcessor.h"
+
+// Compares float and double throughput of each DSP stage at the same settings.
+// Usage: spice_precision_bench [blockSize] [seconds of audio]
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+
+    /// Runs processBlock over the given amount of audio and returns the realtime factor
+    template <typename SampleType, typename ProcessFunction>
+    double measure(int blockSize, double secondsOfAudio, ProcessFunction&& processBlock)
+    {
+        return benchmark::measure<SampleType>(numChannels, blockSize, sampleRate, secondsOfAudio, processBlock)
+                   .getRealtimeFactor(sampleRate);
+    }
+
+    juce::dsp::ProcessSpec makeSpec(int blockSize)
+    {
+        return benchmark::makeSpec(sampleRate, blockSize, numChannels);
+    }
+
+    template <typename SampleType>
+    double benchmarkSaturation(int blockSize, double seconds)
+    {
+        SaturationProcessor<SampleType> saturation;
+        saturation.prepare(makeSpec(blockSize));
+        saturation.setDrive(SampleType(60));
+        saturation.setModel(SaturationProcessor<SampleType>::Model::Tube12AX7);
+
+        return measure<SampleType>(blockSize, seconds, [&](juce::AudioBuffer<SampleType>& buffer)
+        {
+            juce::dsp::AudioBlock<SampleType> block(buffer);
+            saturation.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+        });
+    }
+
+    template <typename SampleType>
+    double benchmarkOversampling(int blockSize, double seconds)
+    {
+        Oversampling<SampleType> oversampling(numChannels, 2, Oversampling<SampleType>::filterHalfBandPolyphaseIIR);
+        oversampling.prepare(makeSpec(blockSize));
+
+        return measure<SampleType>(blockSize, seconds, [&](juce::AudioBuffer<SampleType>& buffer)
+        {
+            juce::dsp::AudioBlock<SampleType> block(buffer);
+            oversampling.processSamplesUp(block);
+            oversampling.processSamplesDown(block);
+        });
+    }
+
+    template <typename SampleType>
+    double benchmarkFilterChain(int blockSize, double seconds)
+    {
+        FilterChain<SampleType> filterChain;
+        filterChain.prepare(makeSpec(blockSize));
+        filterChain.setTone(SampleType(0.7));
+
+        return measure<SampleType>(blockSize, seconds, [&](juce::AudioBuffer<SampleType>& buffer)
+        {
+            juce::dsp::AudioBlock<SampleType> block(buffer);
+            filterChain.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+        });
+    }
+
+    template <typename SampleType>
+    double benchmarkCabinet(int blockSize, double seconds)
+    {
+        CabinetSimulator<SampleType> cabinet;
+        cabinet.prepare(makeSpec(blockSize));
+        cabinet.setCabinetModel(CabinetSimulator<SampleType>::CabinetModel::Stack_4x12_Vintage);
+
+        return measure<SampleType>(blockSize, seconds, [&](juce::AudioBuffer<SampleType>& buffer)
+        {
+            juce::dsp::AudioBlock<SampleType> block(buffer);
+            cabinet.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+        });
+    }
+
+    template <typename SampleType>
+    double benchmarkMidSide(int blockSize, double seconds)
+    {
+        MidSideProcessor<SampleType> midSide;
+        midSide.prepare(makeSpec(blockSize));
+
+        return measure<SampleType>(blockSize, seconds, [&](juce::AudioBuffer<SampleType>& buffer)
+        {
+            midSide.processStereoToMidSide(buffer);
+            midSide.processMidSideToStereo(buffer);
+        });
+    }
+
+    template <typename Benchmark>
+    void runComparison(const char* name, int blockSize, double seconds, Benchmark&& benchmark)
+    {
+        const auto floatSpeed = benchmark(float(), blockSize, seconds);
+        const auto doubleSpeed = benchmark(double(), blockSize, seconds);
+
+        std::cout << juce::String(name).paddedRight(' ', 16)
+                  << juce::String(floatSpeed, 1).paddedLeft(' ', 12) << "x"
+                  << juce::String(doubleSpeed, 1).paddedLeft(' ', 12) << "x"
+                  << juce::String(doubleSpeed > 0.0 ? floatSpeed / doubleSpeed : 0.0, 2).paddedLeft(' ', 10)
+                  << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int blockSize = argc > 1 ? juce::jmax(1, juce::String(argv[1]).getIntValue()) : 512;
+    const double seconds = argc > 2 ? juce::jmax(1.0, juce::String(argv[2]).getDoubleValue()) : 60.0;
+
+    std::cout << "Realtime factor, " << seconds << " s of stereo audio at " << sampleRate
+              << " Hz, block size " << blockSize << std::endl << std::endl;
+
+    std::cout << juce::String("Stage").paddedRight(' ', 16)
+              << juce::String("float").paddedLeft(' ', 13)
+              << juce::String("double").paddedLeft(' ', 13)
+              << juce::String("ratio").paddedLeft(' ', 10) << std::endl;
+
+    runComparison("Saturation", blockSize, seconds, [](auto type, int b, double s) { return benchmarkSaturation<decltype(type)>(b, s); });
+    runComparison("Oversampling", blockSize, seconds, [](auto type, int b, double s) { return benchmarkOversampling<decltype(type)>(b, s); });
+    runComparison("Filter Chain", blockSize, seconds, [](auto type, int b, double s) { return benchmarkFilterChain<decltype(type)>(b, s); });
+    runComparison("Cabinet", blockSize, seconds, [](auto type, int b, double s) { return benchmarkCabinet<decltype(type)>(b, s); });
+    runComparison("Mid-Side", blockSize, seconds, [](auto type, int b, double s) { return benchmarkMidSide<decltype(type)>(b, s); });
+
+    return 0;
+}
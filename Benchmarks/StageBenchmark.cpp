@@ -0,0 +1,438 @@
+#include <JuceHeader.h>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "BenchmarkUtils.h"
+#include "DSP/SpiceEngine.h"
+
+// Measures every DSP stage and the full chain over a sweep of block sizes and sample rates
+// and writes the results as JSON, so runs on different commits can be diffed.
+//
+// Usage: spice_bench [--block-sizes 16,32,...] [--sample-rates 44100,48000,...]
+//                    [--seconds <audio per run>] [--precision float|double|both]
+//                    [--filter <text in stage name>] [--label <text>] [--output <file>]
+//                    [--isa sse2|neon|avx2|avx512|all]
+//
+// The kernels run in the widest instruction set the CPU supports unless --isa names one;
+// "all" repeats every run for each supported variant, so their results can be compared.
+
+namespace
+{
+    constexpr int numChannels = 2;
+
+    struct Settings
+    {
+        juce::Array<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+        double seconds = 1.0;
+        bool runFloat = true;
+        bool runDouble = false;
+        juce::String filter;
+        juce::String label;
+        juce::File outputFile;
+        juce::Array<CpuDispatch::InstructionSet> instructionSets { CpuDispatch::getActive() };
+    };
+
+    template <typename SampleType>
+    using BlockFunction = std::function<void(juce::AudioBuffer<SampleType>&)>;
+
+    /// Creates a stage prepared for the given spec, returning the function that processes one block
+    template <typename SampleType>
+    using StageFactory = std::function<BlockFunction<SampleType>(const juce::dsp::ProcessSpec&)>;
+
+    template <typename SampleType>
+    struct Stage
+    {
+        juce::String name;
+        StageFactory<SampleType> create;
+    };
+
+    /// Stage for any processor with prepare() and a replacing process(context)
+    template <typename SampleType, typename Processor, typename SetupFunction>
+    StageFactory<SampleType> makeContextStage(SetupFunction setup)
+    {
+        return [setup](const juce::dsp::ProcessSpec& spec) -> BlockFunction<SampleType>
+        {
+            auto processor = std::make_shared<Processor>();
+            processor->prepare(spec);
+            setup(*processor, spec);
+
+            return [processor](juce::AudioBuffer<SampleType>& buffer)
+            {
+                juce::dsp::AudioBlock<SampleType> block(buffer);
+                processor->process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+            };
+        };
+    }
+
+    /// Full chain through the engine the plugin runs
+    template <typename SampleType>
+    StageFactory<SampleType> makeEngineStage(SpiceParameters parameters)
+    {
+        return [parameters](const juce::dsp::ProcessSpec& spec) -> BlockFunction<SampleType>
+        {
+            auto engine = std::make_shared<SpiceEngine<SampleType>>();
+            engine->prepare(spec, juce::AudioChannelSet::stereo(), parameters);
+
+            return [engine, parameters](juce::AudioBuffer<SampleType>& buffer)
+            {
+                engine->processBlock(buffer, parameters);
+            };
+        };
+    }
+
+    template <typename SampleType>
+    std::vector<Stage<SampleType>> createStages()
+    {
+        using Saturation = SaturationProcessor<SampleType>;
+        using Cabinet = CabinetSimulator<SampleType>;
+        using Cut = CutFilter<SampleType>;
+
+        std::vector<Stage<SampleType>> stages;
+
+        const char* modelNames[] = { "Tube", "Transistor", "Transformer", "Tape", "Diode", "Vintage",
+                                     "Warm", "Bright", "FuzzBox", "Overdrive", "Tube12AX7" };
+
+        for (int model = 0; model < static_cast<int>(std::size(modelNames)); ++model)
+        {
+            stages.push_back({ juce::String("saturation/") + modelNames[model],
+                               makeContextStage<SampleType, Saturation>([model](Saturation& saturation, const juce::dsp::ProcessSpec&)
+                               {
+                                   saturation.setDrive(SampleType(60));
+                                   saturation.setModel(static_cast<typename Saturation::Model>(model));
+                               }) });
+        }
+
+        // The factors the quality setting passes to the oversampler
+        const std::pair<const char*, int> qualities[] = { { "Eco", 1 }, { "Pro", 2 }, { "Ultra", 4 } };
+
+        for (const auto& [qualityName, factor] : qualities)
+        {
+            stages.push_back({ juce::String("oversampling/") + qualityName,
+                               [factor = factor](const juce::dsp::ProcessSpec& spec) -> BlockFunction<SampleType>
+                               {
+                                   auto oversampling = std::make_shared<Oversampling<SampleType>>(numChannels, factor, Oversampling<SampleType>::filterHalfBandPolyphaseIIR);
+                                   oversampling->prepare(spec);
+
+                                   return [oversampling](juce::AudioBuffer<SampleType>& buffer)
+                                   {
+                                       juce::dsp::AudioBlock<SampleType> block(buffer);
+                                       oversampling->processSamplesUp(block);
+                                       oversampling->processSamplesDown(block);
+                                   };
+                               } });
+        }
+
+        stages.push_back({ "filterChain",
+                           makeContextStage<SampleType, FilterChain<SampleType>>([](FilterChain<SampleType>& filterChain, const juce::dsp::ProcessSpec&)
+                           {
+                               filterChain.setTone(SampleType(0.7));
+                           }) });
+
+        const char* cabinetNames[] = { "1x12 Vintage", "2x10 Tweed", "1x15 Bass", "2x12 Modern", "4x10 Clean",
+                                       "1x12 British", "4x12 Vintage", "4x12 Modern", "1x12 Jazz", "2x12 Vintage" };
+
+        for (int model = 0; model < static_cast<int>(std::size(cabinetNames)); ++model)
+        {
+            stages.push_back({ juce::String("cabinet/") + cabinetNames[model],
+                               makeContextStage<SampleType, Cabinet>([model](Cabinet& cabinet, const juce::dsp::ProcessSpec&)
+                               {
+                                   cabinet.setCabinetModel(static_cast<typename Cabinet::CabinetModel>(model));
+                                   cabinet.setPresence(0.3f);
+                                   cabinet.setResonance(0.5f);
+                               }) });
+        }
+
+        stages.push_back({ "multiband",
+                           makeContextStage<SampleType, MultibandSaturation<SampleType>>([](MultibandSaturation<SampleType>& multiband, const juce::dsp::ProcessSpec& spec)
+                           {
+                               multiband.setSampleRate(spec.sampleRate);
+                               multiband.setCrossoverFrequencies(200.0f, 3000.0f);
+                           }) });
+
+        stages.push_back({ "lowCut/24dB",
+                           [](const juce::dsp::ProcessSpec& spec) -> BlockFunction<SampleType>
+                           {
+                               auto filter = std::make_shared<Cut>(Cut::Type::highPass);
+                               filter->setCutoffFrequency(80.0f);
+                               filter->setSlope(Cut::Slope::db24);
+                               filter->prepare(spec);
+
+                               return [filter](juce::AudioBuffer<SampleType>& buffer)
+                               {
+                                   juce::dsp::AudioBlock<SampleType> block(buffer);
+                                   filter->process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+                               };
+                           } });
+
+        stages.push_back({ "midSide",
+                           [](const juce::dsp::ProcessSpec& spec) -> BlockFunction<SampleType>
+                           {
+                               auto midSide = std::make_shared<MidSideProcessor<SampleType>>();
+                               midSide->prepare(spec);
+                               midSide->setChannelPairs(MidSideProcessor<SampleType>::getChannelPairsForLayout(juce::AudioChannelSet::stereo()));
+                               midSide->setStereoWidth(SampleType(1.5));
+
+                               // Encode with gains and width, then decode, as the chain does
+                               return [midSide](juce::AudioBuffer<SampleType>& buffer)
+                               {
+                                   juce::dsp::AudioBlock<SampleType> block(buffer);
+                                   midSide->applyMatrix(block, midSide->getEncodeMatrix());
+                                   midSide->processMidSideToStereo(buffer);
+                               };
+                           } });
+
+        stages.push_back({ "gate",
+                           makeContextStage<SampleType, NoiseGate<SampleType>>([](NoiseGate<SampleType>& gate, const juce::dsp::ProcessSpec& spec)
+                           {
+                               gate.setThreshold(-40.0f);
+                               gate.setHysteresis(3.0f);
+                               gate.setHoldTime(50.0f);
+                               gate.setLookaheadSamples(juce::roundToInt(0.005 * spec.sampleRate));
+                           }) });
+
+        stages.push_back({ "limiter",
+                           makeContextStage<SampleType, TruePeakLimiter<SampleType>>([](TruePeakLimiter<SampleType>& limiter, const juce::dsp::ProcessSpec&)
+                           {
+                               limiter.setThreshold(SampleType(-6));
+                               limiter.setRelease(SampleType(10));
+                           }) });
+
+        stages.push_back({ "autoGain/RMS",
+                           [](const juce::dsp::ProcessSpec& spec) -> BlockFunction<SampleType>
+                           {
+                               auto rms = std::make_shared<std::array<RunningRMS, 2>>();
+
+                               for (auto& window : *rms)
+                                   window.prepare(static_cast<int>(spec.sampleRate * 0.3));
+
+                               // Sum of squares at the input and output, as the chain measures them
+                               return [rms](juce::AudioBuffer<SampleType>& buffer)
+                               {
+                                   for (auto& window : *rms)
+                                   {
+                                       double sum = 0.0;
+
+                                       for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                                           sum += CpuDispatch::sumOfSquares(buffer.getReadPointer(channel), buffer.getNumSamples());
+
+                                       window.pushBlock(sum / buffer.getNumChannels(), buffer.getNumSamples());
+                                   }
+                               };
+                           } });
+
+        stages.push_back({ "silence/peak",
+                           [](const juce::dsp::ProcessSpec&) -> BlockFunction<SampleType>
+                           {
+                               // Input and output checks, as the chain makes them every block
+                               return [](juce::AudioBuffer<SampleType>& buffer)
+                               {
+                                   for (int pass = 0; pass < 2; ++pass)
+                                       SilenceDetector::isSilent(buffer);
+                               };
+                           } });
+
+        stages.push_back({ "autoGain/Loudness",
+                           [](const juce::dsp::ProcessSpec& spec) -> BlockFunction<SampleType>
+                           {
+                               auto meters = std::make_shared<std::array<LoudnessMeter<SampleType>, 2>>();
+
+                               for (auto& meter : *meters)
+                               {
+                                   meter.prepare(spec);
+                                   meter.setChannelWeights(LoudnessMeter<SampleType>::getChannelWeightsForLayout(juce::AudioChannelSet::stereo()));
+                               }
+
+                               return [meters](juce::AudioBuffer<SampleType>& buffer)
+                               {
+                                   for (auto& meter : *meters)
+                                       meter.pushBlock(buffer);
+                               };
+                           } });
+
+        // Full chain at the plugin defaults, and with every optional stage switched on
+        stages.push_back({ "chain/default", makeEngineStage<SampleType>({}) });
+
+        SpiceParameters allStages;
+        allStages.lowCut = 80.0f;
+        allStages.highCut = 12000.0f;
+        allStages.gateEnabled = true;
+        allStages.gateLookahead = 5.0f;
+        allStages.autoGain = true;
+        allStages.midSideEnabled = true;
+        allStages.stereoWidth = 150.0f;
+        allStages.cabinetEnabled = true;
+        allStages.limiterEnabled = true;
+        stages.push_back({ "chain/allStages", makeEngineStage<SampleType>(allStages) });
+
+        auto multiband = allStages;
+        multiband.multibandEnabled = true;
+        stages.push_back({ "chain/multiband", makeEngineStage<SampleType>(multiband) });
+
+        return stages;
+    }
+
+    template <typename SampleType>
+    void runStages(const Settings& settings, const char* precision, juce::Array<juce::var>& results)
+    {
+        const auto* isa = CpuDispatch::getName(CpuDispatch::getActive());
+
+        for (const auto& stage : createStages<SampleType>())
+        {
+            if (settings.filter.isNotEmpty() && ! stage.name.containsIgnoreCase(settings.filter))
+                continue;
+
+            for (auto sampleRate : settings.sampleRates)
+            {
+                for (auto blockSize : settings.blockSizes)
+                {
+                    auto processBlock = stage.create(benchmark::makeSpec(sampleRate, blockSize, numChannels));
+                    const auto measurement = benchmark::measure<SampleType>(numChannels, blockSize, sampleRate, settings.seconds, processBlock);
+
+                    auto* result = new juce::DynamicObject();
+                    result->setProperty("stage", stage.name);
+                    result->setProperty("precision", precision);
+                    result->setProperty("isa", isa);
+                    result->setProperty("sampleRate", sampleRate);
+                    result->setProperty("blockSize", blockSize);
+                    result->setProperty("nsPerSample", measurement.getNanosecondsPerSample());
+                    result->setProperty("samplesPerSecond", measurement.getSamplesPerSecond());
+                    result->setProperty("realtimeFactor", measurement.getRealtimeFactor(sampleRate));
+                    results.add(juce::var(result));
+
+                    std::cerr << stage.name.paddedRight(' ', 24) << juce::String(precision).paddedRight(' ', 8)
+                              << juce::String(isa).paddedRight(' ', 8)
+                              << juce::String(sampleRate, 0).paddedLeft(' ', 7) << " Hz"
+                              << juce::String(blockSize).paddedLeft(' ', 6)
+                              << juce::String(measurement.getNanosecondsPerSample(), 2).paddedLeft(' ', 12) << " ns/sample"
+                              << std::endl;
+                }
+            }
+        }
+    }
+
+    template <typename ValueType>
+    juce::Array<ValueType> parseList(const juce::String& text)
+    {
+        juce::Array<ValueType> values;
+
+        for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+        {
+            const auto value = static_cast<ValueType>(token.trim().getDoubleValue());
+
+            if (value > 0)
+                values.add(value);
+        }
+
+        return values;
+    }
+
+    Settings parseArguments(const juce::ArgumentList& arguments)
+    {
+        Settings settings;
+
+        if (arguments.containsOption("--block-sizes"))
+            settings.blockSizes = parseList<int>(arguments.getValueForOption("--block-sizes"));
+
+        if (arguments.containsOption("--sample-rates"))
+            settings.sampleRates = parseList<double>(arguments.getValueForOption("--sample-rates"));
+
+        if (arguments.containsOption("--seconds"))
+            settings.seconds = juce::jmax(0.01, arguments.getValueForOption("--seconds").getDoubleValue());
+
+        const auto precision = arguments.getValueForOption("--precision");
+        settings.runFloat = precision != "double";
+        settings.runDouble = precision == "double" || precision == "both";
+
+        settings.filter = arguments.getValueForOption("--filter");
+        settings.label = arguments.getValueForOption("--label");
+
+        if (arguments.containsOption("--output"))
+            settings.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption("--output"));
+
+        const auto isa = arguments.getValueForOption("--isa");
+
+        if (isa == "all")
+        {
+            settings.instructionSets = CpuDispatch::getSupported();
+        }
+        else if (isa.isNotEmpty())
+        {
+            CpuDispatch::InstructionSet instructionSet;
+            settings.instructionSets.clear();
+
+            // Left empty for an unknown or unsupported name, which main() reports
+            if (CpuDispatch::parseName(isa, instructionSet) && CpuDispatch::isSupported(instructionSet))
+                settings.instructionSets.add(instructionSet);
+        }
+
+        return settings;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const auto settings = parseArguments(juce::ArgumentList(argc, argv));
+
+    if (settings.blockSizes.isEmpty() || settings.sampleRates.isEmpty())
+    {
+        std::cerr << "No block sizes or sample rates to run" << std::endl;
+        return 1;
+    }
+
+    if (settings.instructionSets.isEmpty())
+    {
+        std::cerr << "This CPU does not support the requested instruction set" << std::endl;
+        return 1;
+    }
+
+    juce::Array<juce::var> results;
+    juce::Array<juce::var> supported;
+
+    for (auto instructionSet : CpuDispatch::getSupported())
+        supported.add(CpuDispatch::getName(instructionSet));
+
+    const auto bestInstructionSet = CpuDispatch::getBestSupported();
+
+    for (auto instructionSet : settings.instructionSets)
+    {
+        CpuDispatch::setActive(instructionSet);
+
+        if (settings.runFloat)
+            runStages<float>(settings, "float", results);
+
+        if (settings.runDouble)
+            runStages<double>(settings, "double", results);
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("benchmark", "spice_bench");
+    report->setProperty("version", ProjectInfo::versionString);
+    report->setProperty("label", settings.label);
+    report->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("bestIsa", CpuDispatch::getName(bestInstructionSet));
+    report->setProperty("supportedIsas", supported);
+    report->setProperty("numChannels", numChannels);
+    report->setProperty("secondsPerRun", settings.seconds);
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (settings.outputFile != juce::File())
+    {
+        if (! settings.outputFile.replaceWithText(json))
+        {
+            std::cerr << "Could not write " << settings.outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
@@ -1,167 +1,196 @@
 #include "CabinetSimulator.h"
+#include "SilenceDetector.h"
 
-CabinetSimulator::CabinetSimulator()
+namespace
 {
-    // Define realistic combo cabinet models with detailed speaker and cabinet characteristics
-    
-    // Combo 1x12 Vintage - Classic Fender-style combo (Celestion Vintage 30 style)
-    cabinetResponses[0] = {
-        12.0f,          // speakerSize
-        5200.0f,        // speakerCutoff - Natural speaker rolloff
-        3100.0f,        // breakupFreq - Cone breakup adds character
-        0.8f,           // breakupQ
-        1.8f,           // cabinetSize - Medium cabinet volume
-        85.0f,          // portTuning - Bass reflex tuning
-        1.2f,           // resonanceQ
-        120.0f,         // closeProximity - Close mic bass boost frequency
-        280.0f,         // roomReflection - Room reflection low frequency
-        8500.0f         // airLoss - High frequency air absorption
-    };
-    
-    // Combo 2x10 Tweed - Vintage tweed combo warmth (Jensen P10R style)
-    cabinetResponses[1] = {
-        10.0f,          // speakerSize
-        4800.0f,        // speakerCutoff - Earlier rolloff for warmth
-        2800.0f,        // breakupFreq - Lower breakup for vintage character
-        0.6f,           // breakupQ
-        2.2f,           // cabinetSize - Larger tweed cabinet
-        75.0f,          // portTuning - Lower tuning for warmth
-        0.9f,           // resonanceQ
-        110.0f,         // closeProximity
-        250.0f,         // roomReflection
-        7800.0f         // airLoss
-    };
-    
-    // Combo 1x15 Bass - Bass combo cabinet (Eminence style)
-    cabinetResponses[2] = {
-        15.0f,          // speakerSize
-        3200.0f,        // speakerCutoff - Lower cutoff for bass response
-        1800.0f,        // breakupFreq - Much lower breakup
-        1.0f,           // breakupQ
-        4.5f,           // cabinetSize - Large cabinet for bass extension
-        45.0f,          // portTuning - Low bass reflex tuning
-        1.5f,           // resonanceQ
-        80.0f,          // closeProximity
-        160.0f,         // roomReflection
-        6000.0f         // airLoss
-    };
-    
-    // Combo 2x12 Modern - Modern high-gain combo (Celestion V30 + G12T-75)
-    cabinetResponses[3] = {
-        12.0f,          // speakerSize
-        6500.0f,        // speakerCutoff - Extended high frequency response
-        3800.0f,        // breakupFreq - Higher breakup for clarity
-        1.2f,           // breakupQ
-        3.2f,           // cabinetSize - Large 2x12 cabinet
-        95.0f,          // portTuning - Tight bass response
-        1.8f,           // resonanceQ
-        130.0f,         // closeProximity
-        320.0f,         // roomReflection
-        9200.0f         // airLoss
-    };
-    
-    // Combo 4x10 Clean - Clean Fender-style 4x10 (Jensen C10Q style)
-    cabinetResponses[4] = {
-        10.0f,          // speakerSize
-        5800.0f,        // speakerCutoff - Clean, clear high end
-        3500.0f,        // breakupFreq - Clean breakup character
-        0.4f,           // breakupQ - Gentle breakup
-        4.8f,           // cabinetSize - Large 4x10 cabinet
-        90.0f,          // portTuning - Balanced bass response
-        0.8f,           // resonanceQ
-        125.0f,         // closeProximity
-        300.0f,         // roomReflection
-        8800.0f         // airLoss
-    };
-    
-    // Combo 1x12 British - British-voiced combo (Celestion Blue style)
-    cabinetResponses[5] = {
-        12.0f,          // speakerSize
-        4600.0f,        // speakerCutoff - Classic British rolloff
-        2400.0f,        // breakupFreq - Early musical breakup
-        0.7f,           // breakupQ
-        1.5f,           // cabinetSize - Compact British cab
-        70.0f,          // portTuning - Tight, punchy bass
-        1.4f,           // resonanceQ
-        105.0f,         // closeProximity
-        230.0f,         // roomReflection
-        7200.0f         // airLoss
-    };
-    
-    // Stack 4x12 Vintage - Classic Marshall stack (Celestion G12M style)
-    cabinetResponses[6] = {
-        12.0f,          // speakerSize
-        5800.0f,        // speakerCutoff - Marshall stack presence
-        2800.0f,        // breakupFreq - Classic rock breakup
-        0.9f,           // breakupQ
-        8.0f,           // cabinetSize - Large 4x12 cabinet
-        85.0f,          // portTuning - Punchy bass response
-        2.0f,           // resonanceQ - Strong cabinet resonance
-        140.0f,         // closeProximity
-        350.0f,         // roomReflection
-        9000.0f         // airLoss
-    };
-    
-    // Stack 4x12 Modern - Modern high-gain stack (Mesa/Orange style)
-    cabinetResponses[7] = {
-        12.0f,          // speakerSize
-        6800.0f,        // speakerCutoff - Extended high frequency
-        3600.0f,        // breakupFreq - Tight modern breakup
-        1.3f,           // breakupQ
-        8.5f,           // cabinetSize - Oversized modern cab
-        95.0f,          // portTuning - Tight, focused bass
-        2.2f,           // resonanceQ
-        150.0f,         // closeProximity
-        380.0f,         // roomReflection
-        10500.0f        // airLoss
-    };
-    
-    // Combo 1x12 Jazz - Jazz combo with smooth response (JBL style)
-    cabinetResponses[8] = {
-        12.0f,          // speakerSize
-        7500.0f,        // speakerCutoff - Smooth extended highs
-        4200.0f,        // breakupFreq - Clean, minimal breakup
-        0.3f,           // breakupQ - Very gentle breakup
-        2.0f,           // cabinetSize - Medium jazz combo
-        80.0f,          // portTuning - Balanced bass response
-        0.7f,           // resonanceQ - Controlled resonance
-        115.0f,         // closeProximity
-        270.0f,         // roomReflection
-        8200.0f         // airLoss
+    // Cabinet-specific parameters for realistic modeling
+    struct CabinetResponse
+    {
+        // Speaker characteristics
+        float speakerSize;        // 10", 12", 15" etc
+        float speakerCutoff;      // Natural rolloff frequency
+        float breakupFreq;        // Speaker cone breakup frequency
+        float breakupQ;           // Breakup resonance sharpness
+        
+        // Cabinet characteristics  
+        float cabinetSize;        // Internal volume effect
+        float portTuning;         // Bass reflex port frequency
+        float resonanceQ;         // Cabinet resonance sharpness
+        
+        // Mic modeling
+        float closeProximity;     // Close mic bass boost
+        float roomReflection;     // Room reflection frequency
+        float airLoss;            // High frequency air absorption
     };
     
-    // Combo 2x12 Vintage - Vintage 2x12 combo warmth (Fender Twin style)
-    cabinetResponses[9] = {
-        12.0f,          // speakerSize
-        5400.0f,        // speakerCutoff - Vintage warmth
-        2900.0f,        // breakupFreq - Musical vintage breakup
-        0.6f,           // breakupQ
-        3.8f,           // cabinetSize - Large vintage 2x12
-        78.0f,          // portTuning - Warm bass tuning
-        1.1f,           // resonanceQ
-        125.0f,         // closeProximity
-        290.0f,         // roomReflection
-        7600.0f         // airLoss
+    // Realistic combo cabinet models with detailed speaker and cabinet characteristics
+    constexpr CabinetResponse cabinetResponses[] =
+    {
+        // Combo 1x12 Vintage - Classic Fender-style combo (Celestion Vintage 30 style)
+        {
+            12.0f,          // speakerSize
+            5200.0f,        // speakerCutoff - Natural speaker rolloff
+            3100.0f,        // breakupFreq - Cone breakup adds character
+            0.8f,           // breakupQ
+            1.8f,           // cabinetSize - Medium cabinet volume
+            85.0f,          // portTuning - Bass reflex tuning
+            1.2f,           // resonanceQ
+            120.0f,         // closeProximity - Close mic bass boost frequency
+            280.0f,         // roomReflection - Room reflection low frequency
+            8500.0f         // airLoss - High frequency air absorption
+        },
+        
+        // Combo 2x10 Tweed - Vintage tweed combo warmth (Jensen P10R style)
+        {
+            10.0f,          // speakerSize
+            4800.0f,        // speakerCutoff - Earlier rolloff for warmth
+            2800.0f,        // breakupFreq - Lower breakup for vintage character
+            0.6f,           // breakupQ
+            2.2f,           // cabinetSize - Larger tweed cabinet
+            75.0f,          // portTuning - Lower tuning for warmth
+            0.9f,           // resonanceQ
+            110.0f,         // closeProximity
+            250.0f,         // roomReflection
+            7800.0f         // airLoss
+        },
+        
+        // Combo 1x15 Bass - Bass combo cabinet (Eminence style)
+        {
+            15.0f,          // speakerSize
+            3200.0f,        // speakerCutoff - Lower cutoff for bass response
+            1800.0f,        // breakupFreq - Much lower breakup
+            1.0f,           // breakupQ
+            4.5f,           // cabinetSize - Large cabinet for bass extension
+            45.0f,          // portTuning - Low bass reflex tuning
+            1.5f,           // resonanceQ
+            80.0f,          // closeProximity
+            160.0f,         // roomReflection
+            6000.0f         // airLoss
+        },
+        
+        // Combo 2x12 Modern - Modern high-gain combo (Celestion V30 + G12T-75)
+        {
+            12.0f,          // speakerSize
+            6500.0f,        // speakerCutoff - Extended high frequency response
+            3800.0f,        // breakupFreq - Higher breakup for clarity
+            1.2f,           // breakupQ
+            3.2f,           // cabinetSize - Large 2x12 cabinet
+            95.0f,          // portTuning - Tight bass response
+            1.8f,           // resonanceQ
+            130.0f,         // closeProximity
+            320.0f,         // roomReflection
+            9200.0f         // airLoss
+        },
+        
+        // Combo 4x10 Clean - Clean Fender-style 4x10 (Jensen C10Q style)
+        {
+            10.0f,          // speakerSize
+            5800.0f,        // speakerCutoff - Clean, clear high end
+            3500.0f,        // breakupFreq - Clean breakup character
+            0.4f,           // breakupQ - Gentle breakup
+            4.8f,           // cabinetSize - Large 4x10 cabinet
+            90.0f,          // portTuning - Balanced bass response
+            0.8f,           // resonanceQ
+            125.0f,         // closeProximity
+            300.0f,         // roomReflection
+            8800.0f         // airLoss
+        },
+        
+        // Combo 1x12 British - British-voiced combo (Celestion Blue style)
+        {
+            12.0f,          // speakerSize
+            4600.0f,        // speakerCutoff - Classic British rolloff
+            2400.0f,        // breakupFreq - Early musical breakup
+            0.7f,           // breakupQ
+            1.5f,           // cabinetSize - Compact British cab
+            70.0f,          // portTuning - Tight, punchy bass
+            1.4f,           // resonanceQ
+            105.0f,         // closeProximity
+            230.0f,         // roomReflection
+            7200.0f         // airLoss
+        },
+        
+        // Stack 4x12 Vintage - Classic Marshall stack (Celestion G12M style)
+        {
+            12.0f,          // speakerSize
+            5800.0f,        // speakerCutoff - Marshall stack presence
+            2800.0f,        // breakupFreq - Classic rock breakup
+            0.9f,           // breakupQ
+            8.0f,           // cabinetSize - Large 4x12 cabinet
+            85.0f,          // portTuning - Punchy bass response
+            2.0f,           // resonanceQ - Strong cabinet resonance
+            140.0f,         // closeProximity
+            350.0f,         // roomReflection
+            9000.0f         // airLoss
+        },
+        
+        // Stack 4x12 Modern - Modern high-gain stack (Mesa/Orange style)
+        {
+            12.0f,          // speakerSize
+            6800.0f,        // speakerCutoff - Extended high frequency
+            3600.0f,        // breakupFreq - Tight modern breakup
+            1.3f,           // breakupQ
+            8.5f,           // cabinetSize - Oversized modern cab
+            95.0f,          // portTuning - Tight, focused bass
+            2.2f,           // resonanceQ
+            150.0f,         // closeProximity
+            380.0f,         // roomReflection
+            10500.0f        // airLoss
+        },
+        
+        // Combo 1x12 Jazz - Jazz combo with smooth response (JBL style)
+        {
+            12.0f,          // speakerSize
+            7500.0f,        // speakerCutoff - Smooth extended highs
+            4200.0f,        // breakupFreq - Clean, minimal breakup
+            0.3f,           // breakupQ - Very gentle breakup
+            2.0f,           // cabinetSize - Medium jazz combo
+            80.0f,          // portTuning - Balanced bass response
+            0.7f,           // resonanceQ - Controlled resonance
+            115.0f,         // closeProximity
+            270.0f,         // roomReflection
+            8200.0f         // airLoss
+        },
+        
+        // Combo 2x12 Vintage - Vintage 2x12 combo warmth (Fender Twin style)
+        {
+            12.0f,          // speakerSize
+            5400.0f,        // speakerCutoff - Vintage warmth
+            2900.0f,        // breakupFreq - Musical vintage breakup
+            0.6f,           // breakupQ
+            3.8f,           // cabinetSize - Large vintage 2x12
+            78.0f,          // portTuning - Warm bass tuning
+            1.1f,           // resonanceQ
+            125.0f,         // closeProximity
+            290.0f,         // roomReflection
+            7600.0f         // airLoss
+        }
     };
-    
+}
+
+template <typename SampleType>
+CabinetSimulator<SampleType>::CabinetSimulator()
+{
     // Setup speaker saturation curve for realistic cone behavior
-    speakerSaturation.functionToUse = [](float x) {
+    speakerSaturation.functionToUse = [](SampleType x) -> SampleType {
         // Soft saturation that mimics speaker cone compression
-        float absX = std::abs(x);
+        SampleType absX = std::abs(x);
         if (absX < 0.3f)
             return x;
         else if (absX < 0.7f)
             return x * (1.0f - 0.1f * (absX - 0.3f));
         else
-            return juce::jlimit(-0.85f, 0.85f, x * 0.9f + std::tanh(x * 0.3f) * 0.1f);
+            return juce::jlimit(SampleType(-0.85f), SampleType(0.85f), x * 0.9f + std::tanh(x * 0.3f) * 0.1f);
     };
 }
 
-CabinetSimulator::~CabinetSimulator()
+template <typename SampleType>
+CabinetSimulator<SampleType>::~CabinetSimulator()
 {
 }
 
-void CabinetSimulator::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void CabinetSimulator<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
 {
     currentSampleRate = spec.sampleRate;
     
@@ -176,10 +205,23 @@ void CabinetSimulator::prepare(const juce::dsp::ProcessSpec& spec)
     // Prepare speaker saturation
     speakerSaturation.prepare(spec);
     
-    updateFilters(spec.sampleRate);
+    // Built by the first instance at this sample rate, shared by the rest
+    designTable = designCache->getOrCreate<DesignTable>({ "cabinet", spec.sampleRate },
+                                                        [&spec] { return buildDesignTable(spec.sampleRate); });
+    
+    // Size every stage as a biquad once, later updates only overwrite the values
+    for (auto* stage : { &cabinetResonance, &speakerBreakup, &speakerLowPass,
+                         &micProximity, &roomAmbience, &airAbsorption })
+    {
+        *stage->state = juce::dsp::IIR::Coefficients<SampleType>(1, 0, 0, 1, 0, 0);
+    }
+    
+    applyStageGroup(resonanceStages, currentResonance);
+    applyStageGroup(presenceStages, currentPresence);
 }
 
-void CabinetSimulator::reset()
+template <typename SampleType>
+void CabinetSimulator<SampleType>::reset()
 {
     speakerLowPass.reset();
     cabinetResonance.reset();
@@ -190,7 +232,8 @@ void CabinetSimulator::reset()
     speakerSaturation.reset();
 }
 
-void CabinetSimulator::process(const juce::dsp::ProcessContextReplacing<float>& context)
+template <typename SampleType>
+void CabinetSimulator<SampleType>::process(const juce::dsp::ProcessContextReplacing<SampleType>& context)
 {
     // Apply realistic cabinet simulation in proper order
     
@@ -216,85 +259,171 @@ void CabinetSimulator::process(const juce::dsp::ProcessContextReplacing<float>&
     airAbsorption.process(context);
 }
 
-void CabinetSimulator::setCabinetModel(CabinetModel model)
+template <typename SampleType>
+double CabinetSimulator<SampleType>::getTailLengthSeconds() const
+{
+    // The stages run in series, so their decay times add up
+    double tail = 0.0;
+    
+    for (auto* stage : { &cabinetResonance, &speakerBreakup, &speakerLowPass,
+                         &micProximity, &roomAmbience, &airAbsorption })
+    {
+        tail += SilenceDetector::getDecayTimeSeconds(*stage->state, currentSampleRate);
+    }
+    
+    return tail;
+}
+
+template <typename SampleType>
+void CabinetSimulator<SampleType>::setCabinetModel(CabinetModel model)
 {
     if (currentModel != model)
     {
         currentModel = model;
-        setupCabinetResponse(model);
-        updateFilters(currentSampleRate);
+        applyStageGroup(resonanceStages, currentResonance);
+        applyStageGroup(presenceStages, currentPresence);
     }
 }
 
-void CabinetSimulator::setPresence(float presence)
+template <typename SampleType>
+void CabinetSimulator<SampleType>::setPresence(float presence)
 {
-    currentPresence = juce::jlimit(0.0f, 1.0f, presence);
-    updateMicDistance();
-    updateFilters(currentSampleRate);
+    presence = juce::jlimit(0.0f, 1.0f, presence);
+    
+    if (presence != currentPresence)
+    {
+        currentPresence = presence;
+        applyStageGroup(presenceStages, currentPresence);
+    }
 }
 
-void CabinetSimulator::setResonance(float resonance)
+template <typename SampleType>
+void CabinetSimulator<SampleType>::setResonance(float resonance)
 {
-    currentResonance = juce::jlimit(0.0f, 1.0f, resonance);
-    updateFilters(currentSampleRate);
+    resonance = juce::jlimit(0.0f, 1.0f, resonance);
+    
+    if (resonance != currentResonance)
+    {
+        currentResonance = resonance;
+        applyStageGroup(resonanceStages, currentResonance);
+    }
 }
 
-void CabinetSimulator::updateFilters(double sampleRate)
+template <typename SampleType>
+void CabinetSimulator<SampleType>::applyStageGroup(int group, float setting)
 {
-    if (sampleRate <= 0.0)
+    if (designTable == nullptr)
         return;
     
-    const auto& response = cabinetResponses[static_cast<int>(currentModel)];
-    
-    // 1. Cabinet resonance (bass reflex port and cabinet size) - MUCH more dramatic
-    auto resonanceGain = 1.0f + currentResonance * 8.0f; // 1-9 dB boost for audible effect
-    auto resonanceFreq = response.portTuning * (0.6f + currentResonance * 0.8f); // Wider frequency range
-    *cabinetResonance.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate, resonanceFreq, response.resonanceQ * (0.5f + currentResonance), 
-        juce::Decibels::decibelsToGain(resonanceGain));
+    // Interpolate between the two nearest table steps
+    const auto position = setting * static_cast<float>(tableSteps - 1);
+    const auto step = juce::jlimit(0, tableSteps - 2, static_cast<int>(position));
+    const auto fraction = static_cast<SampleType>(position - static_cast<float>(step));
     
-    // 2. Speaker cone breakup (adds musical distortion) - More pronounced
-    auto breakupGain = 0.5f + currentResonance * 4.0f; // More dramatic breakup
-    *speakerBreakup.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate, response.breakupFreq, response.breakupQ * (0.3f + currentResonance * 0.7f),
-        juce::Decibels::decibelsToGain(breakupGain));
+    const auto model = static_cast<int>(currentModel);
+    const auto* lower = designTable->get(model, group, step);
+    const auto* upper = designTable->get(model, group, step + 1);
     
-    // 3. Speaker natural rolloff - More dramatic cutoff control
-    auto cutoffFreq = response.speakerCutoff * (0.7f + currentResonance * 0.6f); // Variable cutoff
-    *speakerLowPass.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(
-        sampleRate, cutoffFreq, 0.8f + currentResonance * 0.4f); // Variable Q
+    Filter* stages[numStageGroups][stagesPerGroup] =
+    {
+        { &cabinetResonance, &speakerBreakup, &speakerLowPass },
+        { &micProximity, &roomAmbience, &airAbsorption }
+    };
     
-    updateMicDistance();
+    for (int stage = 0; stage < stagesPerGroup; ++stage)
+    {
+        auto* coefficients = stages[group][stage]->state->getRawCoefficients();
+        
+        for (int i = 0; i < coefficientsPerStage; ++i)
+        {
+            const auto index = stage * coefficientsPerStage + i;
+            coefficients[i] = lower[index] + (upper[index] - lower[index]) * fraction;
+        }
+    }
 }
 
-void CabinetSimulator::updateMicDistance()
+template <typename SampleType>
+std::shared_ptr<const typename CabinetSimulator<SampleType>::DesignTable> CabinetSimulator<SampleType>::buildDesignTable(double sampleRate)
 {
-    if (currentSampleRate <= 0.0)
-        return;
-        
-    const auto& response = cabinetResponses[static_cast<int>(currentModel)];
+    auto table = std::make_shared<DesignTable>();
+    table->coefficients.resize(static_cast<size_t>(numModels * numStageGroups * tableSteps * stagesPerGroup * coefficientsPerStage));
     
-    // Mic proximity effect (close mic = more bass, room mic = less bass) - MUCH more dramatic
-    float proximityGain = (1.0f - currentPresence) * 12.0f; // 0-12 dB bass boost when close - very audible
-    *micProximity.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-        currentSampleRate, response.closeProximity, 0.7f,
-        juce::Decibels::decibelsToGain(proximityGain));
+    std::array<typename juce::dsp::IIR::Coefficients<SampleType>::Ptr, stagesPerGroup> stages;
     
-    // Room reflection (more room = more low-mid resonance) - More pronounced
-    float roomGain = currentPresence * 6.0f; // 0-6 dB boost for room character - doubled
-    *roomAmbience.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        currentSampleRate, response.roomReflection, 0.6f + currentPresence * 0.4f, // Variable Q
-        juce::Decibels::decibelsToGain(roomGain));
+    for (int model = 0; model < numModels; ++model)
+    {
+        for (int group = 0; group < numStageGroups; ++group)
+        {
+            for (int step = 0; step < tableSteps; ++step)
+            {
+                designStages(model, group, static_cast<float>(step) / static_cast<float>(tableSteps - 1), sampleRate, stages);
+                
+                auto* destination = const_cast<SampleType*>(table->get(model, group, step));
+                
+                for (int stage = 0; stage < stagesPerGroup; ++stage)
+                {
+                    const auto* source = stages[static_cast<size_t>(stage)]->getRawCoefficients();
+                    std::copy(source, source + coefficientsPerStage, destination + stage * coefficientsPerStage);
+                }
+            }
+        }
+    }
     
-    // Air absorption (more distance = more high frequency loss) - Much more dramatic
-    float airLoss = -currentPresence * 15.0f; // 0 to -15 dB high cut - very audible effect
-    *airAbsorption.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-        currentSampleRate, response.airLoss * (0.8f + currentPresence * 0.4f), 0.7f, // Variable frequency
-        juce::Decibels::decibelsToGain(airLoss));
+    return table;
 }
 
-void CabinetSimulator::setupCabinetResponse(CabinetModel model)
+template <typename SampleType>
+void CabinetSimulator<SampleType>::designStages(int model, int group, float setting, double sampleRate,
+                                                std::array<typename juce::dsp::IIR::Coefficients<SampleType>::Ptr, stagesPerGroup>& stages)
 {
-    // Cabinet responses are set up in constructor, but this could be extended
-    // for loading custom impulse responses or additional cabinet modeling
-}
\ No newline at end of file
+    using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+    const auto& response = cabinetResponses[model];
+    
+    if (group == resonanceStages)
+    {
+        const auto resonance = setting;
+        
+        // 1. Cabinet resonance (bass reflex port and cabinet size) - MUCH more dramatic
+        auto resonanceGain = 1.0f + resonance * 8.0f; // 1-9 dB boost for audible effect
+        auto resonanceFreq = response.portTuning * (0.6f + resonance * 0.8f); // Wider frequency range
+        stages[0] = Coefficients::makePeakFilter(
+            sampleRate, resonanceFreq, response.resonanceQ * (0.5f + resonance), 
+            juce::Decibels::decibelsToGain(resonanceGain));
+        
+        // 2. Speaker cone breakup (adds musical distortion) - More pronounced
+        auto breakupGain = 0.5f + resonance * 4.0f; // More dramatic breakup
+        stages[1] = Coefficients::makePeakFilter(
+            sampleRate, response.breakupFreq, response.breakupQ * (0.3f + resonance * 0.7f),
+            juce::Decibels::decibelsToGain(breakupGain));
+        
+        // 3. Speaker natural rolloff - More dramatic cutoff control
+        auto cutoffFreq = response.speakerCutoff * (0.7f + resonance * 0.6f); // Variable cutoff
+        stages[2] = Coefficients::makeLowPass(
+            sampleRate, cutoffFreq, 0.8f + resonance * 0.4f); // Variable Q
+    }
+    else
+    {
+        const auto presence = setting;
+        
+        // Mic proximity effect (close mic = more bass, room mic = less bass) - MUCH more dramatic
+        float proximityGain = (1.0f - presence) * 12.0f; // 0-12 dB bass boost when close - very audible
+        stages[0] = Coefficients::makeLowShelf(
+            sampleRate, response.closeProximity, 0.7f,
+            juce::Decibels::decibelsToGain(proximityGain));
+        
+        // Room reflection (more room = more low-mid resonance) - More pronounced
+        float roomGain = presence * 6.0f; // 0-6 dB boost for room character - doubled
+        stages[1] = Coefficients::makePeakFilter(
+            sampleRate, response.roomReflection, 0.6f + presence * 0.4f, // Variable Q
+            juce::Decibels::decibelsToGain(roomGain));
+        
+        // Air absorption (more distance = more high frequency loss) - Much more dramatic
+        float airLoss = -presence * 15.0f; // 0 to -15 dB high cut - very audible effect
+        stages[2] = Coefficients::makeHighShelf(
+            sampleRate, response.airLoss * (0.8f + presence * 0.4f), 0.7f, // Variable frequency
+            juce::Decibels::decibelsToGain(airLoss));
+    }
+}
+
+template class CabinetSimulator<float>;
+template class CabinetSimulator<double>;
@@ -1,8 +1,18 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+#include "ChannelLaneFilter.h"
+#include "SharedDesignCache.h"
+#include <array>
+#include <vector>
 
 /// Advanced cabinet simulation with combo cab modeling and mic distance effects
+///
+/// The filter designs for every model across the resonance and presence ranges are
+/// precomputed once per sample rate into a table shared by all instances in the process
+/// (see SharedDesignCache). Changing a setting interpolates between table entries and
+/// writes the coefficients in place, so the audio thread never designs or allocates.
+template <typename SampleType>
 class CabinetSimulator
 {
 public:
@@ -30,7 +40,7 @@ public:
     void reset();
     
     /// Process audio block
-    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
     
     /// Set the cabinet model
     void setCabinetModel(CabinetModel model);
@@ -44,10 +54,41 @@ public:
     /// Get the current cabinet model
     CabinetModel getCurrentModel() const { return currentModel; }
     
+    /// Time for the cabinet filters to ring out below -120 dBFS
+    double getTailLengthSeconds() const;
+    
 private:
-    void updateFilters(double sampleRate);
-    void setupCabinetResponse(CabinetModel model);
-    void updateMicDistance();
+    /// The cabinet stages depend only on model and resonance, the mic stages only on
+    /// model and presence, so each group is tabulated over a single setting
+    enum StageGroup
+    {
+        resonanceStages = 0,
+        presenceStages,
+        numStageGroups
+    };
+    
+    static constexpr int stagesPerGroup = 3;
+    static constexpr int coefficientsPerStage = 5;
+    static constexpr int numModels = 10;
+    static constexpr int tableSteps = 129;
+    
+    /// Normalised biquad coefficients, indexed [model][group][step][stage][coefficient]
+    struct DesignTable
+    {
+        std::vector<SampleType> coefficients;
+        
+        const SampleType* get(int model, int group, int step) const
+        {
+            const auto index = ((model * numStageGroups + group) * tableSteps + step) * stagesPerGroup * coefficientsPerStage;
+            return coefficients.data() + index;
+        }
+    };
+    
+    static std::shared_ptr<const DesignTable> buildDesignTable(double sampleRate);
+    static void designStages(int model, int group, float setting, double sampleRate,
+                             std::array<typename juce::dsp::IIR::Coefficients<SampleType>::Ptr, stagesPerGroup>& stages);
+    
+    void applyStageGroup(int group, float setting);
     
     // Current settings
     CabinetModel currentModel = CabinetModel::Combo_1x12_Vintage;
@@ -56,43 +97,21 @@ private:
     double currentSampleRate = 44100.0;
     
     // Multi-stage filtering for realistic cabinet response
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> speakerLowPass;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> cabinetResonance;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> speakerBreakup;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> micProximity;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> roomAmbience;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> airAbsorption;
-    
-    // Cabinet-specific parameters for realistic modeling
-    struct CabinetResponse
-    {
-        // Speaker characteristics
-        float speakerSize;        // 10", 12", 15" etc
-        float speakerCutoff;      // Natural rolloff frequency
-        float breakupFreq;        // Speaker cone breakup frequency
-        float breakupQ;           // Breakup resonance sharpness
-        
-        // Cabinet characteristics  
-        float cabinetSize;        // Internal volume effect
-        float portTuning;         // Bass reflex port frequency
-        float resonanceQ;         // Cabinet resonance sharpness
-        
-        // Mic modeling
-        float closeProximity;     // Close mic bass boost
-        float roomReflection;     // Room reflection frequency
-        float airLoss;            // High frequency air absorption
-    };
+    using Filter = ChannelLaneFilter<SampleType>;
+    
+    Filter speakerLowPass;
+    Filter cabinetResonance;
+    Filter speakerBreakup;
+    Filter micProximity;
+    Filter roomAmbience;
+    Filter airAbsorption;
     
-    CabinetResponse cabinetResponses[10];
+    // Designs shared with every other instance at this sample rate
+    juce::SharedResourcePointer<SharedDesignCache> designCache;
+    std::shared_ptr<const DesignTable> designTable;
     
     // Nonlinear saturation for speaker modeling
-    juce::dsp::WaveShaper<float> speakerSaturation;
+    juce::dsp::WaveShaper<SampleType> speakerSaturation;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CabinetSimulator)
 };
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+#if JUCE_USE_SIMD
+
+/// Biquad that processes any number of channels with the channels packed into SIMD lanes.
+///
+/// Drop-in replacement for ProcessorDuplicator<IIR::Filter, IIR::Coefficients>: all channels
+/// share the coefficients in `state`, but instead of running one scalar filter per channel,
+/// groups of channels are interleaved into SIMDRegister lanes and filtered together, so an
+/// 8-channel bus costs two (AVX: one) filter passes instead of eight.
+template <typename SampleType>
+class ChannelLaneFilter
+{
+public:
+    using Lanes = juce::dsp::SIMDRegister<SampleType>;
+    using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+
+    static constexpr size_t numLanes = Lanes::SIMDNumElements;
+
+    /// Samples interleaved per pass, independent of the host block size so oversampled
+    /// blocks never outgrow the scratch buffer
+    static constexpr size_t chunkSize = 256;
+
+    ChannelLaneFilter() : state(new Coefficients()) {}
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        numChannels = static_cast<size_t>(spec.numChannels);
+        const auto numGroups = (numChannels + numLanes - 1) / numLanes;
+
+        filters.clear();
+
+        for (size_t group = 0; group < numGroups; ++group)
+            filters.emplace_back(state);
+
+        laneBlock = juce::dsp::AudioBlock<Lanes>(laneData, numGroups, chunkSize);
+        laneBlock.clear();
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& filter : filters)
+            filter.reset();
+    }
+
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context)
+    {
+        if (context.isBypassed)
+            return;
+
+        auto& block = context.getOutputBlock();
+        const auto blockChannels = juce::jmin(block.getNumChannels(), numChannels);
+        const auto numSamples = block.getNumSamples();
+
+        for (size_t start = 0; start < numSamples; start += chunkSize)
+        {
+            const auto count = juce::jmin(chunkSize, numSamples - start);
+
+            for (size_t group = 0; group < filters.size(); ++group)
+            {
+                auto* interleaved = reinterpret_cast<SampleType*>(laneBlock.getChannelPointer(group));
+
+                for (size_t lane = 0; lane < numLanes; ++lane)
+                {
+                    const auto channel = group * numLanes + lane;
+
+                    if (channel < blockChannels)
+                    {
+                        const auto* source = block.getChannelPointer(channel) + start;
+
+                        for (size_t i = 0; i < count; ++i)
+                            interleaved[i * numLanes + lane] = source[i];
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < count; ++i)
+                            interleaved[i * numLanes + lane] = SampleType(0);
+                    }
+                }
+
+                auto groupBlock = laneBlock.getSingleChannelBlock(group).getSubBlock(0, count);
+                filters[group].process(juce::dsp::ProcessContextReplacing<Lanes>(groupBlock));
+
+                for (size_t lane = 0; lane < numLanes; ++lane)
+                {
+                    const auto channel = group * numLanes + lane;
+
+                    if (channel >= blockChannels)
+                        break;
+
+                    auto* destination = block.getChannelPointer(channel) + start;
+
+                    for (size_t i = 0; i < count; ++i)
+                        destination[i] = interleaved[i * numLanes + lane];
+                }
+            }
+        }
+    }
+
+    /// Shared by every lane group, assign through *state to update all channels at once
+    typename Coefficients::Ptr state;
+
+private:
+    std::vector<juce::dsp::IIR::Filter<Lanes>> filters;
+    juce::HeapBlock<char> laneData;
+    juce::dsp::AudioBlock<Lanes> laneBlock;
+    size_t numChannels = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelLaneFilter)
+};
+
+#else
+
+/// Without SIMD support every channel runs its own scalar filter
+template <typename SampleType>
+using ChannelLaneFilter = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<SampleType>,
+                                                         juce::dsp::IIR::Coefficients<SampleType>>;
+
+#endif
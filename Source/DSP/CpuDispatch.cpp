@@ -0,0 +1,235 @@
+#include "CpuDispatch.h"
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+
+#if SPICE_X86_KERNEL_VARIANTS
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
+
+namespace
+{
+    using InstructionSet = CpuDispatch::InstructionSet;
+
+    constexpr int notSelected = -1;
+
+    std::atomic<int> activeInstructionSet { notSelected };
+    std::atomic<int> bestInstructionSet { notSelected };
+
+   #if SPICE_X86_KERNEL_VARIANTS
+    void readCpuid(juce::uint32 leaf, juce::uint32 subleaf, juce::uint32 (&registers)[4]) noexcept
+    {
+       #if JUCE_MSVC
+        int info[4];
+        __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+
+        for (int i = 0; i < 4; ++i)
+            registers[i] = static_cast<juce::uint32>(info[i]);
+       #else
+        __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+       #endif
+    }
+
+    /// XCR0: the register state the OS saves on a context switch
+    juce::uint64 readEnabledStateMask() noexcept
+    {
+       #if JUCE_MSVC
+        return static_cast<juce::uint64>(_xgetbv(0));
+       #else
+        juce::uint32 low, high;
+        __asm__ volatile ("xgetbv" : "=a" (low), "=d" (high) : "c" (0));
+        return (static_cast<juce::uint64>(high) << 32) | low;
+       #endif
+    }
+
+    bool hasBit(juce::uint32 value, int bit) noexcept    { return (value & (1u << bit)) != 0; }
+
+    // juce::SystemStats reports what the CPU implements but not whether the OS saves the
+    // wider registers, which hypervisors and some kernels leave disabled
+    InstructionSet detectBestSupported() noexcept
+    {
+        juce::uint32 registers[4] = {};
+        readCpuid(0, 0, registers);
+
+        if (registers[0] < 7)
+            return InstructionSet::baseline;
+
+        readCpuid(1, 0, registers);
+        const auto leaf1ecx = registers[2];
+
+        // OSXSAVE must be set before xgetbv may be executed
+        if (! hasBit(leaf1ecx, 27) || ! hasBit(leaf1ecx, 28))
+            return InstructionSet::baseline;
+
+        const auto stateMask = readEnabledStateMask();
+        const bool osSavesYmm = (stateMask & 0x6) == 0x6;
+        const bool osSavesZmm = (stateMask & 0xe6) == 0xe6;
+
+        readCpuid(7, 0, registers);
+        const auto leaf7ebx = registers[1];
+
+        const bool avx2 = osSavesYmm && hasBit(leaf7ebx, 5) && hasBit(leaf1ecx, 12);
+        const bool avx512 = avx2 && osSavesZmm
+                         && hasBit(leaf7ebx, 16)    // F
+                         && hasBit(leaf7ebx, 17)    // DQ
+                         && hasBit(leaf7ebx, 30)    // BW
+                         && hasBit(leaf7ebx, 31);   // VL
+
+        if (avx512)
+            return InstructionSet::avx512;
+
+        return avx2 ? InstructionSet::avx2 : InstructionSet::baseline;
+    }
+   #else
+    InstructionSet detectBestSupported() noexcept
+    {
+        return InstructionSet::baseline;
+    }
+   #endif
+
+    const KernelTable& getTable(InstructionSet instructionSet) noexcept
+    {
+       #if SPICE_X86_KERNEL_VARIANTS
+        switch (instructionSet)
+        {
+            case InstructionSet::avx2:      return getAvx2Kernels();
+            case InstructionSet::avx512:    return getAvx512Kernels();
+            case InstructionSet::baseline:  break;
+        }
+       #else
+        juce::ignoreUnused(instructionSet);
+       #endif
+
+        return getBaselineKernels();
+    }
+
+    bool equalsIgnoreCase(const char* a, const char* b) noexcept
+    {
+        for (; *a != 0 && *b != 0; ++a, ++b)
+            if (std::tolower(static_cast<unsigned char>(*a)) != std::tolower(static_cast<unsigned char>(*b)))
+                return false;
+
+        return *a == *b;
+    }
+
+    bool findByName(const char* name, InstructionSet& result) noexcept
+    {
+        for (auto instructionSet : { InstructionSet::baseline, InstructionSet::avx2, InstructionSet::avx512 })
+        {
+            if (equalsIgnoreCase(name, CpuDispatch::getName(instructionSet)))
+            {
+                result = instructionSet;
+                return true;
+            }
+        }
+
+        if (equalsIgnoreCase(name, "baseline"))
+        {
+            result = InstructionSet::baseline;
+            return true;
+        }
+
+        return false;
+    }
+
+    /// The variant used until setActive() is called: SPICE_ISA if it names one the
+    /// machine can run, otherwise the widest. Allocates nothing, so it is safe on
+    /// whichever thread calls a kernel first.
+    int selectInitial() noexcept
+    {
+        auto instructionSet = CpuDispatch::getBestSupported();
+
+        if (const auto* forced = std::getenv("SPICE_ISA"))
+        {
+            InstructionSet requested;
+
+            if (findByName(forced, requested) && CpuDispatch::isSupported(requested))
+                instructionSet = requested;
+        }
+
+        auto expected = notSelected;
+        activeInstructionSet.compare_exchange_strong(expected, static_cast<int>(instructionSet));
+        return activeInstructionSet.load();
+    }
+}
+
+CpuDispatch::InstructionSet CpuDispatch::getBestSupported() noexcept
+{
+    auto best = bestInstructionSet.load(std::memory_order_relaxed);
+
+    // cpuid can trap to the hypervisor, so it is only asked once
+    if (best == notSelected)
+    {
+        best = static_cast<int>(detectBestSupported());
+        bestInstructionSet.store(best, std::memory_order_relaxed);
+    }
+
+    return static_cast<InstructionSet>(best);
+}
+
+bool CpuDispatch::isSupported(InstructionSet instructionSet) noexcept
+{
+    return static_cast<int>(instructionSet) <= static_cast<int>(getBestSupported());
+}
+
+juce::Array<CpuDispatch::InstructionSet> CpuDispatch::getSupported()
+{
+    juce::Array<InstructionSet> result;
+
+    for (auto instructionSet : { InstructionSet::baseline, InstructionSet::avx2, InstructionSet::avx512 })
+        if (isSupported(instructionSet))
+            result.add(instructionSet);
+
+    return result;
+}
+
+CpuDispatch::InstructionSet CpuDispatch::getActive() noexcept
+{
+    auto active = activeInstructionSet.load(std::memory_order_acquire);
+
+    if (active == notSelected)
+        active = selectInitial();
+
+    return static_cast<InstructionSet>(active);
+}
+
+bool CpuDispatch::setActive(InstructionSet instructionSet) noexcept
+{
+    if (! isSupported(instructionSet))
+        return false;
+
+    activeInstructionSet.store(static_cast<int>(instructionSet), std::memory_order_release);
+    return true;
+}
+
+const char* CpuDispatch::getName(InstructionSet instructionSet) noexcept
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::avx2:      return "avx2";
+        case InstructionSet::avx512:    return "avx512";
+        case InstructionSet::baseline:  break;
+    }
+
+   #if JUCE_INTEL && JUCE_64BIT
+    return "sse2";
+   #elif JUCE_ARM && JUCE_64BIT
+    return "neon";
+   #else
+    return "baseline";
+   #endif
+}
+
+bool CpuDispatch::parseName(const juce::String& name, InstructionSet& result)
+{
+    return findByName(name.trim().toRawUTF8(), result);
+}
+
+const KernelTable& CpuDispatch::getKernels() noexcept
+{
+    return getTable(getActive());
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "KernelTable.h"
+
+/// Picks the widest instruction set the machine supports for the hot kernels (saturation
+/// curves, meter sums and peaks) and routes calls to that build of them.
+///
+/// The kernels are compiled once per variant from KernelImplementations.h. The choice is
+/// made on first use from the CPU and OS feature flags, unless the SPICE_ISA environment
+/// variable names a variant (baseline, avx2 or avx512). Tests and benchmarks can switch
+/// variants at any time with setActive(); the tables are immutable, so a block already in
+/// flight simply finishes on the old one.
+class CpuDispatch
+{
+public:
+    enum class InstructionSet
+    {
+        baseline = 0,   // The target's default flags: SSE2 on x86-64, NEON on arm64
+        avx2,           // AVX2 + FMA
+        avx512          // AVX-512 F/DQ/BW/VL
+    };
+
+    /// Widest variant this CPU and OS can run
+    static InstructionSet getBestSupported() noexcept;
+    static bool isSupported(InstructionSet instructionSet) noexcept;
+
+    /// Every variant the machine can run, narrowest first
+    static juce::Array<InstructionSet> getSupported();
+
+    static InstructionSet getActive() noexcept;
+
+    /// Route the kernels to another variant. Returns false, and keeps the current one, if
+    /// the machine cannot run it.
+    static bool setActive(InstructionSet instructionSet) noexcept;
+
+    /// Short lower-case name ("sse2", "neon", "avx2", "avx512"), as reported by the benchmarks
+    static const char* getName(InstructionSet instructionSet) noexcept;
+
+    /// Reads a name as getName() writes it; "baseline" is accepted as well
+    static bool parseName(const juce::String& name, InstructionSet& result);
+
+    static const KernelTable& getKernels() noexcept;
+
+    //==============================================================================
+    static double sumOfSquares(const float* data, int numSamples) noexcept   { return getKernels().sumOfSquaresFloat(data, numSamples); }
+    static double sumOfSquares(const double* data, int numSamples) noexcept  { return getKernels().sumOfSquaresDouble(data, numSamples); }
+
+    static float peak(const float* data, int numSamples) noexcept            { return getKernels().peakFloat(data, numSamples); }
+    static double peak(const double* data, int numSamples) noexcept          { return getKernels().peakDouble(data, numSamples); }
+
+    static void saturate(float* data, int numSamples, const SaturationSettings<float>& settings, SaturationState<float>& state) noexcept
+    {
+        getKernels().saturateFloat(data, numSamples, settings, state);
+    }
+
+    static void saturate(double* data, int numSamples, const SaturationSettings<double>& settings, SaturationState<double>& state) noexcept
+    {
+        getKernels().saturateDouble(data, numSamples, settings, state);
+    }
+
+private:
+    CpuDispatch() = delete;
+};
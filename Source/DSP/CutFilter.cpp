@@ -0,0 +1,171 @@
+#include "CutFilter.h"
+#include "SilenceDetector.h"
+
+namespace
+{
+    // Butterworth section Q values for 2nd, 4th and 8th order responses
+    constexpr double butterworthQ[3][4] =
+    {
+        { 0.7071067812, 0.0,          0.0,          0.0 },
+        { 0.5411961001, 1.3065629649, 0.0,          0.0 },
+        { 0.5097955791, 0.6013448869, 0.8999762231, 2.5629154478 }
+    };
+}
+
+template <typename SampleType>
+CutFilter<SampleType>::CutFilter(Type filterType)
+    : type(filterType)
+{
+    setSlope(Slope::db12);
+}
+
+template <typename SampleType>
+void CutFilter<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    states.assign(spec.numChannels, {});
+
+    // Start at the target, there is nothing to glide from yet
+    targetGain = cutoffToWarpedGain(targetCutoff);
+    currentGain = targetGain;
+
+    reset();
+}
+
+template <typename SampleType>
+void CutFilter<SampleType>::reset()
+{
+    for (auto& channelState : states)
+        channelState.fill(SampleType(0));
+}
+
+template <typename SampleType>
+void CutFilter<SampleType>::setCutoffFrequency(float frequencyHz)
+{
+    if (frequencyHz != targetCutoff)
+    {
+        targetCutoff = frequencyHz;
+        targetGain = cutoffToWarpedGain(frequencyHz);
+    }
+}
+
+template <typename SampleType>
+void CutFilter<SampleType>::setSlope(Slope newSlope)
+{
+    if (newSlope == slope && damping[0] != SampleType(0))
+        return;
+
+    slope = newSlope;
+
+    const auto slopeIndex = static_cast<int>(slope);
+    const auto previousSections = numSections;
+    numSections = 1 << slopeIndex;
+
+    // Sections coming back into the cascade start from rest, not from whatever they held
+    // when a lower slope switched them off
+    for (auto& channelState : states)
+    {
+        for (int section = previousSections; section < numSections; ++section)
+        {
+            channelState[static_cast<size_t>(section * 2)] = SampleType(0);
+            channelState[static_cast<size_t>(section * 2 + 1)] = SampleType(0);
+        }
+    }
+
+    for (int section = 0; section < maxSections; ++section)
+    {
+        const auto q = butterworthQ[slopeIndex][section];
+        damping[static_cast<size_t>(section)] = q > 0.0 ? static_cast<SampleType>(1.0 / q) : SampleType(0);
+    }
+}
+
+template <typename SampleType>
+SampleType CutFilter<SampleType>::cutoffToWarpedGain(float frequencyHz) const
+{
+    // Keep below Nyquist so the prewarped gain stays positive at low sample rates
+    const auto frequency = juce::jlimit(1.0, sampleRate * 0.49, static_cast<double>(frequencyHz));
+    return static_cast<SampleType>(std::tan(juce::MathConstants<double>::pi * frequency / sampleRate));
+}
+
+template <typename SampleType>
+void CutFilter<SampleType>::process(const juce::dsp::ProcessContextReplacing<SampleType>& context)
+{
+    if (context.isBypassed)
+        return;
+
+    auto& block = context.getOutputBlock();
+    const auto numChannels = juce::jmin(block.getNumChannels(), states.size());
+    const auto numSamples = block.getNumSamples();
+
+    if (numSamples == 0)
+        return;
+
+    const bool ramping = currentGain != targetGain;
+    const auto gainIncrement = (targetGain - currentGain) / static_cast<SampleType>(numSamples);
+    const bool highPass = type == Type::highPass;
+
+    // Per-section normalisation, only recomputed per sample while the cutoff glides
+    std::array<SampleType, maxSections> normalisation {};
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        const auto k = damping[static_cast<size_t>(section)];
+        normalisation[static_cast<size_t>(section)] = SampleType(1) / (SampleType(1) + k * targetGain + targetGain * targetGain);
+    }
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = block.getChannelPointer(channel);
+        auto& state = states[channel];
+        auto g = currentGain;
+
+        for (size_t sample = 0; sample < numSamples; ++sample)
+        {
+            if (ramping)
+                g += gainIncrement;
+
+            auto x = data[sample];
+
+            for (int section = 0; section < numSections; ++section)
+            {
+                const auto k = damping[static_cast<size_t>(section)];
+                const auto h = ramping ? SampleType(1) / (SampleType(1) + k * g + g * g)
+                                       : normalisation[static_cast<size_t>(section)];
+
+                auto& s1 = state[static_cast<size_t>(section * 2)];
+                auto& s2 = state[static_cast<size_t>(section * 2 + 1)];
+
+                const auto yHP = h * (x - s1 * (g + k) - s2);
+                const auto yBP = yHP * g + s1;
+                s1 = yHP * g + yBP;
+                const auto yLP = yBP * g + s2;
+                s2 = yBP * g + yLP;
+
+                x = highPass ? yHP : yLP;
+            }
+
+            data[sample] = x;
+        }
+    }
+
+    currentGain = targetGain;
+}
+
+template <typename SampleType>
+double CutFilter<SampleType>::getTailLengthSeconds() const
+{
+    // Each section's poles decay with time constant 2Q / wc
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jlimit(1.0, sampleRate * 0.49, static_cast<double>(targetCutoff));
+    double tail = 0.0;
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        const auto q = 1.0 / static_cast<double>(damping[static_cast<size_t>(section)]);
+        tail += SilenceDetector::getDecayTimeSeconds(2.0 * q / omega);
+    }
+
+    return tail;
+}
+
+template class CutFilter<float>;
+template class CutFilter<double>;
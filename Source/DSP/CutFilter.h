@@ -0,0 +1,72 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+
+/// Butterworth high- or low-pass with selectable 12/24/48 dB/oct slope.
+///
+/// Built from cascaded TPT state-variable sections, which stay stable while their cutoff
+/// moves, so the cutoff is interpolated per sample across each block instead of being
+/// redesigned every sample. Coefficients are computed in place and only when the cutoff
+/// or slope changes, so nothing is allocated after prepare().
+template <typename SampleType>
+class CutFilter
+{
+public:
+    enum class Type
+    {
+        highPass = 0,
+        lowPass
+    };
+
+    enum class Slope
+    {
+        db12 = 0,
+        db24,
+        db48
+    };
+
+    static constexpr int maxSections = 4;
+
+    explicit CutFilter(Type filterType);
+    ~CutFilter() = default;
+
+    /// Prepare the filter for playback
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    /// Reset the filter state
+    void reset();
+
+    /// Process audio block
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
+
+    /// Target cutoff, reached by the end of the next processed block
+    void setCutoffFrequency(float frequencyHz);
+
+    /// Number of cascaded second-order sections
+    void setSlope(Slope newSlope);
+
+    /// Time for the filter to ring out below -120 dBFS
+    double getTailLengthSeconds() const;
+
+private:
+    SampleType cutoffToWarpedGain(float frequencyHz) const;
+
+    Type type;
+    Slope slope = Slope::db12;
+    int numSections = 1;
+
+    // Damping (1 / Q) of each section for the current slope
+    std::array<SampleType, maxSections> damping {};
+
+    float targetCutoff = 1000.0f;
+    SampleType currentGain = 0;  // tan(pi * fc / fs), interpolated per sample
+    SampleType targetGain = 0;
+    double sampleRate = 44100.0;
+
+    // Two integrator states per section and channel
+    std::vector<std::array<SampleType, maxSections * 2>> states;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CutFilter)
+};
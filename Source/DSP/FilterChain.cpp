@@ -1,62 +1,80 @@
 #include "FilterChain.h"
+#include "SilenceDetector.h"
 
-FilterChain::FilterChain()
+template <typename SampleType>
+FilterChain<SampleType>::FilterChain()
 {
 }
 
-void FilterChain::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void FilterChain<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
 {
-    sampleRate = static_cast<float>(spec.sampleRate);
+    sampleRate = spec.sampleRate;
     
     filterChain.prepare(spec);
     
     updateFilters();
 }
 
-void FilterChain::reset()
+template <typename SampleType>
+void FilterChain<SampleType>::reset()
 {
     filterChain.reset();
 }
 
-void FilterChain::process(const juce::dsp::ProcessContextReplacing<float>& context)
+template <typename SampleType>
+void FilterChain<SampleType>::process(const juce::dsp::ProcessContextReplacing<SampleType>& context)
 {
     filterChain.process(context);
 }
 
-void FilterChain::setTone(float tone)
+template <typename SampleType>
+void FilterChain<SampleType>::setTone(SampleType tone)
 {
-    if (std::abs(currentTone - tone) > 0.0001f)
+    if (std::abs(currentTone - tone) > SampleType(0.0001))
     {
         currentTone = tone;
         updateFilters();
     }
 }
 
-void FilterChain::updateFilters()
+template <typename SampleType>
+double FilterChain<SampleType>::getTailLengthSeconds() const
 {
+    return SilenceDetector::getDecayTimeSeconds(*filterChain.template get<0>().state, sampleRate)
+         + SilenceDetector::getDecayTimeSeconds(*filterChain.template get<1>().state, sampleRate)
+         + SilenceDetector::getDecayTimeSeconds(*filterChain.template get<2>().state, sampleRate);
+}
+
+template <typename SampleType>
+void FilterChain<SampleType>::updateFilters()
+{
+    // Designed into plain arrays and copied into the existing coefficient objects,
+    // since this runs on the audio thread whenever the tone moves
+    using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<SampleType>;
+    
     // Low shelf: boost/cut lows based on tone
-    float lowGain = juce::jmap(currentTone, 0.0f, 1.0f, 3.0f, -3.0f);
-    auto lowShelfCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-        sampleRate, 200.0f, 0.7f, 
+    auto lowGain = juce::jmap(currentTone, SampleType(3.0), SampleType(-3.0));
+    *filterChain.template get<0>().state = ArrayCoefficients::makeLowShelf(
+        sampleRate, SampleType(200.0), SampleType(0.7),
         juce::Decibels::decibelsToGain(lowGain)
     );
     
     // High shelf: boost/cut highs based on tone  
-    float highGain = juce::jmap(currentTone, 0.0f, 1.0f, -3.0f, 3.0f);
-    auto highShelfCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-        sampleRate, 4000.0f, 0.7f,
+    auto highGain = juce::jmap(currentTone, SampleType(-3.0), SampleType(3.0));
+    *filterChain.template get<1>().state = ArrayCoefficients::makeHighShelf(
+        sampleRate, SampleType(4000.0), SampleType(0.7),
         juce::Decibels::decibelsToGain(highGain)
     );
     
     // Presence peak
-    float presenceFreq = juce::jmap(currentTone, 0.0f, 1.0f, 2000.0f, 6000.0f);
-    float presenceGain = juce::jmap(currentTone, 0.0f, 1.0f, -1.0f, 2.0f);
-    auto presenceCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate, presenceFreq, 0.5f, 
+    auto presenceFreq = juce::jmap(currentTone, SampleType(2000.0), SampleType(6000.0));
+    auto presenceGain = juce::jmap(currentTone, SampleType(-1.0), SampleType(2.0));
+    *filterChain.template get<2>().state = ArrayCoefficients::makePeakFilter(
+        sampleRate, presenceFreq, SampleType(0.5),
         juce::Decibels::decibelsToGain(presenceGain)
     );
-    
-    *filterChain.get<0>().state = *lowShelfCoeffs;
-    *filterChain.get<1>().state = *highShelfCoeffs;
-    *filterChain.get<2>().state = *presenceCoeffs;
-}
\ No newline at end of file
+}
+
+template class FilterChain<float>;
+template class FilterChain<double>;
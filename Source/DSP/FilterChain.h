@@ -1,7 +1,9 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+#include "ChannelLaneFilter.h"
 
+template <typename SampleType>
 class FilterChain
 {
 public:
@@ -10,19 +12,20 @@ public:
     
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset();
-    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
     
-    void setTone(float tone);
+    void setTone(SampleType tone);
+    
+    /// Time for the tone filters to ring out below -120 dBFS
+    double getTailLengthSeconds() const;
     
 private:
-    juce::dsp::ProcessorChain<
-        juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>,
-        juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>,
-        juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>
-    > filterChain;
+    using Filter = ChannelLaneFilter<SampleType>;
+    
+    juce::dsp::ProcessorChain<Filter, Filter, Filter> filterChain;
     
-    float currentTone = 0.5f;
-    float sampleRate = 44100.0f;
+    SampleType currentTone = 0.5;
+    double sampleRate = 44100.0;
     
     void updateFilters();
-};
\ No newline at end of file
+};
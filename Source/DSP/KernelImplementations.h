@@ -0,0 +1,440 @@
+#pragma once
+
+// Kernel bodies shared by every instruction set variant. Each Kernels*.cpp file defines
+// SPICE_KERNEL_VECTOR_BYTES to the width of its vector registers and includes this header
+// once; the compiler flags of that file decide which instructions the loops turn into.
+//
+// Everything here lives in an anonymous namespace and calls the C maths functions rather
+// than the <cmath> overloads, so no function compiled for a wide instruction set can be
+// shared with, and picked by, the other variants (see KernelTable.h).
+
+#include <math.h>
+#include "KernelTable.h"
+
+#ifndef SPICE_KERNEL_VECTOR_BYTES
+ #error "Define SPICE_KERNEL_VECTOR_BYTES before including KernelImplementations.h"
+#endif
+
+namespace
+{
+    /// Independent partial sums per call: two registers' worth, so consecutive adds do not
+    /// wait on each other and the loop vectorises to the file's register width
+    template <typename SampleType>
+    constexpr int numPartials = 2 * SPICE_KERNEL_VECTOR_BYTES / static_cast<int>(sizeof(SampleType));
+
+    template <typename SampleType>
+    constexpr SampleType pi = static_cast<SampleType>(3.141592653589793238L);
+
+    inline float tanhOf(float x) noexcept   { return ::tanhf(x); }
+    inline double tanhOf(double x) noexcept { return ::tanh(x); }
+    inline float atanhOf(float x) noexcept  { return ::atanhf(x); }
+    inline double atanhOf(double x) noexcept { return ::atanh(x); }
+    inline float sinOf(float x) noexcept    { return ::sinf(x); }
+    inline double sinOf(double x) noexcept  { return ::sin(x); }
+    inline float expOf(float x) noexcept    { return ::expf(x); }
+    inline double expOf(double x) noexcept  { return ::exp(x); }
+    inline float roundOf(float x) noexcept  { return ::roundf(x); }
+    inline double roundOf(double x) noexcept { return ::round(x); }
+    inline float absOf(float x) noexcept    { return ::fabsf(x); }
+    inline double absOf(double x) noexcept  { return ::fabs(x); }
+
+    /// Same comparisons as juce::jlimit, so the curves match their original results
+    template <typename SampleType>
+    inline SampleType limit(SampleType lowerLimit, SampleType upperLimit, SampleType value) noexcept
+    {
+        return value < lowerLimit ? lowerLimit : (upperLimit < value ? upperLimit : value);
+    }
+
+    //==============================================================================
+    /// The partials are kept in double for float input too, so how the sum is split only
+    /// shows at double rounding; against a serial float sum the result differs by no more
+    /// than that sum's own rounding error
+    template <typename SampleType>
+    double sumOfSquares(const SampleType* data, int numSamples) noexcept
+    {
+        constexpr int numLanes = numPartials<double>;
+        double partials[numLanes] = {};
+        int sample = 0;
+
+        for (; sample + numLanes <= numSamples; sample += numLanes)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const auto value = static_cast<double>(data[sample + lane]);
+                partials[lane] += value * value;
+            }
+        }
+
+        double sum = 0;
+
+        for (; sample < numSamples; ++sample)
+        {
+            const auto value = static_cast<double>(data[sample]);
+            sum += value * value;
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            sum += partials[lane];
+
+        return sum;
+    }
+
+    template <typename SampleType>
+    SampleType peak(const SampleType* data, int numSamples) noexcept
+    {
+        constexpr int numLanes = numPartials<SampleType>;
+        SampleType partials[numLanes] = {};
+        int sample = 0;
+
+        for (; sample + numLanes <= numSamples; sample += numLanes)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const auto magnitude = absOf(data[sample + lane]);
+                partials[lane] = magnitude > partials[lane] ? magnitude : partials[lane];
+            }
+        }
+
+        SampleType result = 0;
+
+        for (; sample < numSamples; ++sample)
+        {
+            const auto magnitude = absOf(data[sample]);
+            result = magnitude > result ? magnitude : result;
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            result = partials[lane] > result ? partials[lane] : result;
+
+        return result;
+    }
+
+    //==============================================================================
+    // Saturation curves, in the order of SaturationProcessor::Model
+
+    template <typename SampleType>
+    SampleType tubeCurve(SampleType input) noexcept
+    {
+        const SampleType threshold = 0.7f;
+        SampleType x = limit(SampleType(-3.0f), SampleType(3.0f), input);
+
+        if (absOf(x) < threshold)
+            return x;
+
+        SampleType sign = (x < 0.0f) ? -1.0f : 1.0f;
+        x = absOf(x);
+
+        SampleType y = threshold + (1.0f - threshold) * tanhOf((x - threshold) * 2.0f);
+
+        y += 0.05f * sinOf(2.0f * pi<SampleType> * x);
+        y += 0.02f * sinOf(3.0f * pi<SampleType> * x);
+
+        return sign * y;
+    }
+
+    template <typename SampleType>
+    SampleType transistorCurve(SampleType input) noexcept
+    {
+        SampleType x = limit(SampleType(-2.0f), SampleType(2.0f), input);
+
+        SampleType y = x;
+
+        if (absOf(x) > 0.5f)
+        {
+            SampleType sign = (x < 0.0f) ? -1.0f : 1.0f;
+            SampleType absX = absOf(x);
+
+            y = sign * (0.5f + 0.5f * tanhOf(2.0f * (absX - 0.5f)));
+
+            y *= 1.0f + 0.1f * (1.0f - absOf(y));
+        }
+
+        y += 0.03f * x * x * x;
+
+        return limit(SampleType(-1.0f), SampleType(1.0f), y);
+    }
+
+    template <typename SampleType>
+    SampleType transformerCurve(SampleType input, SaturationState<SampleType>& state) noexcept
+    {
+        SampleType x = limit(SampleType(-2.0f), SampleType(2.0f), input);
+
+        SampleType hyst = state.hysteresis;
+        SampleType delta = x - state.previous;
+
+        hyst += delta * 0.3f;
+        hyst *= 0.95f;
+
+        SampleType y = tanhOf(x * 1.5f + hyst * 0.2f);
+
+        y += 0.02f * sinOf(2.0f * pi<SampleType> * x);
+        y += 0.01f * sinOf(4.0f * pi<SampleType> * x);
+
+        state.previous = x;
+        state.hysteresis = hyst;
+
+        return y;
+    }
+
+    template <typename SampleType>
+    SampleType tapeCurve(SampleType input) noexcept
+    {
+        SampleType x = limit(SampleType(-1.5f), SampleType(1.5f), input);
+
+        SampleType y = x - 0.15f * x * x * x;
+
+        if (absOf(x) > 0.7f)
+        {
+            SampleType sign = (x < 0.0f) ? -1.0f : 1.0f;
+            y = sign * (0.7f + 0.3f * tanhOf(3.0f * (absOf(x) - 0.7f)));
+        }
+
+        SampleType compression = 1.0f - 0.2f * absOf(y);
+        y *= compression;
+
+        y += 0.01f * sinOf(1.5f * pi<SampleType> * x);
+
+        return y;
+    }
+
+    template <typename SampleType>
+    SampleType diodeCurve(SampleType input) noexcept
+    {
+        const SampleType threshold = 0.3f;
+        SampleType x = limit(SampleType(-2.0f), SampleType(2.0f), input);
+
+        if (x > threshold)
+        {
+            SampleType excess = x - threshold;
+            x = threshold + tanhOf(excess * 3.0f) * 0.5f;
+        }
+        else if (x < -threshold * 1.2f)
+        {
+            SampleType excess = x + threshold * 1.2f;
+            x = -threshold * 1.2f + tanhOf(excess * 2.0f) * 0.6f;
+        }
+
+        x += 0.02f * x * x;
+
+        return limit(SampleType(-1.0f), SampleType(1.0f), x);
+    }
+
+    template <typename SampleType>
+    SampleType vintageCurve(SampleType input) noexcept
+    {
+        SampleType x = limit(SampleType(-2.0f), SampleType(2.0f), input);
+
+        // Vintage console saturation with smooth compression
+        SampleType y = tanhOf(x * 1.2f);
+
+        // Add subtle harmonic content
+        y += 0.08f * sinOf(2.0f * pi<SampleType> * x);
+        y += 0.04f * sinOf(3.0f * pi<SampleType> * x);
+        y += 0.02f * sinOf(5.0f * pi<SampleType> * x);
+
+        // Gentle high-frequency roll-off
+        y *= 1.0f - 0.1f * absOf(x);
+
+        return y * 0.8f;
+    }
+
+    template <typename SampleType>
+    SampleType warmCurve(SampleType input) noexcept
+    {
+        SampleType x = limit(SampleType(-1.8f), SampleType(1.8f), input);
+
+        // Warm, musical saturation with even harmonics
+        SampleType y = x - 0.33f * x * x * x;
+
+        // Add warmth with even harmonics
+        y += 0.06f * x * x;
+        y += 0.03f * x * x * x * x;
+
+        // Smooth limiting
+        if (absOf(y) > 0.9f)
+        {
+            SampleType sign = (y < 0.0f) ? -1.0f : 1.0f;
+            y = sign * (0.9f + 0.1f * tanhOf(5.0f * (absOf(y) - 0.9f)));
+        }
+
+        return y;
+    }
+
+    template <typename SampleType>
+    SampleType brightCurve(SampleType input) noexcept
+    {
+        SampleType x = limit(SampleType(-2.2f), SampleType(2.2f), input);
+
+        // Bright, crisp saturation with high-frequency emphasis
+        SampleType y = atanhOf(limit(SampleType(-0.95f), SampleType(0.95f), x * 0.7f)) * 1.2f;
+
+        // Add brightness with odd harmonics
+        y += 0.1f * sinOf(3.0f * pi<SampleType> * x);
+        y += 0.05f * sinOf(5.0f * pi<SampleType> * x);
+        y += 0.025f * sinOf(7.0f * pi<SampleType> * x);
+
+        // High-frequency boost
+        y *= 1.0f + 0.2f * absOf(x);
+
+        return limit(SampleType(-1.0f), SampleType(1.0f), y);
+    }
+
+    template <typename SampleType>
+    SampleType fuzzBoxCurve(SampleType input) noexcept
+    {
+        SampleType x = limit(SampleType(-3.0f), SampleType(3.0f), input);
+
+        // Aggressive fuzz with hard clipping
+        SampleType y = x * 2.0f;
+
+        // Hard clipping with some softness
+        if (y > 1.0f)
+            y = 1.0f - 0.2f * expOf(-(y - 1.0f) * 3.0f);
+        else if (y < -1.0f)
+            y = -1.0f + 0.2f * expOf((y + 1.0f) * 3.0f);
+
+        // Add fuzz character with square wave approximation
+        y += 0.15f * ((y > 0.0f) ? 1.0f : -1.0f);
+
+        // Bit crushing effect
+        y = roundOf(y * 32.0f) / 32.0f;
+
+        return limit(SampleType(-1.0f), SampleType(1.0f), y * 0.7f);
+    }
+
+    template <typename SampleType>
+    SampleType overdriveCurve(SampleType input) noexcept
+    {
+        SampleType x = limit(SampleType(-2.5f), SampleType(2.5f), input);
+
+        // Musical overdrive with asymmetric clipping
+        SampleType y = x;
+
+        // Asymmetric clipping for even harmonics
+        if (x > 0.5f)
+            y = 0.5f + 0.5f * tanhOf(2.0f * (x - 0.5f));
+        else if (x < -0.7f)
+            y = -0.7f + 0.3f * tanhOf(1.5f * (x + 0.7f));
+
+        // Add musical harmonics
+        y += 0.1f * x * x * x;
+        y += 0.05f * x * x;
+
+        // Gentle compression
+        y *= 1.0f / (1.0f + 0.3f * absOf(y));
+
+        return y;
+    }
+
+    template <typename SampleType>
+    SampleType tube12AX7Curve(SampleType input, const SaturationState<SampleType>& state) noexcept
+    {
+        SampleType x = limit(SampleType(-4.0f), SampleType(4.0f), input);
+
+        // 12AX7 tube characteristics:
+        // - Grid conduction at ~0.3V
+        // - Smooth transition to saturation
+        // - Asymmetric transfer curve
+        // - Rich even and odd harmonics
+
+        // Pre-emphasis to model input capacitance
+        SampleType preEmphasis = x + 0.1f * (x - state.previous);
+
+        // Grid conduction modeling
+        SampleType gridCurrent = 0.0f;
+
+        if (preEmphasis > 0.3f)
+        {
+            gridCurrent = 0.15f * tanhOf((preEmphasis - 0.3f) * 3.0f);
+            preEmphasis -= gridCurrent;
+        }
+
+        // Asymmetric transfer curve modeling
+        SampleType y;
+
+        if (preEmphasis >= 0.0f)
+        {
+            // Positive half - smoother compression
+            SampleType drive = 1.0f + preEmphasis * 0.5f;
+            y = tanhOf(preEmphasis * drive);
+
+            // Cathode follower compression
+            y *= 1.0f / (1.0f + 0.2f * y);
+        }
+        else
+        {
+            // Negative half - harder clipping
+            SampleType drive = 1.0f - preEmphasis * 0.3f;
+            y = tanhOf(preEmphasis * drive * 1.2f);
+        }
+
+        // Harmonic enrichment based on actual 12AX7 measurements
+        // Strong 2nd harmonic (even)
+        y += 0.12f * sinOf(pi<SampleType> * preEmphasis) * (1.0f - absOf(y));
+
+        // 3rd harmonic (odd)
+        y += 0.08f * sinOf(3.0f * pi<SampleType> * preEmphasis) * (1.0f - absOf(y));
+
+        // 5th harmonic
+        y += 0.03f * sinOf(5.0f * pi<SampleType> * preEmphasis) * (1.0f - absOf(y));
+
+        // Miller capacitance effect (subtle high-frequency rolloff)
+        SampleType millerEffect = 0.95f + 0.05f * (1.0f - absOf(y));
+        y = y * millerEffect + state.previous * (1.0f - millerEffect);
+
+        // Output transformer saturation
+        if (absOf(y) > 0.8f)
+        {
+            SampleType excess = absOf(y) - 0.8f;
+            SampleType sign = (y < 0.0f) ? -1.0f : 1.0f;
+            y = sign * (0.8f + 0.2f * tanhOf(excess * 5.0f));
+        }
+
+        // Add subtle ghost notes (intermodulation)
+        y += 0.02f * y * y * y;
+
+        // Grid current recovery adds subtle pumping
+        y += gridCurrent * 0.3f;
+
+        return limit(SampleType(-1.0f), SampleType(1.0f), y * 0.85f);
+    }
+
+    /// The per-sample loop with the curve chosen once for the whole block
+    template <typename SampleType, typename Curve>
+    void applyCurve(SampleType* data, int numSamples, const SaturationSettings<SampleType>& settings, Curve&& curve) noexcept
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+            data[sample] = curve(data[sample] * settings.driveGain + settings.biasOffset) * settings.compensation;
+    }
+
+    template <typename SampleType>
+    void saturate(SampleType* data, int numSamples, const SaturationSettings<SampleType>& settings,
+                  SaturationState<SampleType>& state) noexcept
+    {
+        switch (settings.model)
+        {
+            case 0:  applyCurve(data, numSamples, settings, tubeCurve<SampleType>); break;
+            case 1:  applyCurve(data, numSamples, settings, transistorCurve<SampleType>); break;
+            case 2:  applyCurve(data, numSamples, settings, [&state](SampleType x) { return transformerCurve(x, state); }); break;
+            case 3:  applyCurve(data, numSamples, settings, tapeCurve<SampleType>); break;
+            case 4:  applyCurve(data, numSamples, settings, diodeCurve<SampleType>); break;
+            case 5:  applyCurve(data, numSamples, settings, vintageCurve<SampleType>); break;
+            case 6:  applyCurve(data, numSamples, settings, warmCurve<SampleType>); break;
+            case 7:  applyCurve(data, numSamples, settings, brightCurve<SampleType>); break;
+            case 8:  applyCurve(data, numSamples, settings, fuzzBoxCurve<SampleType>); break;
+            case 9:  applyCurve(data, numSamples, settings, overdriveCurve<SampleType>); break;
+            case 10: applyCurve(data, numSamples, settings, [&state](SampleType x) { return tube12AX7Curve(x, state); }); break;
+            default: break;
+        }
+    }
+
+    constexpr KernelTable kernelTable
+    {
+        sumOfSquares<float>,
+        sumOfSquares<double>,
+        peak<float>,
+        peak<double>,
+        saturate<float>,
+        saturate<double>
+    };
+}
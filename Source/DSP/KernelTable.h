@@ -0,0 +1,49 @@
+#pragma once
+
+// Deliberately free of JUCE and standard library headers: the files that fill these tables
+// are compiled with AVX2/AVX-512 enabled, and any inline function they pulled in could be
+// emitted with those instructions and then picked by the linker for callers on older CPUs.
+
+/// Per-block constants of a saturation curve, worked out by SaturationProcessor
+template <typename SampleType>
+struct SaturationSettings
+{
+    int model = 0;                      // SaturationProcessor::Model as an index
+    SampleType driveGain = 1;
+    SampleType biasOffset = 0;          // Added after the drive gain
+    SampleType compensation = 1;        // Output level correction for the drive
+};
+
+/// History of the curves that have memory (Transformer, Tube12AX7)
+template <typename SampleType>
+struct SaturationState
+{
+    SampleType previous = 0;
+    SampleType hysteresis = 0;
+};
+
+/// The hot loops of the chain, compiled once per instruction set. CpuDispatch selects the
+/// table the running CPU supports; callers go through its wrappers rather than using a
+/// table directly.
+struct KernelTable
+{
+    /// Sum of x^2 over the samples (RMS auto-gain and loudness meters)
+    double (*sumOfSquaresFloat)(const float* data, int numSamples) noexcept;
+    double (*sumOfSquaresDouble)(const double* data, int numSamples) noexcept;
+
+    /// Largest magnitude among the samples (silence detection)
+    float (*peakFloat)(const float* data, int numSamples) noexcept;
+    double (*peakDouble)(const double* data, int numSamples) noexcept;
+
+    /// Drive, bias, curve and compensation applied in place to one channel
+    void (*saturateFloat)(float* data, int numSamples, const SaturationSettings<float>& settings,
+                          SaturationState<float>& state) noexcept;
+    void (*saturateDouble)(double* data, int numSamples, const SaturationSettings<double>& settings,
+                           SaturationState<double>& state) noexcept;
+};
+
+// One table per variant, defined in the Kernels*.cpp files. Only the baseline is built on
+// every platform; the others exist where SPICE_X86_KERNEL_VARIANTS is set.
+const KernelTable& getBaselineKernels() noexcept;
+const KernelTable& getAvx2Kernels() noexcept;
+const KernelTable& getAvx512Kernels() noexcept;
@@ -0,0 +1,9 @@
+// Built with AVX2 and FMA enabled (see CMakeLists.txt). Only the table's address is taken
+// before CpuDispatch has checked that the CPU and operating system support them.
+#define SPICE_KERNEL_VECTOR_BYTES 32
+#include "KernelImplementations.h"
+
+const KernelTable& getAvx2Kernels() noexcept
+{
+    return kernelTable;
+}
@@ -0,0 +1,10 @@
+// Built with AVX-512 F/DQ/BW/VL and 512-bit vectors preferred (see CMakeLists.txt). Only the
+// table's address is taken before CpuDispatch has checked that the CPU and operating system
+// support them.
+#define SPICE_KERNEL_VECTOR_BYTES 64
+#include "KernelImplementations.h"
+
+const KernelTable& getAvx512Kernels() noexcept
+{
+    return kernelTable;
+}
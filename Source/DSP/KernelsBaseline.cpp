@@ -0,0 +1,9 @@
+// Built with the target's default flags (SSE2 on x86-64, NEON on arm64): the variant
+// every CPU the plugin runs on can execute.
+#define SPICE_KERNEL_VECTOR_BYTES 16
+#include "KernelImplementations.h"
+
+const KernelTable& getBaselineKernels() noexcept
+{
+    return kernelTable;
+}
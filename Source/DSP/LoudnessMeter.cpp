@@ -0,0 +1,155 @@
+#include "LoudnessMeter.h"
+#include "CpuDispatch.h"
+
+template <typename SampleType>
+void LoudnessMeter<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    const auto sampleRate = spec.sampleRate;
+
+    // K-weighting stage 1: high shelf modelling the acoustic effect of the head
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        *shelfFilter.state = juce::dsp::IIR::Coefficients<SampleType>(
+            static_cast<SampleType>((vh + vb * k / q + k * k) / a0),
+            static_cast<SampleType>(2.0 * (k * k - vh) / a0),
+            static_cast<SampleType>((vh - vb * k / q + k * k) / a0),
+            SampleType(1),
+            static_cast<SampleType>(2.0 * (k * k - 1.0) / a0),
+            static_cast<SampleType>((1.0 - k / q + k * k) / a0));
+    }
+
+    // K-weighting stage 2: RLB high-pass
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        *highPassFilter.state = juce::dsp::IIR::Coefficients<SampleType>(
+            SampleType(1), SampleType(-2), SampleType(1),
+            SampleType(1),
+            static_cast<SampleType>(2.0 * (k * k - 1.0) / a0),
+            static_cast<SampleType>((1.0 - k / q + k * k) / a0));
+    }
+
+    shelfFilter.prepare(spec);
+    highPassFilter.prepare(spec);
+
+    scratchBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    channelWeights.assign(spec.numChannels, 1.0f);
+
+    momentary.prepare(juce::roundToInt(momentaryWindowSeconds * sampleRate));
+    shortTerm.prepare(juce::roundToInt(shortTermWindowSeconds * sampleRate));
+
+    reset();
+}
+
+template <typename SampleType>
+void LoudnessMeter<SampleType>::reset()
+{
+    shelfFilter.reset();
+    highPassFilter.reset();
+    momentary.reset();
+    shortTerm.reset();
+}
+
+template <typename SampleType>
+void LoudnessMeter<SampleType>::setChannelWeights(const juce::Array<float>& newWeights)
+{
+    for (size_t channel = 0; channel < channelWeights.size(); ++channel)
+        channelWeights[channel] = static_cast<int>(channel) < newWeights.size() ? newWeights[static_cast<int>(channel)] : 1.0f;
+}
+
+template <typename SampleType>
+juce::Array<float> LoudnessMeter<SampleType>::getChannelWeightsForLayout(const juce::AudioChannelSet& layout)
+{
+    juce::Array<float> weights;
+
+    for (int channel = 0; channel < layout.size(); ++channel)
+    {
+        switch (layout.getTypeOfChannel(channel))
+        {
+            case juce::AudioChannelSet::LFE:
+            case juce::AudioChannelSet::LFE2:
+                weights.add(0.0f);
+                break;
+
+            case juce::AudioChannelSet::leftSurround:
+            case juce::AudioChannelSet::rightSurround:
+            case juce::AudioChannelSet::leftSurroundSide:
+            case juce::AudioChannelSet::rightSurroundSide:
+            case juce::AudioChannelSet::leftSurroundRear:
+            case juce::AudioChannelSet::rightSurroundRear:
+                weights.add(1.41f);
+                break;
+
+            default:
+                weights.add(1.0f);
+                break;
+        }
+    }
+
+    return weights;
+}
+
+template <typename SampleType>
+void LoudnessMeter<SampleType>::pushBlock(const juce::AudioBuffer<SampleType>& buffer)
+{
+    const auto numChannels = juce::jmin(buffer.getNumChannels(), scratchBuffer.getNumChannels());
+    const auto totalSamples = buffer.getNumSamples();
+    const auto maxBlockSize = scratchBuffer.getNumSamples();
+
+    for (int start = 0; start < totalSamples; start += maxBlockSize)
+    {
+        const auto numSamples = juce::jmin(maxBlockSize, totalSamples - start);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            scratchBuffer.copyFrom(channel, 0, buffer, channel, start, numSamples);
+
+        juce::dsp::AudioBlock<SampleType> block(scratchBuffer.getArrayOfWritePointers(),
+                                                static_cast<size_t>(numChannels),
+                                                static_cast<size_t>(numSamples));
+        juce::dsp::ProcessContextReplacing<SampleType> context(block);
+        shelfFilter.process(context);
+        highPassFilter.process(context);
+
+        double energy = 0.0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            energy += channelWeights[static_cast<size_t>(channel)] * CpuDispatch::sumOfSquares(scratchBuffer.getReadPointer(channel), numSamples);
+
+        // BS.1770 sums the weighted channel powers rather than averaging them
+        momentary.pushBlock(energy, numSamples);
+        shortTerm.pushBlock(energy, numSamples);
+    }
+}
+
+template <typename SampleType>
+bool LoudnessMeter<SampleType>::isGated() const
+{
+    const auto momentaryLoudness = getMomentaryLoudness();
+
+    return momentaryLoudness < absoluteGateLUFS
+        || momentaryLoudness < getShortTermLoudness() + relativeGateLU;
+}
+
+template <typename SampleType>
+double LoudnessMeter<SampleType>::toLUFS(float rms)
+{
+    if (rms <= 0.0f)
+        return -std::numeric_limits<double>::infinity();
+
+    return -0.691 + 10.0 * std::log10(static_cast<double>(rms) * static_cast<double>(rms));
+}
+
+template class LoudnessMeter<float>;
+template class LoudnessMeter<double>;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+#include "ChannelLaneFilter.h"
+#include "RunningRMS.h"
+
+/// ITU-R BS.1770 loudness of a multichannel signal over momentary (400 ms) and
+/// short-term (3 s) windows.
+///
+/// The K-weighting pre-filter and RLB high-pass run with channels packed into SIMD lanes
+/// on a scratch copy, so measuring never touches the audio. Window energies are kept as
+/// running sums over per-block entries, so reading the loudness is O(1).
+template <typename SampleType>
+class LoudnessMeter
+{
+public:
+    static constexpr double momentaryWindowSeconds = 0.4;
+    static constexpr double shortTermWindowSeconds = 3.0;
+
+    /// Measurements below this are treated as silence (BS.1770 absolute gate)
+    static constexpr double absoluteGateLUFS = -70.0;
+
+    /// Momentary loudness this far below the short-term loudness is gated out (relative gate)
+    static constexpr double relativeGateLU = -10.0;
+
+    LoudnessMeter() = default;
+    ~LoudnessMeter() = default;
+
+    /// Prepare the meter for playback
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    /// Clear the filters and measured energy
+    void reset();
+
+    /// Per-channel weights, e.g. 1.41 for surrounds and 0 for LFE
+    void setChannelWeights(const juce::Array<float>& newWeights);
+
+    /// BS.1770 channel weights for a bus layout
+    static juce::Array<float> getChannelWeightsForLayout(const juce::AudioChannelSet& layout);
+
+    /// Measure a block without modifying it
+    void pushBlock(const juce::AudioBuffer<SampleType>& buffer);
+
+    /// Loudness in LUFS, or -inf before any audio was measured
+    double getMomentaryLoudness() const { return toLUFS(momentary.getRMS()); }
+    double getShortTermLoudness() const { return toLUFS(shortTerm.getRMS()); }
+
+    /// True while the current momentary loudness falls below the absolute or relative gate
+    bool isGated() const;
+
+private:
+    static double toLUFS(float rms);
+
+    using Filter = ChannelLaneFilter<SampleType>;
+
+    Filter shelfFilter;
+    Filter highPassFilter;
+
+    juce::AudioBuffer<SampleType> scratchBuffer;
+    std::vector<float> channelWeights;
+
+    RunningRMS momentary;
+    RunningRMS shortTerm;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
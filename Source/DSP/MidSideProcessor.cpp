@@ -1,137 +1,180 @@
 #include "MidSideProcessor.h"
 
-MidSideProcessor::MidSideProcessor()
+template <typename SampleType>
+MidSideProcessor<SampleType>::MidSideProcessor()
 {
 }
 
-MidSideProcessor::~MidSideProcessor()
+template <typename SampleType>
+MidSideProcessor<SampleType>::~MidSideProcessor()
 {
 }
 
-void MidSideProcessor::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void MidSideProcessor<SampleType>::prepare(const juce::dsp::ProcessSpec&)
 {
-    // Prepare internal buffer for mid-side processing
-    midSideBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    // Stateless: every conversion is a per-sample matrix
 }
 
-void MidSideProcessor::reset()
+template <typename SampleType>
+void MidSideProcessor<SampleType>::reset()
 {
-    midSideBuffer.clear();
 }
 
-void MidSideProcessor::process(juce::dsp::ProcessContextReplacing<float>& context)
+template <typename SampleType>
+void MidSideProcessor<SampleType>::setChannelPairs(const juce::Array<ChannelPair>& pairs)
 {
-    if (!midSideEnabled)
-        return;
-        
-    auto& audioBlock = context.getOutputBlock();
-    auto numChannels = audioBlock.getNumChannels();
-    auto numSamples = audioBlock.getNumSamples();
+    numChannelPairs = juce::jmin(pairs.size(), maxChannelPairs);
     
-    // Only process stereo signals
-    if (numChannels != 2)
-        return;
+    for (int i = 0; i < numChannelPairs; ++i)
+        channelPairs[static_cast<size_t>(i)] = pairs.getReference(i);
+}
+
+template <typename SampleType>
+juce::Array<typename MidSideProcessor<SampleType>::ChannelPair> MidSideProcessor<SampleType>::getChannelPairsForLayout(const juce::AudioChannelSet& layout)
+{
+    using ChannelType = juce::AudioChannelSet::ChannelType;
     
-    // Get pointers to left and right channels
-    auto* leftChannel = audioBlock.getChannelPointer(0);
-    auto* rightChannel = audioBlock.getChannelPointer(1);
+    static constexpr std::pair<ChannelType, ChannelType> symmetricTypes[] =
+    {
+        { juce::AudioChannelSet::left,              juce::AudioChannelSet::right },
+        { juce::AudioChannelSet::leftCentre,        juce::AudioChannelSet::rightCentre },
+        { juce::AudioChannelSet::leftSurround,      juce::AudioChannelSet::rightSurround },
+        { juce::AudioChannelSet::leftSurroundSide,  juce::AudioChannelSet::rightSurroundSide },
+        { juce::AudioChannelSet::leftSurroundRear,  juce::AudioChannelSet::rightSurroundRear },
+        { juce::AudioChannelSet::wideLeft,          juce::AudioChannelSet::wideRight },
+        { juce::AudioChannelSet::topFrontLeft,      juce::AudioChannelSet::topFrontRight },
+        { juce::AudioChannelSet::topSideLeft,       juce::AudioChannelSet::topSideRight },
+        { juce::AudioChannelSet::topRearLeft,       juce::AudioChannelSet::topRearRight }
+    };
+    
+    juce::Array<ChannelPair> pairs;
     
-    // Convert stereo to mid-side and apply processing
-    for (size_t sample = 0; sample < numSamples; ++sample)
+    if (layout.isDiscreteLayout())
     {
-        float left = leftChannel[sample];
-        float right = rightChannel[sample];
-        
-        // Convert to mid-side
-        convertStereoToMidSide(left, right);
-        
-        // Now left = mid, right = side
-        float mid = left;
-        float side = right;
+        for (int channel = 0; channel + 1 < layout.size(); channel += 2)
+            pairs.add({ channel, channel + 1 });
         
-        // Apply gains
-        mid *= midGain;
-        side *= sideGain;
-        
-        // Apply stereo width control
-        side *= stereoWidth;
-        
-        // Apply mid-side balance
-        if (midSideBalance > 0.0f)
-        {
-            // Favor sides
-            mid *= (1.0f - midSideBalance);
-        }
-        else if (midSideBalance < 0.0f)
-        {
-            // Favor mid
-            side *= (1.0f + midSideBalance);
-        }
-        
-        // Convert back to stereo
-        convertMidSideToStereo(mid, side);
+        return pairs;
+    }
+    
+    for (const auto& types : symmetricTypes)
+    {
+        auto first = layout.getChannelIndexForType(types.first);
+        auto second = layout.getChannelIndexForType(types.second);
         
-        leftChannel[sample] = mid;   // mid becomes left after conversion
-        rightChannel[sample] = side; // side becomes right after conversion
+        if (first >= 0 && second >= 0)
+            pairs.add({ first, second });
     }
+    
+    return pairs;
 }
 
-void MidSideProcessor::processStereoToMidSide(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void MidSideProcessor<SampleType>::process(juce::dsp::ProcessContextReplacing<SampleType>& context)
 {
-    if (buffer.getNumChannels() != 2)
+    if (!midSideEnabled)
         return;
-        
-    auto* leftData = buffer.getWritePointer(0);
-    auto* rightData = buffer.getWritePointer(1);
-    auto numSamples = buffer.getNumSamples();
     
-    for (int sample = 0; sample < numSamples; ++sample)
+    // Encode, gains and decode collapse into one matrix, so this is a single pass
+    applyMatrix(context.getOutputBlock(), getDecodeMatrix() * getEncodeMatrix());
+}
+
+template <typename SampleType>
+void MidSideProcessor<SampleType>::processStereoToMidSide(juce::AudioBuffer<SampleType>& buffer)
+{
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    applyMatrix(block, Matrix::encoder());
+}
+
+template <typename SampleType>
+void MidSideProcessor<SampleType>::processMidSideToStereo(juce::AudioBuffer<SampleType>& buffer)
+{
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    applyMatrix(block, Matrix::decoder());
+}
+
+template <typename SampleType>
+typename MidSideProcessor<SampleType>::Matrix MidSideProcessor<SampleType>::getEncodeMatrix() const
+{
+    auto midScale = midGain;
+    auto sideScale = sideGain * stereoWidth;
+    
+    // Balance attenuates the other component: positive favours sides, negative favours mid
+    if (midSideBalance > 0)
+        midScale *= SampleType(1) - midSideBalance;
+    else if (midSideBalance < 0)
+        sideScale *= SampleType(1) + midSideBalance;
+    
+    const Matrix gains { midScale, 0, 0, sideScale };
+    return gains * Matrix::encoder();
+}
+
+template <typename SampleType>
+void MidSideProcessor<SampleType>::applyMatrix(juce::dsp::AudioBlock<SampleType>& block, const Matrix& matrix) const
+{
+    const auto numChannels = static_cast<int>(block.getNumChannels());
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+    
+    for (int pair = 0; pair < numChannelPairs; ++pair)
     {
-        float left = leftData[sample];
-        float right = rightData[sample];
+        const auto& channels = channelPairs[static_cast<size_t>(pair)];
         
-        convertStereoToMidSide(left, right);
+        if (channels.first >= numChannels || channels.second >= numChannels)
+            continue;
         
-        leftData[sample] = left;   // Now contains mid
-        rightData[sample] = right; // Now contains side
+        applyMatrixToPair(block.getChannelPointer(static_cast<size_t>(channels.first)),
+                          block.getChannelPointer(static_cast<size_t>(channels.second)),
+                          matrix, numSamples);
     }
 }
 
-void MidSideProcessor::processMidSideToStereo(juce::AudioBuffer<float>& buffer)
+template <typename SampleType>
+void MidSideProcessor<SampleType>::applyMatrixToPair(SampleType* first, SampleType* second, const Matrix& matrix, int numSamples)
 {
-    if (buffer.getNumChannels() != 2)
-        return;
-        
-    auto* midData = buffer.getWritePointer(0);
-    auto* sideData = buffer.getWritePointer(1);
-    auto numSamples = buffer.getNumSamples();
+    int sample = 0;
     
-    for (int sample = 0; sample < numSamples; ++sample)
+   #if JUCE_USE_SIMD
+    using Vector = juce::dsp::SIMDRegister<SampleType>;
+    constexpr auto numLanes = static_cast<int>(Vector::SIMDNumElements);
+    
+    const auto firstOffset = static_cast<int>(Vector::getNextSIMDAlignedPtr(first) - first);
+    const auto secondOffset = static_cast<int>(Vector::getNextSIMDAlignedPtr(second) - second);
+    
+    if (firstOffset == secondOffset)
     {
-        float mid = midData[sample];
-        float side = sideData[sample];
+        // Scalar head up to the first aligned sample
+        for (const auto head = juce::jmin(firstOffset, numSamples); sample < head; ++sample)
+        {
+            const auto a = first[sample];
+            const auto b = second[sample];
+            first[sample] = matrix.m00 * a + matrix.m01 * b;
+            second[sample] = matrix.m10 * a + matrix.m11 * b;
+        }
         
-        convertMidSideToStereo(mid, side);
+        const auto m00 = Vector::expand(matrix.m00);
+        const auto m01 = Vector::expand(matrix.m01);
+        const auto m10 = Vector::expand(matrix.m10);
+        const auto m11 = Vector::expand(matrix.m11);
         
-        midData[sample] = mid;   // Now contains left
-        sideData[sample] = side; // Now contains right
+        for (; sample + numLanes <= numSamples; sample += numLanes)
+        {
+            const auto a = Vector::fromRawArray(first + sample);
+            const auto b = Vector::fromRawArray(second + sample);
+            (m00 * a + m01 * b).copyToRawArray(first + sample);
+            (m10 * a + m11 * b).copyToRawArray(second + sample);
+        }
     }
-}
-
-void MidSideProcessor::convertStereoToMidSide(float& left, float& right)
-{
-    const float mid = (left + right) * 0.5f;   // Sum (center/mono information)
-    const float side = (left - right) * 0.5f;  // Difference (stereo width information)
+   #endif
     
-    left = mid;
-    right = side;
+    for (; sample < numSamples; ++sample)
+    {
+        const auto a = first[sample];
+        const auto b = second[sample];
+        first[sample] = matrix.m00 * a + matrix.m01 * b;
+        second[sample] = matrix.m10 * a + matrix.m11 * b;
+    }
 }
 
-void MidSideProcessor::convertMidSideToStereo(float& mid, float& side)
-{
-    const float left = mid + side;   // Mid + Side = Left
-    const float right = mid - side;  // Mid - Side = Right
-    
-    mid = left;   // Reuse mid variable for left
-    side = right; // Reuse side variable for right
-}
\ No newline at end of file
+template class MidSideProcessor<float>;
+template class MidSideProcessor<double>;
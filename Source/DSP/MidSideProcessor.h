@@ -1,10 +1,44 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
 
+template <typename SampleType>
 class MidSideProcessor
 {
 public:
+    /// Two channels that are encoded to mid (first) and side (second) together
+    struct ChannelPair
+    {
+        int first = 0;
+        int second = 1;
+    };
+    
+    static constexpr int maxChannelPairs = 8;
+    
+    /// 2x2 matrix applied to each channel pair: first' = m00 * first + m01 * second,
+    /// second' = m10 * first + m11 * second. Encoding, the mid/side gains and decoding are
+    /// all linear, so they compose into a single matrix, and a neighbouring scalar gain
+    /// stage can be folded in with scaled().
+    struct Matrix
+    {
+        SampleType m00 = 1, m01 = 0;
+        SampleType m10 = 0, m11 = 1;
+        
+        static constexpr Matrix identity()  { return { 1, 0, 0, 1 }; }
+        static constexpr Matrix encoder()   { return { SampleType(0.5), SampleType(0.5), SampleType(0.5), SampleType(-0.5) }; }
+        static constexpr Matrix decoder()   { return { 1, 1, 1, -1 }; }
+        
+        /// This matrix applied after other
+        constexpr Matrix operator*(const Matrix& other) const
+        {
+            return { m00 * other.m00 + m01 * other.m10, m00 * other.m01 + m01 * other.m11,
+                     m10 * other.m00 + m11 * other.m10, m10 * other.m01 + m11 * other.m11 };
+        }
+        
+        constexpr Matrix scaled(SampleType gain) const { return { m00 * gain, m01 * gain, m10 * gain, m11 * gain }; }
+    };
+    
     MidSideProcessor();
     ~MidSideProcessor();
     
@@ -12,38 +46,57 @@ public:
     void reset();
     
     // Processing methods
-    void process(juce::dsp::ProcessContextReplacing<float>& context);
-    void processStereoToMidSide(juce::AudioBuffer<float>& buffer);
-    void processMidSideToStereo(juce::AudioBuffer<float>& buffer);
+    void process(juce::dsp::ProcessContextReplacing<SampleType>& context);
+    void processStereoToMidSide(juce::AudioBuffer<SampleType>& buffer);
+    void processMidSideToStereo(juce::AudioBuffer<SampleType>& buffer);
+    
+    /// Apply a matrix to every channel pair in a single pass
+    void applyMatrix(juce::dsp::AudioBlock<SampleType>& block, const Matrix& matrix) const;
+    
+    /// Stereo to mid-side with the mid/side gains, width and balance folded in
+    Matrix getEncodeMatrix() const;
+    
+    /// Mid-side back to stereo
+    static constexpr Matrix getDecodeMatrix() { return Matrix::decoder(); }
     
     // Parameter setters
     void setMidSideEnabled(bool enabled) { midSideEnabled = enabled; }
-    void setMidGain(float gain) { midGain = gain; }
-    void setSideGain(float gain) { sideGain = gain; }
-    void setMidSideBalance(float balance) { midSideBalance = balance; }
-    void setStereoWidth(float width) { stereoWidth = juce::jlimit(0.0f, 2.0f, width); }
+    void setMidGain(SampleType gain) { midGain = gain; }
+    void setSideGain(SampleType gain) { sideGain = gain; }
+    void setMidSideBalance(SampleType balance) { midSideBalance = balance; }
+    void setStereoWidth(SampleType width) { stereoWidth = juce::jlimit(SampleType(0), SampleType(3), width); }
+    
+    /// Set the channel pairs to encode. Channels outside every pair (centre, LFE) pass through.
+    void setChannelPairs(const juce::Array<ChannelPair>& pairs);
+    
+    /// Symmetric pairs of a bus layout: L/R, surrounds, rears, wides and height pairs.
+    /// Discrete layouts pair neighbouring channels.
+    static juce::Array<ChannelPair> getChannelPairsForLayout(const juce::AudioChannelSet& layout);
+    
+    int getNumChannelPairs() const { return numChannelPairs; }
+    const ChannelPair& getChannelPair(int index) const { return channelPairs[static_cast<size_t>(index)]; }
     
     // Getters
     bool isMidSideEnabled() const { return midSideEnabled; }
-    float getMidGain() const { return midGain; }
-    float getSideGain() const { return sideGain; }
-    float getMidSideBalance() const { return midSideBalance; }
-    float getStereoWidth() const { return stereoWidth; }
+    SampleType getMidGain() const { return midGain; }
+    SampleType getSideGain() const { return sideGain; }
+    SampleType getMidSideBalance() const { return midSideBalance; }
+    SampleType getStereoWidth() const { return stereoWidth; }
     
 private:
-    // Mid-side conversion utilities
-    static void convertStereoToMidSide(float& left, float& right);
-    static void convertMidSideToStereo(float& mid, float& side);
+    /// Fused kernel for one channel pair, vectorised when both channels share an alignment
+    static void applyMatrixToPair(SampleType* first, SampleType* second, const Matrix& matrix, int numSamples);
     
     // Parameters
     bool midSideEnabled = false;
-    float midGain = 1.0f;        // Mid channel gain
-    float sideGain = 1.0f;       // Side channel gain
-    float midSideBalance = 0.0f; // -1 = all mid, +1 = all side, 0 = balanced
-    float stereoWidth = 1.0f;    // 0 = mono, 1 = normal, 2 = super wide
+    SampleType midGain = 1;        // Mid channel gain
+    SampleType sideGain = 1;       // Side channel gain
+    SampleType midSideBalance = 0; // -1 = all mid, +1 = all side, 0 = balanced
+    SampleType stereoWidth = 1;    // 0 = mono, 1 = normal, 3 = super wide
     
-    // Internal buffers for mid-side processing
-    juce::AudioBuffer<float> midSideBuffer;
+    // Channel pairs encoded to mid-side, stereo by default
+    std::array<ChannelPair, maxChannelPairs> channelPairs {};
+    int numChannelPairs = 1;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidSideProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "MultibandSaturation.h"
+#include "SilenceDetector.h"
+
+template <typename SampleType>
+MultibandSaturation<SampleType>::MultibandSaturation()
+{
+    updateCoefficients();
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    numChannels = static_cast<int>(spec.numChannels);
+    sampleRate = spec.sampleRate;
+
+    for (auto& band : bands)
+        band.prepare(spec);
+
+    channelStates.assign(spec.numChannels, {});
+    bandBuffer.setSize(numBands * numChannels, chunkSize);
+
+    updateCoefficients();
+    reset();
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::reset()
+{
+    std::fill(channelStates.begin(), channelStates.end(), ChannelState {});
+
+    for (auto& band : bands)
+        band.reset();
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::setCrossoverFrequencies(float lowMidHz, float midHighHz)
+{
+    // Keep the bands in order so the mid band never inverts
+    midHighHz = juce::jmax(midHighHz, lowMidHz * 1.1f);
+
+    if (lowMidHz != lowMidFrequency || midHighHz != midHighFrequency)
+    {
+        lowMidFrequency = lowMidHz;
+        midHighFrequency = midHighHz;
+        updateCoefficients();
+    }
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::setSampleRate(double newSampleRate)
+{
+    if (newSampleRate != sampleRate)
+    {
+        sampleRate = newSampleRate;
+        updateCoefficients();
+    }
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::updateCoefficients()
+{
+    // First stage feeds [low, low, high, high] into the second
+    setLane(splitCoefficients, 0, false, lowMidFrequency, sampleRate);
+    setLane(splitCoefficients, 1, false, lowMidFrequency, sampleRate);
+    setLane(splitCoefficients, 2, true, lowMidFrequency, sampleRate);
+    setLane(splitCoefficients, 3, true, lowMidFrequency, sampleRate);
+
+    // Second stage: lanes 0 + 1 are the low band's allpass, 2 is mid, 3 is high
+    setLane(bandSplitCoefficients, 0, false, midHighFrequency, sampleRate);
+    setLane(bandSplitCoefficients, 1, true, midHighFrequency, sampleRate);
+    setLane(bandSplitCoefficients, 2, false, midHighFrequency, sampleRate);
+    setLane(bandSplitCoefficients, 3, true, midHighFrequency, sampleRate);
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::setLane(QuadBiquad& coefficients, size_t lane, bool highPass, double frequency, double rate)
+{
+    // Butterworth section (Q = 1/sqrt(2)), computed in place
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jlimit(10.0, rate * 0.45, frequency) / rate;
+    const auto cosOmega = std::cos(omega);
+    const auto alpha = std::sin(omega) / juce::MathConstants<double>::sqrt2;
+    const auto a0 = 1.0 + alpha;
+
+    const auto b0 = (highPass ? (1.0 + cosOmega) : (1.0 - cosOmega)) * 0.5 / a0;
+
+    coefficients.b0[lane] = static_cast<SampleType>(b0);
+    coefficients.b1[lane] = static_cast<SampleType>(highPass ? -2.0 * b0 : 2.0 * b0);
+    coefficients.b2[lane] = static_cast<SampleType>(b0);
+    coefficients.a1[lane] = static_cast<SampleType>(-2.0 * cosOmega / a0);
+    coefficients.a2[lane] = static_cast<SampleType>((1.0 - alpha) / a0);
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::processQuad(Quad& x, const QuadBiquad& c, QuadState& state) noexcept
+{
+    for (size_t lane = 0; lane < numLanes; ++lane)
+    {
+        const auto input = x[lane];
+        const auto output = c.b0[lane] * input + state.s1[lane];
+        state.s1[lane] = c.b1[lane] * input - c.a1[lane] * output + state.s2[lane];
+        state.s2[lane] = c.b2[lane] * input - c.a2[lane] * output;
+        x[lane] = output;
+    }
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::splitBands(int channel, const SampleType* input, SampleType* low, SampleType* mid,
+                                                 SampleType* high, int numSamples) noexcept
+{
+    auto& state = channelStates[static_cast<size_t>(channel)];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        Quad lanes;
+        lanes.fill(input[i]);
+
+        processQuad(lanes, splitCoefficients, state.split[0]);
+        processQuad(lanes, splitCoefficients, state.split[1]);
+        processQuad(lanes, bandSplitCoefficients, state.bandSplit[0]);
+        processQuad(lanes, bandSplitCoefficients, state.bandSplit[1]);
+
+        low[i] = lanes[0] + lanes[1];
+        mid[i] = lanes[2];
+        high[i] = lanes[3];
+    }
+}
+
+template <typename SampleType>
+void MultibandSaturation<SampleType>::process(const juce::dsp::ProcessContextReplacing<SampleType>& context)
+{
+    if (context.isBypassed)
+        return;
+
+    auto& block = context.getOutputBlock();
+    const auto blockChannels = juce::jmin(static_cast<int>(block.getNumChannels()), numChannels);
+    const auto totalSamples = static_cast<int>(block.getNumSamples());
+
+    for (int start = 0; start < totalSamples; start += chunkSize)
+    {
+        const auto count = juce::jmin(chunkSize, totalSamples - start);
+
+        // Split every channel into its three bands
+        for (int channel = 0; channel < blockChannels; ++channel)
+        {
+            const auto* input = block.getChannelPointer(static_cast<size_t>(channel)) + start;
+            auto* low = bandBuffer.getWritePointer(lowBand * numChannels + channel);
+            auto* mid = bandBuffer.getWritePointer(midBand * numChannels + channel);
+            auto* high = bandBuffer.getWritePointer(highBand * numChannels + channel);
+
+            splitBands(channel, input, low, mid, high, count);
+        }
+
+        // Saturate each band with its own settings
+        for (int band = 0; band < numBands; ++band)
+        {
+            auto bandBlock = juce::dsp::AudioBlock<SampleType>(bandBuffer)
+                                 .getSubsetChannelBlock(static_cast<size_t>(band * numChannels), static_cast<size_t>(blockChannels))
+                                 .getSubBlock(0, static_cast<size_t>(count));
+
+            bands[static_cast<size_t>(band)].process(juce::dsp::ProcessContextReplacing<SampleType>(bandBlock));
+        }
+
+        // Sum the bands back into the block
+        for (int channel = 0; channel < blockChannels; ++channel)
+        {
+            auto* output = block.getChannelPointer(static_cast<size_t>(channel)) + start;
+
+            juce::FloatVectorOperations::copy(output, bandBuffer.getReadPointer(lowBand * numChannels + channel), count);
+            juce::FloatVectorOperations::add(output, bandBuffer.getReadPointer(midBand * numChannels + channel), count);
+            juce::FloatVectorOperations::add(output, bandBuffer.getReadPointer(highBand * numChannels + channel), count);
+        }
+    }
+}
+
+template <typename SampleType>
+double MultibandSaturation<SampleType>::getTailLengthSeconds() const
+{
+    // Butterworth poles decay with time constant 2Q / wc = sqrt(2) / wc, two sections per stage
+    const auto timeConstant = [](double frequency)
+    {
+        return juce::MathConstants<double>::sqrt2 / (juce::MathConstants<double>::twoPi * frequency);
+    };
+
+    return 2.0 * SilenceDetector::getDecayTimeSeconds(timeConstant(lowMidFrequency))
+         + 2.0 * SilenceDetector::getDecayTimeSeconds(timeConstant(midHighFrequency));
+}
+
+template class MultibandSaturation<float>;
+template class MultibandSaturation<double>;
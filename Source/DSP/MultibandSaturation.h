@@ -0,0 +1,100 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+#include "SaturationProcessor.h"
+
+/// Three-band saturation with phase-coherent Linkwitz-Riley (LR4) crossovers.
+///
+/// Runs inside the saturation stage's oversampled block, so every band shares the one
+/// oversampler. The crossover is laid out as four filter lanes per sample: the first
+/// stage computes [LP1, LP1, HP1, HP1] of the input, the second [LP2, HP2, LP2, HP2] of
+/// that, which yields low (the LP2 + HP2 allpass keeps it in phase with the upper bands),
+/// mid and high in one 4-lane pass the compiler maps onto SIMD registers. Each band then
+/// goes through its own SaturationProcessor and the bands are summed back together.
+template <typename SampleType>
+class MultibandSaturation
+{
+public:
+    enum Band
+    {
+        lowBand = 0,
+        midBand,
+        highBand,
+        numBands
+    };
+
+    /// Samples split per pass, independent of the (oversampled) block size
+    static constexpr int chunkSize = 256;
+
+    MultibandSaturation();
+    ~MultibandSaturation() = default;
+
+    /// Prepare for playback at the oversampled rate
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    /// Clear the crossover and saturation state
+    void reset();
+
+    /// Process audio block
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
+
+    /// Crossover frequencies in Hz, redesigned only when they change
+    void setCrossoverFrequencies(float lowMidHz, float midHighHz);
+
+    /// Rate the block is processed at, follows oversampling quality changes
+    void setSampleRate(double newSampleRate);
+
+    /// Split one channel into its three bands, before saturation (the crossover on its own)
+    void splitBands(int channel, const SampleType* input, SampleType* low, SampleType* mid, SampleType* high, int numSamples) noexcept;
+
+    /// Per-band saturation settings
+    SaturationProcessor<SampleType>& getBand(Band band) { return bands[static_cast<size_t>(band)]; }
+
+    /// Time for the crossover filters to ring out below -120 dBFS
+    double getTailLengthSeconds() const;
+
+private:
+    static constexpr size_t numLanes = 4;
+    using Quad = std::array<SampleType, numLanes>;
+
+    /// Biquad with its own coefficients in every lane (transposed direct form II)
+    struct QuadBiquad
+    {
+        alignas(32) Quad b0 {}, b1 {}, b2 {}, a1 {}, a2 {};
+    };
+
+    struct QuadState
+    {
+        alignas(32) Quad s1 {}, s2 {};
+    };
+
+    /// Two cascaded Butterworth sections per crossover stage make it LR4
+    struct ChannelState
+    {
+        std::array<QuadState, 2> split;
+        std::array<QuadState, 2> bandSplit;
+    };
+
+    static void processQuad(Quad& x, const QuadBiquad& coefficients, QuadState& state) noexcept;
+    static void setLane(QuadBiquad& coefficients, size_t lane, bool highPass, double frequency, double rate);
+
+    void updateCoefficients();
+
+    std::array<SaturationProcessor<SampleType>, numBands> bands;
+
+    QuadBiquad splitCoefficients;
+    QuadBiquad bandSplitCoefficients;
+    std::vector<ChannelState> channelStates;
+
+    // Band outputs, numBands groups of numChannels channels
+    juce::AudioBuffer<SampleType> bandBuffer;
+
+    float lowMidFrequency = 200.0f;
+    float midHighFrequency = 3000.0f;
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultibandSaturation)
+};
@@ -0,0 +1,191 @@
+#include "NoiseGate.h"
+
+template <typename SampleType>
+NoiseGate<SampleType>::NoiseGate()
+{
+    updateThresholds();
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+    maxLookaheadSamples = static_cast<int>(std::ceil(maxLookaheadSeconds * sampleRate));
+    lookaheadSamples = juce::jmin(lookaheadSamples, maxLookaheadSamples);
+    appliedLookaheadSamples = lookaheadSamples;
+
+    // Fast attack (1ms), medium release (50ms), 1ms smoothing to avoid clicks
+    attackCoefficient = static_cast<SampleType>(std::exp(-1.0 / (sampleRate * 0.001)));
+    releaseCoefficient = static_cast<SampleType>(std::exp(-1.0 / (sampleRate * 0.05)));
+    smoothingCoefficient = static_cast<SampleType>(std::exp(-1.0 / (sampleRate * 0.001)));
+    holdSamples = juce::roundToInt(holdMs * 0.001 * sampleRate);
+
+    channelStates.assign(spec.numChannels, {});
+    delayBuffer.setSize(static_cast<int>(spec.numChannels), maxLookaheadSamples + maxBlockSize);
+    gainBuffer.resize(static_cast<size_t>(maxBlockSize));
+
+    reset();
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::reset()
+{
+    std::fill(channelStates.begin(), channelStates.end(), ChannelState {});
+    delayBuffer.clear();
+    appliedLookaheadSamples = lookaheadSamples;
+    blockInputLevel = 0.0f;
+    anyChannelOpen = false;
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::setThreshold(float thresholdDecibels)
+{
+    if (thresholdDecibels != thresholdDb)
+    {
+        thresholdDb = thresholdDecibels;
+        updateThresholds();
+    }
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::setHysteresis(float hysteresisDecibels)
+{
+    if (hysteresisDecibels != hysteresisDb)
+    {
+        hysteresisDb = juce::jmax(0.0f, hysteresisDecibels);
+        updateThresholds();
+    }
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::setHoldTime(float holdMilliseconds)
+{
+    if (holdMilliseconds != holdMs)
+    {
+        holdMs = juce::jmax(0.0f, holdMilliseconds);
+        holdSamples = juce::roundToInt(holdMs * 0.001 * sampleRate);
+    }
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::setLookaheadSamples(int numSamples)
+{
+    lookaheadSamples = juce::jlimit(0, maxLookaheadSamples, numSamples);
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::updateThresholds()
+{
+    openThreshold = static_cast<SampleType>(juce::Decibels::decibelsToGain(thresholdDb));
+    closeThreshold = static_cast<SampleType>(juce::Decibels::decibelsToGain(thresholdDb - hysteresisDb));
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::process(const juce::dsp::ProcessContextReplacing<SampleType>& context)
+{
+    if (context.isBypassed)
+        return;
+
+    auto& block = context.getOutputBlock();
+    const auto numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), delayBuffer.getNumChannels());
+    const auto totalSamples = static_cast<int>(block.getNumSamples());
+
+    SampleType peakLevel = 0;
+    bool open = false;
+
+    for (int start = 0; start < totalSamples; start += maxBlockSize)
+    {
+        const auto numSamples = juce::jmin(maxBlockSize, totalSamples - start);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = block.getChannelPointer(static_cast<size_t>(channel)) + start;
+            auto& state = channelStates[static_cast<size_t>(channel)];
+
+            auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+            peakLevel = juce::jmax(peakLevel, -range.getStart(), range.getEnd());
+
+            // Detector runs on the undelayed input so the gate can open ahead of the audio
+            auto envelope = state.envelope;
+            auto gain = state.gain;
+            auto holdCounter = state.holdCounter;
+            auto isOpen = state.open;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const auto level = std::abs(data[sample]);
+
+                if (level > closeThreshold)
+                    envelope = level + attackCoefficient * (envelope - level);
+                else
+                    envelope *= releaseCoefficient;
+
+                if (envelope > openThreshold)
+                {
+                    isOpen = true;
+                    holdCounter = holdSamples;
+                }
+                else if (envelope < closeThreshold)
+                {
+                    if (holdCounter > 0)
+                        --holdCounter;
+                    else
+                        isOpen = false;
+                }
+
+                const SampleType target = isOpen ? SampleType(1) : SampleType(0);
+                gain = target + smoothingCoefficient * (gain - target);
+                gainBuffer[static_cast<size_t>(sample)] = gain;
+            }
+
+            state.envelope = envelope;
+            state.gain = gain;
+            state.holdCounter = holdCounter;
+            state.open = isOpen;
+            open = open || isOpen;
+
+            if (maxLookaheadSamples > 0)
+            {
+                // The history is kept even without lookahead, so switching it on has real
+                // input to read rather than whatever an earlier setting left behind
+                auto* delayed = delayBuffer.getWritePointer(channel);
+                juce::FloatVectorOperations::copy(delayed + maxLookaheadSamples, data, numSamples);
+
+                const auto* current = delayed + maxLookaheadSamples - lookaheadSamples;
+
+                if (appliedLookaheadSamples == lookaheadSamples)
+                {
+                    juce::FloatVectorOperations::multiply(data, current, gainBuffer.data(), numSamples);
+                }
+                else
+                {
+                    // Fade from the old delay to the new one, as jumping between read
+                    // positions would click
+                    const auto* previous = delayed + maxLookaheadSamples - appliedLookaheadSamples;
+                    const auto step = SampleType(1) / static_cast<SampleType>(numSamples);
+
+                    for (int sample = 0; sample < numSamples; ++sample)
+                    {
+                        const auto fade = static_cast<SampleType>(sample + 1) * step;
+                        data[sample] = (previous[sample] + fade * (current[sample] - previous[sample])) * gainBuffer[static_cast<size_t>(sample)];
+                    }
+                }
+
+                std::memmove(delayed, delayed + numSamples, static_cast<size_t>(maxLookaheadSamples) * sizeof(SampleType));
+            }
+            else
+            {
+                juce::FloatVectorOperations::multiply(data, gainBuffer.data(), numSamples);
+            }
+        }
+
+        appliedLookaheadSamples = lookaheadSamples;
+    }
+
+    blockInputLevel = static_cast<float>(peakLevel);
+    anyChannelOpen = open;
+}
+
+template class NoiseGate<float>;
+template class NoiseGate<double>;
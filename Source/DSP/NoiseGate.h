@@ -0,0 +1,93 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+/// Block-based noise gate with hysteresis, hold and optional lookahead.
+///
+/// Attack, release and smoothing coefficients are computed once per sample rate and the
+/// thresholds only when they change, so the per-sample work is a handful of multiply-adds.
+/// The gain curve of each channel is rendered into a buffer and applied with vectorised
+/// FloatVectorOperations, and the detector level is published once per block.
+template <typename SampleType>
+class NoiseGate
+{
+public:
+    /// Longest lookahead the delay line is allocated for
+    static constexpr double maxLookaheadSeconds = 0.01;
+
+    NoiseGate();
+    ~NoiseGate() = default;
+
+    /// Prepare the gate for playback
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    /// Close the gate and clear the lookahead delay
+    void reset();
+
+    /// Process audio block
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
+
+    /// Opening threshold in dB
+    void setThreshold(float thresholdDecibels);
+
+    /// The gate closes this many dB below the opening threshold
+    void setHysteresis(float hysteresisDecibels);
+
+    /// Time the gate stays open after the level falls below the closing threshold
+    void setHoldTime(float holdMilliseconds);
+
+    /// Delay applied to the audio so the gate opens ahead of transients. A change is
+    /// crossfaded over the next block rather than jumping to the new read position.
+    void setLookaheadSamples(int numSamples);
+    int getLookaheadSamples() const { return lookaheadSamples; }
+    int getMaxLookaheadSamples() const { return maxLookaheadSamples; }
+
+    /// Peak detector level of the last processed block
+    float getBlockInputLevel() const { return blockInputLevel; }
+
+    /// True if any channel was open at the end of the last processed block
+    bool isOpen() const { return anyChannelOpen; }
+
+private:
+    void updateThresholds();
+
+    struct ChannelState
+    {
+        SampleType envelope = 0;
+        SampleType gain = 1;
+        int holdCounter = 0;
+        bool open = false;
+    };
+
+    // Settings
+    float thresholdDb = -40.0f;
+    float hysteresisDb = 0.0f;
+    float holdMs = 0.0f;
+    double sampleRate = 44100.0;
+
+    // Derived values
+    SampleType openThreshold = 0;
+    SampleType closeThreshold = 0;
+    SampleType attackCoefficient = 0;
+    SampleType releaseCoefficient = 0;
+    SampleType smoothingCoefficient = 0;
+    int holdSamples = 0;
+
+    int lookaheadSamples = 0;
+    int appliedLookaheadSamples = 0;    // Lookahead the last block was delayed by
+    int maxLookaheadSamples = 0;
+    int maxBlockSize = 0;
+
+    std::vector<ChannelState> channelStates;
+
+    // Per-channel delay line holding the longest lookahead's worth of input followed by the
+    // current block, so any lookahead can be read from it
+    juce::AudioBuffer<SampleType> delayBuffer;
+    std::vector<SampleType> gainBuffer;
+
+    float blockInputLevel = 0.0f;
+    bool anyChannelOpen = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NoiseGate)
+};
@@ -1,53 +1,116 @@
 #include "Oversampling.h"
 
-Oversampling::Oversampling(int numChannels, int factor, FilterType type)
-    : oversamplingFactor(factor)
+template <typename SampleType>
+Oversampling<SampleType>::Oversampling(int numChannels, int factor, FilterType type)
+    : filterType(type == filterHalfBandPolyphaseIIR ? JuceOversampling::filterHalfBandPolyphaseIIR
+                                                    : JuceOversampling::filterHalfBandFIREquiripple),
+      oversamplingFactor(factor),
+      numOversamplerChannels(numChannels)
 {
-    auto filterType = (type == filterHalfBandPolyphaseIIR) 
-        ? juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR
-        : juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple;
+    createOversamplers();
+}
+
+template <typename SampleType>
+int Oversampling<SampleType>::getFactorIndex(int factor)
+{
+    for (size_t i = 0; i < supportedFactors.size(); ++i)
+        if (supportedFactors[i] == factor)
+            return static_cast<int>(i);
     
-    oversampler = std::make_unique<juce::dsp::Oversampling<float>>(
-        numChannels, 
-        factor, 
-        filterType, 
-        true
-    );
+    jassertfalse; // Only the quality factors are built
+    return 0;
 }
 
-void Oversampling::prepare(const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void Oversampling<SampleType>::createOversamplers()
 {
-    oversampler->initProcessing(spec.maximumBlockSize);
-    oversampler->reset();
+    for (size_t i = 0; i < supportedFactors.size(); ++i)
+        oversamplers[i] = std::make_unique<JuceOversampling>(numOversamplerChannels, supportedFactors[i], filterType, true);
+    
+    oversampler = oversamplers[static_cast<size_t>(getFactorIndex(oversamplingFactor))].get();
 }
 
-void Oversampling::reset()
+template <typename SampleType>
+void Oversampling<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    // The oversamplers' filters are allocated per channel, so rebuild them for the bus width
+    if (static_cast<int>(spec.numChannels) != numOversamplerChannels)
+    {
+        numOversamplerChannels = static_cast<int>(spec.numChannels);
+        createOversamplers();
+    }
+    
+    for (auto& each : oversamplers)
+    {
+        each->initProcessing(spec.maximumBlockSize);
+        each->reset();
+    }
+}
+
+template <typename SampleType>
+void Oversampling<SampleType>::reset()
 {
     oversampler->reset();
 }
 
-juce::dsp::AudioBlock<float> Oversampling::processSamplesUp(const juce::dsp::AudioBlock<float>& inputBlock)
+template <typename SampleType>
+juce::dsp::AudioBlock<SampleType> Oversampling<SampleType>::processSamplesUp(const juce::dsp::AudioBlock<SampleType>& inputBlock)
 {
     return oversampler->processSamplesUp(inputBlock);
 }
 
-void Oversampling::processSamplesDown(juce::dsp::AudioBlock<float>& outputBlock)
+template <typename SampleType>
+void Oversampling<SampleType>::processSamplesDown(juce::dsp::AudioBlock<SampleType>& outputBlock)
 {
     oversampler->processSamplesDown(outputBlock);
 }
 
-void Oversampling::updateQuality(int factor, const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+int Oversampling<SampleType>::getRateMultiplier() const
+{
+    return static_cast<int>(oversampler->getOversamplingFactor());
+}
+
+template <typename SampleType>
+int Oversampling<SampleType>::getMaximumRateMultiplier() const
+{
+    size_t multiplier = 1;
+    
+    for (const auto& each : oversamplers)
+        multiplier = juce::jmax(multiplier, each->getOversamplingFactor());
+    
+    return static_cast<int>(multiplier);
+}
+
+template <typename SampleType>
+SampleType Oversampling<SampleType>::getLatencyInSamples() const
+{
+    return oversampler->getLatencyInSamples();
+}
+
+template <typename SampleType>
+int Oversampling<SampleType>::getTailLengthSamples() const
+{
+    // The polyphase IIR half-band stages decay well below -120 dBFS within
+    // a few dozen samples per stage, so allow a generous margin on top of the latency
+    const int ringingSamplesPerStage = 64;
+    auto numStages = static_cast<int>(std::log2(static_cast<double>(oversampler->getOversamplingFactor())));
+    
+    return juce::roundToInt(getLatencyInSamples()) + numStages * ringingSamplesPerStage;
+}
+
+template <typename SampleType>
+void Oversampling<SampleType>::updateQuality(int factor)
 {
     if (factor != oversamplingFactor)
     {
         oversamplingFactor = factor;
-        oversampler = std::make_unique<juce::dsp::Oversampling<float>>(
-            static_cast<int>(spec.numChannels),
-            factor,
-            juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
-            true
-        );
-        oversampler->initProcessing(spec.maximumBlockSize);
+        oversampler = oversamplers[static_cast<size_t>(getFactorIndex(factor))].get();
+        
+        // Start from silence rather than from state left over from the last time it ran
         oversampler->reset();
     }
-}
\ No newline at end of file
+}
+
+template class Oversampling<float>;
+template class Oversampling<double>;
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
 
+template <typename SampleType>
 class Oversampling
 {
 public:
@@ -11,19 +13,46 @@ public:
         filterHalfBandFIREquiripple
     };
     
+    /// Factors the quality setting switches between. All of them are built in prepare(),
+    /// so switching never allocates on the audio thread.
+    static constexpr std::array<int, 3> supportedFactors { 1, 2, 4 };
+    
     Oversampling(int numChannels, int factor, FilterType type);
     ~Oversampling() = default;
     
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset();
-    void updateQuality(int factor, const juce::dsp::ProcessSpec& spec);
     
-    juce::dsp::AudioBlock<float> processSamplesUp(const juce::dsp::AudioBlock<float>& inputBlock);
-    void processSamplesDown(juce::dsp::AudioBlock<float>& outputBlock);
+    /// Switch to another of the supported factors (audio thread safe)
+    void updateQuality(int factor);
+    
+    juce::dsp::AudioBlock<SampleType> processSamplesUp(const juce::dsp::AudioBlock<SampleType>& inputBlock);
+    void processSamplesDown(juce::dsp::AudioBlock<SampleType>& outputBlock);
     
+    /// The quality factor, which juce::dsp::Oversampling takes as a power of two
     int getOversamplingFactor() const { return oversamplingFactor; }
     
+    /// Ratio between the oversampled and the host rate at the current factor
+    int getRateMultiplier() const;
+    
+    /// Largest ratio between the oversampled and the host block length over all factors
+    int getMaximumRateMultiplier() const;
+    
+    /// Latency of the up/down filters at the host sample rate
+    SampleType getLatencyInSamples() const;
+    
+    /// Latency plus the time the half-band filters need to ring out, at the host sample rate
+    int getTailLengthSamples() const;
+    
 private:
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler;
+    using JuceOversampling = juce::dsp::Oversampling<SampleType>;
+    
+    static int getFactorIndex(int factor);
+    void createOversamplers();
+    
+    std::array<std::unique_ptr<JuceOversampling>, supportedFactors.size()> oversamplers;
+    JuceOversampling* oversampler = nullptr;    // The one for the current factor
+    typename JuceOversampling::FilterType filterType;
     int oversamplingFactor;
-};
\ No newline at end of file
+    int numOversamplerChannels;
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include "StageProfiler.h"
+
+/// Flat list of processing stages compiled from the currently enabled features.
+///
+/// The graph is compiled off the audio thread whenever the stage configuration changes
+/// and handed over through a lock-free triple buffer, so the audio callback only walks
+/// an array of member-function callbacks and never waits for, or frees, a graph. The
+/// latency of the stages travels with the graph, so it always matches the one running.
+template <typename Owner, typename SampleType>
+class ProcessingGraph
+{
+public:
+    /// How a stage uses the buffer it is handed
+    enum class BufferAccess
+    {
+        inPlace,    // Reads and overwrites the buffer
+        readOnly,   // Only observes the buffer (analysis taps)
+        needsCopy   // Needs its unprocessed input next to the buffer it overwrites
+    };
+
+    /// Stage callback. For needsCopy stages stageInput is a snapshot of the buffer
+    /// taken right before the stage, otherwise it refers to the buffer itself.
+    using StageFunction = void (Owner::*)(juce::AudioBuffer<SampleType>& buffer,
+                                          const juce::AudioBuffer<SampleType>& stageInput);
+
+    struct Stage
+    {
+        const char* name = nullptr;
+        StageFunction function = nullptr;
+        BufferAccess access = BufferAccess::inPlace;
+    };
+
+    static constexpr int maxStages = 24;
+
+    /// Receives the enabled stages, in processing order, while a graph is compiled
+    class Builder
+    {
+    public:
+        void addStage(const char* name, StageFunction function, BufferAccess access = BufferAccess::inPlace)
+        {
+            jassert(numStages < maxStages);
+
+            if (numStages < maxStages)
+                stages[static_cast<size_t>(numStages++)] = { name, function, access };
+        }
+
+        /// Delay the compiled stages add, in samples
+        void setLatencySamples(int samples) { latencySamples = samples; }
+
+    private:
+        friend class ProcessingGraph;
+
+        std::array<Stage, maxStages> stages {};
+        int numStages = 0;
+        juce::uint32 topology = 0;
+        int latencySamples = 0;
+    };
+
+    ProcessingGraph() = default;
+
+    /// Allocate the snapshot buffer used by needsCopy stages (not on the audio thread)
+    void prepare(int numChannels, int maximumBlockSize)
+    {
+        stageCopy.setSize(numChannels, maximumBlockSize, false, false, false);
+    }
+
+    /// Compile a new graph and publish it to the audio thread. The topology value
+    /// identifies the configuration the stages were compiled for.
+    /// Must not be called from the audio thread.
+    template <typename AddStagesFunction>
+    void compile(juce::uint32 topology, AddStagesFunction&& addStages)
+    {
+        const juce::ScopedLock sl(compileLock);
+
+        auto& graph = graphs[static_cast<size_t>(writeIndex)];
+        graph.numStages = 0;
+        graph.topology = topology;
+        graph.latencySamples = 0;
+        addStages(graph);
+
+        publishedTopology.store(topology);
+        publishedLatencySamples.store(graph.latencySamples);
+        writeIndex = pendingIndex.exchange(writeIndex | freshFlag) & indexMask;
+    }
+
+    /// Take the most recently published graph, if there is a new one (audio thread, or
+    /// while the audio thread is stopped). Returns true if the graph changed.
+    bool acquire()
+    {
+        if ((pendingIndex.load() & freshFlag) == 0)
+            return false;
+
+        readIndex = pendingIndex.exchange(readIndex) & indexMask;
+        activeLatencySamples.store(graphs[static_cast<size_t>(readIndex)].latencySamples);
+        return true;
+    }
+
+    /// Run all stages of the acquired graph on the buffer (audio thread). With a profiler,
+    /// every stage is timed under its name; without one the untimed loop runs.
+    void process(Owner& owner, juce::AudioBuffer<SampleType>& buffer, StageProfiler* profiler = nullptr)
+    {
+        const auto& graph = graphs[static_cast<size_t>(readIndex)];
+
+        if (profiler == nullptr)
+        {
+            for (int i = 0; i < graph.numStages; ++i)
+                processStage(owner, buffer, graph.stages[static_cast<size_t>(i)]);
+        }
+        else
+        {
+            for (int i = 0; i < graph.numStages; ++i)
+            {
+                const auto& stage = graph.stages[static_cast<size_t>(i)];
+                const StageProfiler::ScopedTimer timer(profiler, stage.name, buffer.getNumSamples());
+                processStage(owner, buffer, stage);
+            }
+        }
+    }
+
+    /// Topology of the most recently compiled graph
+    juce::uint32 getPublishedTopology() const { return publishedTopology.load(); }
+
+    /// Latency of the most recently compiled graph
+    int getPublishedLatencySamples() const { return publishedLatencySamples.load(); }
+
+    /// Topology of the acquired graph (audio thread)
+    juce::uint32 getActiveTopology() const { return graphs[static_cast<size_t>(readIndex)].topology; }
+
+    /// Latency of the acquired graph, safe to read from any thread
+    int getActiveLatencySamples() const { return activeLatencySamples.load(); }
+
+private:
+    void processStage(Owner& owner, juce::AudioBuffer<SampleType>& buffer, const Stage& stage)
+    {
+        if (stage.access == BufferAccess::needsCopy)
+        {
+            stageCopy.makeCopyOf(buffer, true);
+            (owner.*stage.function)(buffer, stageCopy);
+        }
+        else
+        {
+            (owner.*stage.function)(buffer, buffer);
+        }
+    }
+
+    static constexpr int freshFlag = 4;
+    static constexpr int indexMask = 3;
+
+    std::array<Builder, 3> graphs;
+    int writeIndex = 0;                 // Owned by compile()
+    int readIndex = 1;                  // Owned by the audio thread
+    std::atomic<int> pendingIndex { 2 }; // Last published graph, with freshFlag while unread
+    std::atomic<juce::uint32> publishedTopology { 0 };
+    std::atomic<int> publishedLatencySamples { 0 };
+    std::atomic<int> activeLatencySamples { 0 };
+
+    juce::CriticalSection compileLock;
+    juce::AudioBuffer<SampleType> stageCopy;
+
+    JUCE_DECLARE_NON_COPYABLE(ProcessingGraph)
+};
@@ -0,0 +1,77 @@
+#include "RunningRMS.h"
+
+void RunningRMS::prepare(int windowLengthSamples, int minBlockSize)
+{
+    windowLength = juce::jmax(1, windowLengthSamples);
+
+    // Enough entries to cover the window with blocks of minBlockSize, plus the newest block
+    entries.assign(static_cast<size_t>(windowLength / juce::jmax(1, minBlockSize) + 2), {});
+    reset();
+}
+
+void RunningRMS::reset()
+{
+    std::fill(entries.begin(), entries.end(), Entry {});
+    oldest = 0;
+    numEntries = 0;
+    writePosition = 0;
+    energySum = 0.0;
+    sampleSum = 0;
+}
+
+void RunningRMS::pushBlock(double sumOfSquares, int numSamples)
+{
+    if (numSamples <= 0 || entries.empty())
+        return;
+
+    const auto capacity = static_cast<int>(entries.size());
+
+    if (numEntries == capacity)
+        removeOldest();
+
+    entries[static_cast<size_t>(writePosition)] = { sumOfSquares, numSamples };
+    energySum += sumOfSquares;
+    sampleSum += numSamples;
+    ++numEntries;
+
+    // Drop whole blocks that have left the window, always keeping the newest one
+    while (numEntries > 1 && sampleSum - entries[static_cast<size_t>(oldest)].numSamples >= windowLength)
+        removeOldest();
+
+    if (++writePosition == capacity)
+    {
+        writePosition = 0;
+        recomputeSums();
+    }
+}
+
+float RunningRMS::getRMS() const
+{
+    if (sampleSum <= 0)
+        return 0.0f;
+
+    return static_cast<float>(std::sqrt(juce::jmax(0.0, energySum) / static_cast<double>(sampleSum)));
+}
+
+void RunningRMS::removeOldest()
+{
+    const auto& entry = entries[static_cast<size_t>(oldest)];
+    energySum -= entry.energy;
+    sampleSum -= entry.numSamples;
+
+    oldest = (oldest + 1) % static_cast<int>(entries.size());
+    --numEntries;
+}
+
+void RunningRMS::recomputeSums()
+{
+    energySum = 0.0;
+    sampleSum = 0;
+
+    for (int i = 0; i < numEntries; ++i)
+    {
+        const auto& entry = entries[static_cast<size_t>((oldest + i) % static_cast<int>(entries.size()))];
+        energySum += entry.energy;
+        sampleSum += entry.numSamples;
+    }
+}
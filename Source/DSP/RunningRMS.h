@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+/// RMS over a sliding time window, updated in O(1) per block.
+///
+/// Each processed block contributes one entry (its energy and length) instead of one entry
+/// per sample, and a running sum is kept so reading the level never walks the window.
+/// The sum is rebuilt from the stored entries every time the entry ring wraps, which keeps
+/// floating-point drift from accumulating over long sessions.
+class RunningRMS
+{
+public:
+    RunningRMS() = default;
+    ~RunningRMS() = default;
+
+    /// Allocate for a window of the given length. Blocks are assumed to be at least
+    /// minBlockSize samples long; shorter blocks shrink the effective window.
+    void prepare(int windowLengthSamples, int minBlockSize = 16);
+
+    /// Forget all measured energy
+    void reset();
+
+    /// Add a block given its sum of squares (averaged over channels) and its length
+    void pushBlock(double sumOfSquares, int numSamples);
+
+    /// RMS over the most recent window, 0 before any audio was pushed
+    float getRMS() const;
+
+private:
+    struct Entry
+    {
+        double energy = 0.0;
+        int numSamples = 0;
+    };
+
+    void removeOldest();
+    void recomputeSums();
+
+    std::vector<Entry> entries;
+    int oldest = 0;
+    int numEntries = 0;
+    int writePosition = 0;
+
+    int windowLength = 0;
+    double energySum = 0.0;
+    juce::int64 sampleSum = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RunningRMS)
+};
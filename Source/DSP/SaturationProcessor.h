@@ -1,7 +1,9 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_dsp/juce_dsp.h>
+#include "CpuDispatch.h"
 
+template <typename SampleType>
 class SaturationProcessor
 {
 public:
@@ -25,35 +27,22 @@ public:
     
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset();
-    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
     
-    void setDrive(float newDrive);
+    void setDrive(SampleType newDrive);
     void setModel(Model newModel);
-    void setBias(float newBias);
+    void setBias(SampleType newBias);
     
 private:
-    float processSample(float input, int channel);
+    /// Drive gain, bias offset and output compensation for the current settings
+    SaturationSettings<SampleType> getSettings() const;
     
-    float tubeSaturation(float input);
-    float transistorSaturation(float input);
-    float transformerSaturation(float input);
-    float tapeSaturation(float input);
-    float diodeSaturation(float input);
-    float vintageSaturation(float input);
-    float warmSaturation(float input);
-    float brightSaturation(float input);
-    float fuzzBoxSaturation(float input);
-    float overdriveSaturation(float input);
-    float tube12AX7Saturation(float input);
-    
-    float drive = 50.0f;
-    float bias = 0.0f;
+    SampleType drive = 50;
+    SampleType bias = 0;
     Model model = Model::Tube;
     
-    std::vector<float> prevSample;
-    std::vector<float> hysteresis;
-    
-    float sampleRate = 44100.0f;
+    // Memory of the Transformer and Tube12AX7 curves, carried from channel to channel
+    SaturationState<SampleType> curveState;
     
-    static constexpr float PI = juce::MathConstants<float>::pi;
+    SampleType sampleRate = 44100;
 };
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <typeindex>
+
+/// Process-wide cache of read-only DSP designs: coefficient tables, lookup tables, IR spectra.
+///
+/// Held through juce::SharedResourcePointer, so every plugin instance in the host process
+/// shares one cache that lives as long as any instance does. Designs are handed out as
+/// shared_ptr<const Design> and only weakly referenced by the cache: the first instance to
+/// ask builds a design, every instance preparing with the same key shares it, and it is
+/// freed when the last of them lets go. Lookups lock, so make them from prepare(), never
+/// from the audio thread.
+class SharedDesignCache
+{
+public:
+    struct Key
+    {
+        juce::String name;          // What is being designed, e.g. "cabinet"
+        double sampleRate = 0.0;
+        juce::int64 settings = 0;   // Hash of any other inputs to the design
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie(name, sampleRate, settings) < std::tie(other.name, other.sampleRate, other.settings);
+        }
+    };
+
+    SharedDesignCache() = default;
+
+    /// Return the design for the key, building it with build() if no instance holds one.
+    /// build must return something convertible to std::shared_ptr<const Design>.
+    template <typename Design, typename BuildFunction>
+    std::shared_ptr<const Design> getOrCreate(const Key& key, BuildFunction&& build)
+    {
+        const juce::ScopedLock sl(lock);
+
+        // The design type is part of the key, so float and double tables never collide
+        auto& entry = entries[{ std::type_index(typeid(Design)), key }];
+
+        if (auto existing = entry.lock())
+            return std::static_pointer_cast<const Design>(existing);
+
+        std::shared_ptr<const Design> design = build();
+        entry = design;
+
+        removeExpiredEntries();
+        return design;
+    }
+
+    /// Number of designs currently held by at least one instance
+    int getNumSharedDesigns() const
+    {
+        const juce::ScopedLock sl(lock);
+        int count = 0;
+
+        for (const auto& entry : entries)
+            if (!entry.second.expired())
+                ++count;
+
+        return count;
+    }
+
+private:
+    void removeExpiredEntries()
+    {
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (it->second.expired())
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    std::map<std::pair<std::type_index, Key>, std::weak_ptr<const void>> entries;
+    juce::CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedDesignCache)
+};
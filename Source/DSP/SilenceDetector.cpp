@@ -0,0 +1,109 @@
+#include "SilenceDetector.h"
+#include "CpuDispatch.h"
+
+void SilenceDetector::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    reset();
+}
+
+void SilenceDetector::reset()
+{
+    silentSamples = 0;
+    lastBlockSize = 0;
+    outputSilent = false;
+    idle = false;
+}
+
+template <typename SampleType>
+bool SilenceDetector::pushInputBlock(const juce::AudioBuffer<SampleType>& buffer)
+{
+    lastBlockSize = buffer.getNumSamples();
+
+    if (!isSilent(buffer))
+    {
+        silentSamples = 0;
+        idle = false;
+        return false;
+    }
+
+    silentSamples += lastBlockSize;
+
+    // Once the tails have rung out the output stays silent until the input changes
+    idle = idle || (outputSilent && silentSamples > tailLengthSamples);
+    return idle;
+}
+
+template <typename SampleType>
+void SilenceDetector::pushOutputBlock(const juce::AudioBuffer<SampleType>& buffer)
+{
+    outputSilent = isSilent(buffer);
+}
+
+template <typename SampleType>
+bool SilenceDetector::isSilent(const juce::AudioBuffer<SampleType>& buffer)
+{
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        if (CpuDispatch::peak(buffer.getReadPointer(channel), buffer.getNumSamples()) >= SampleType(silenceThreshold))
+            return false;
+    }
+
+    return true;
+}
+
+template <typename SampleType>
+double SilenceDetector::getDecayTimeSeconds(const juce::dsp::IIR::Coefficients<SampleType>& coefficients, double sampleRate)
+{
+    // Coefficients are stored normalised as b0, b1, [b2,] a1, [a2]
+    const auto& c = coefficients.coefficients;
+    const auto order = static_cast<int>(coefficients.getFilterOrder());
+
+    double poleRadius = 0.0;
+
+    if (order == 1)
+    {
+        poleRadius = std::abs(static_cast<double>(c[2]));
+    }
+    else if (order == 2)
+    {
+        const double a1 = c[3];
+        const double a2 = c[4];
+        const double discriminant = a1 * a1 - 4.0 * a2;
+
+        if (discriminant < 0.0)
+        {
+            // Complex conjugate poles share the same radius
+            poleRadius = std::sqrt(std::abs(a2));
+        }
+        else
+        {
+            const double root = std::sqrt(discriminant);
+            poleRadius = juce::jmax(std::abs((-a1 + root) * 0.5), std::abs((-a1 - root) * 0.5));
+        }
+    }
+
+    if (poleRadius <= 0.0 || sampleRate <= 0.0)
+        return 0.0;
+
+    // Unstable or extremely slow filters - fall back to a generous fixed tail
+    if (poleRadius >= 0.999999)
+        return 10.0;
+
+    const double decaySamples = std::log(static_cast<double>(silenceThreshold)) / std::log(poleRadius);
+    return decaySamples / sampleRate;
+}
+
+double SilenceDetector::getDecayTimeSeconds(double timeConstantSeconds)
+{
+    return timeConstantSeconds * -std::log(static_cast<double>(silenceThreshold));
+}
+
+template bool SilenceDetector::pushInputBlock(const juce::AudioBuffer<float>&);
+template bool SilenceDetector::pushInputBlock(const juce::AudioBuffer<double>&);
+template void SilenceDetector::pushOutputBlock(const juce::AudioBuffer<float>&);
+template void SilenceDetector::pushOutputBlock(const juce::AudioBuffer<double>&);
+template bool SilenceDetector::isSilent(const juce::AudioBuffer<float>&);
+template bool SilenceDetector::isSilent(const juce::AudioBuffer<double>&);
+template double SilenceDetector::getDecayTimeSeconds(const juce::dsp::IIR::Coefficients<float>&, double);
+template double SilenceDetector::getDecayTimeSeconds(const juce::dsp::IIR::Coefficients<double>&, double);
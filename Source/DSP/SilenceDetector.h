@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+/// Detects digital silence at the input and decides when the whole chain can be skipped.
+///
+/// Processing only stops once the input has been silent for longer than the combined tail
+/// of every stateful stage and the last processed block has decayed below the threshold,
+/// so the frozen filter states are the steady state the chain would have reached anyway.
+class SilenceDetector
+{
+public:
+    /// -120 dBFS
+    static constexpr float silenceThreshold = 0.000001f;
+
+    SilenceDetector() = default;
+    ~SilenceDetector() = default;
+
+    /// Prepare the detector for playback
+    void prepare(double sampleRate);
+
+    /// Forget any silence seen so far
+    void reset();
+
+    /// Set the combined tail of all active stages
+    void setTailLengthSamples(int numSamples) { tailLengthSamples = juce::jmax(0, numSamples); }
+    int getTailLengthSamples() const { return tailLengthSamples; }
+
+    /// Call at the start of each block. Returns true if processing can be skipped
+    /// and the output replaced with zeros.
+    template <typename SampleType>
+    bool pushInputBlock(const juce::AudioBuffer<SampleType>& buffer);
+
+    /// Call with the processed output of every block that was not skipped
+    template <typename SampleType>
+    void pushOutputBlock(const juce::AudioBuffer<SampleType>& buffer);
+
+    /// True while the chain is short-circuited
+    bool isIdle() const { return idle; }
+
+    /// True on the first silent block after audio, when the caller should refresh the tail length
+    bool silenceJustStarted() const { return silentSamples > 0 && silentSamples == lastBlockSize; }
+
+    /// Returns true if every sample in the buffer is below the silence threshold
+    template <typename SampleType>
+    static bool isSilent(const juce::AudioBuffer<SampleType>& buffer);
+
+    /// Time for a biquad's impulse response to decay below the silence threshold
+    template <typename SampleType>
+    static double getDecayTimeSeconds(const juce::dsp::IIR::Coefficients<SampleType>& coefficients, double sampleRate);
+
+    /// Time for a one-pole smoother with the given time constant to decay below the silence threshold
+    static double getDecayTimeSeconds(double timeConstantSeconds);
+
+private:
+    double currentSampleRate = 44100.0;
+    int tailLengthSamples = 0;
+    juce::int64 silentSamples = 0;
+    int lastBlockSize = 0;
+    bool outputSilent = false;
+    bool idle = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SilenceDetector)
+};
@@ -0,0 +1,836 @@
+#include "SpiceEngine.h"
+
+template <typename SampleType>
+SpiceEngine<SampleType>::SpiceEngine()
+    : oversampling(2, 2, Oversampling<SampleType>::filterHalfBandPolyphaseIIR)
+{
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::prepare(const juce::dsp::ProcessSpec& spec, const juce::AudioChannelSet& layout,
+                                      const SpiceParameters& parameters)
+{
+    using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+
+    storedSpec = spec;
+    const auto sampleRate = spec.sampleRate;
+
+    // Choose the kernel variant now rather than in the first audio block (cpuid can trap
+    // to a hypervisor)
+    CpuDispatch::getActive();
+
+    oversampling.prepare(spec);
+
+    auto oversampledSpec = spec;
+    oversampledSpec.sampleRate *= oversampling.getOversamplingFactor();
+
+    saturationProcessor.prepare(oversampledSpec);
+    morphSaturationProcessor.prepare(oversampledSpec);
+    multibandSaturation.prepare(oversampledSpec);
+    filterChain.prepare(oversampledSpec);
+
+    // Prepare cabinet simulator at normal sample rate (post-fx)
+    cabinetSimulator.prepare(spec);
+    morphCabinetSimulator.prepare(spec);
+
+    // Prepare mid-side processor
+    midSideProcessor.prepare(spec);
+    midSideProcessor.setChannelPairs(MidSideProcessor<SampleType>::getChannelPairsForLayout(layout));
+
+    // Loudness meters for the LUFS auto-gain mode
+    const auto loudnessWeights = LoudnessMeter<SampleType>::getChannelWeightsForLayout(layout);
+    inputLoudness.prepare(spec);
+    outputLoudness.prepare(spec);
+    inputLoudness.setChannelWeights(loudnessWeights);
+    outputLoudness.setChannelWeights(loudnessWeights);
+
+    inputGain.prepare(spec);
+    dryWetMixer.prepare(spec);
+    outputGain.prepare(spec);
+
+    // Prepare true-peak limiter
+    limiter.prepare(spec);
+    limiter.setThreshold(SampleType(0));  // 0 dBTP ceiling
+    limiter.setRelease(SampleType(10));   // 10ms release
+
+    // Prepare pre-FX filters, starting at the current cutoffs
+    updatePreFXFilters(parameters);
+    lowCutFilter.prepare(spec);
+    highCutFilter.prepare(spec);
+    noiseGate.prepare(spec);
+
+    // Dry path delay matching the longest possible lookahead latency
+    bypassDelay.setMaximumDelayInSamples(limiter.getLatencySamples() + noiseGate.getMaxLookaheadSamples() + 1);
+    bypassDelay.prepare(spec);
+
+    dcBlocker.prepare(spec);
+
+    dryWetMixer.setMixingRule(juce::dsp::DryWetMixingRule::linear);
+
+    // Initialize DC blocker with high-pass at 5Hz
+    *dcBlocker.state = *Coefficients::makeHighPass(sampleRate, SampleType(5));
+
+    // Scratch buffers for bypass crossfades, morphing and copying graph stages
+    const auto numChannels = static_cast<int>(spec.numChannels);
+    const auto blockSize = static_cast<int>(spec.maximumBlockSize);
+    bypassDryBuffer.setSize(numChannels, blockSize);
+    morphBuffer.setSize(numChannels, blockSize * oversampling.getMaximumRateMultiplier()); // Room for the highest oversampling factor
+    processingGraph.prepare(numChannels, blockSize);
+
+    // Initialize parameter smoothing to avoid clicks - instant response
+    inputGainSmoothed.reset(sampleRate, 0.002);  // 2ms for input gain
+    driveSmoothed.reset(sampleRate, 0.001);   // 1ms for instant response
+    mixSmoothed.reset(sampleRate, 0.001);     // 1ms
+    outputSmoothed.reset(sampleRate, 0.002);  // 2ms for output gain
+    toneSmoothed.reset(sampleRate, 0.001);    // 1ms
+    biasSmoothed.reset(sampleRate, 0.001);    // 1ms
+    bypassSmoothed.reset(sampleRate, 0.002);  // 2ms for bypass - fast response while still avoiding clicks
+    cabinetMixSmoothed.reset(sampleRate, 0.05); // 50ms, matches the DryWetMixer ramp it replaces
+    cabinetMixSmoothed.setCurrentAndTargetValue(parameters.cabinetMix / 100.0f);
+
+    for (size_t band = 0; band < bandDriveSmoothed.size(); ++band)
+    {
+        bandDriveSmoothed[band].reset(sampleRate, 0.001); // 1ms, like the main drive
+        bandDriveSmoothed[band].setCurrentAndTargetValue(parameters.bandDrive[band]);
+    }
+
+    autoGainCompensation.reset(sampleRate, 0.5);  // 500ms for smooth auto-gain adjustments
+
+    // Initialize bypass smoothed value with current parameter state
+    bypassSmoothed.setCurrentAndTargetValue(parameters.bypass ? 1.0f : 0.0f);
+
+    // Initialize RMS windows for auto-gain compensation
+    auto rmsWindowSamples = static_cast<int>(sampleRate * rmsWindowMs / 1000.0f);
+    inputRms.prepare(rmsWindowSamples);
+    outputRms.prepare(rmsWindowSamples);
+    autoGainCompensation.setCurrentAndTargetValue(1.0f);
+
+    compileGraph(parameters);
+    processingGraph.acquire();
+
+    silenceDetector.prepare(sampleRate);
+    updateTailLength(parameters);
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::reset()
+{
+    oversampling.reset();
+    saturationProcessor.reset();
+    morphSaturationProcessor.reset();
+    multibandSaturation.reset();
+    filterChain.reset();
+    cabinetSimulator.reset();
+    morphCabinetSimulator.reset();
+    midSideProcessor.reset();
+    inputLoudness.reset();
+    outputLoudness.reset();
+    inputGain.reset();
+    dryWetMixer.reset();
+    outputGain.reset();
+    limiter.reset();
+    lowCutFilter.reset();
+    highCutFilter.reset();
+    noiseGate.reset();
+    dcBlocker.reset();
+    bypassDelay.reset();
+    silenceDetector.reset();
+}
+
+template <typename SampleType>
+bool SpiceEngine<SampleType>::beginBlock(juce::AudioBuffer<SampleType>& buffer, const SpiceParameters& parameters)
+{
+    // The graph, and with it the latency, only changes between blocks
+    processingGraph.acquire();
+
+    // Short-circuit the whole chain once the input is silent and every tail has rung out
+    if (silenceDetector.pushInputBlock(buffer))
+    {
+        buffer.clear();
+        return false;
+    }
+
+    // Tails depend on the current filter settings, so refresh them when silence begins
+    if (silenceDetector.silenceJustStarted())
+        updateTailLength(parameters);
+
+    return true;
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::process(juce::AudioBuffer<SampleType>& buffer, const SpiceParameters& parameters)
+{
+    // Update bypass smoothing
+    bypassSmoothed.setTargetValue(parameters.bypass ? 1.0f : 0.0f);
+
+    // Check if we're fully bypassed (no ramping needed)
+    bool isFullyBypassed = bypassSmoothed.isSmoothing() == false && bypassSmoothed.getCurrentValue() > 0.5f;
+
+    // With lookahead stages active, the dry path is delayed by the reported latency
+    // so bypassing neither shifts the audio nor breaks host delay compensation
+    const auto latency = getLatencySamples();
+
+    if (latency > 0)
+    {
+        bypassDryBuffer.makeCopyOf(buffer, true);
+        bypassDelay.setDelay(static_cast<SampleType>(latency));
+        juce::dsp::AudioBlock<SampleType> dryBlock(bypassDryBuffer);
+        bypassDelay.process(juce::dsp::ProcessContextReplacing<SampleType>(dryBlock));
+    }
+
+    // If fully bypassed, skip all processing
+    if (isFullyBypassed)
+    {
+        if (latency > 0)
+            buffer.makeCopyOf(bypassDryBuffer, true);
+
+        silenceDetector.pushOutputBlock(buffer);
+        return; // Skip all processing - pure bypass
+    }
+
+    // Keep a copy of the dry input for bypass crossfading (only if ramping)
+    if (bypassSmoothed.isSmoothing() && latency == 0)
+    {
+        bypassDryBuffer.makeCopyOf(buffer, true);
+    }
+
+    // Update pre-FX filter coefficients
+    updatePreFXFilters(parameters);
+
+    int oversamplingFactor = (parameters.quality == 0) ? 1 : (parameters.quality == 1) ? 2 : 4;
+    oversampling.updateQuality(oversamplingFactor);
+
+    // Update smoothed parameters
+    inputGainSmoothed.setTargetValue(parameters.inputGain);
+    driveSmoothed.setTargetValue(parameters.drive);
+    mixSmoothed.setTargetValue(parameters.mix / 100.0f);
+    outputSmoothed.setTargetValue(parameters.output);
+    toneSmoothed.setTargetValue(parameters.tone / 100.0f);
+    biasSmoothed.setTargetValue(parameters.bias / 50.0f); // -1 to 1 range for stronger effect
+    cabinetMixSmoothed.setTargetValue(parameters.cabinetMix / 100.0f);
+
+    for (size_t band = 0; band < bandDriveSmoothed.size(); ++band)
+        bandDriveSmoothed[band].setTargetValue(parameters.bandDrive[band]);
+
+    // Skip to current values immediately for instant response (except bypass)
+    inputGainSmoothed.skip(buffer.getNumSamples());
+    driveSmoothed.skip(buffer.getNumSamples());
+    mixSmoothed.skip(buffer.getNumSamples());
+    outputSmoothed.skip(buffer.getNumSamples());
+    toneSmoothed.skip(buffer.getNumSamples());
+    biasSmoothed.skip(buffer.getNumSamples());
+
+    for (auto& bandDrive : bandDriveSmoothed)
+        bandDrive.skip(buffer.getNumSamples());
+
+    // Don't skip bypass smoothing - we want it to ramp
+
+    // Run the compiled stages
+    blockParameters = &parameters;
+    processingGraph.process(*this, buffer, profiler != nullptr ? profiler->getIfEnabled() : nullptr);
+    blockParameters = nullptr;
+
+    const auto activeTopology = processingGraph.getActiveTopology();
+
+    if ((activeTopology & gateStageFlag) == 0)
+        gatePrimed = false;
+
+    if ((activeTopology & limiterStageFlag) == 0)
+        limiterPrimed = false;
+
+    // Apply smooth bypass crossfade only if we're ramping
+    if (bypassSmoothed.isSmoothing())
+    {
+        auto numSamples = buffer.getNumSamples();
+        auto numChannels = buffer.getNumChannels();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* wetData = buffer.getWritePointer(channel);
+            auto* dryData = bypassDryBuffer.getReadPointer(channel);
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                auto bypassAmount = bypassSmoothed.getNextValue();
+                auto wetAmount = 1.0f - bypassAmount;
+
+                // Crossfade between wet (processed) and dry (bypass) signals
+                wetData[sample] = wetData[sample] * wetAmount + dryData[sample] * bypassAmount;
+            }
+        }
+    }
+
+    silenceDetector.pushOutputBlock(buffer);
+}
+
+//==============================================================================
+template <typename SampleType>
+void SpiceEngine<SampleType>::updateTailLength(const SpiceParameters& parameters)
+{
+    auto sampleRate = storedSpec.sampleRate;
+
+    if (sampleRate <= 0.0)
+        return;
+
+    auto topology = getTopology(parameters);
+
+    // Stages run in series, so their decay times add up
+    double tail = SilenceDetector::getDecayTimeSeconds(*dcBlocker.state, sampleRate);
+
+    if (topology & lowCutStageFlag)
+        tail += lowCutFilter.getTailLengthSeconds();
+
+    if (topology & highCutStageFlag)
+        tail += highCutFilter.getTailLengthSeconds();
+
+    if (topology & gateStageFlag)
+        tail += (getGateLookaheadSamples(parameters) + parameters.gateHold * 0.001 * sampleRate) / sampleRate
+              + SilenceDetector::getDecayTimeSeconds(0.05); // Lookahead, hold and envelope release
+
+    tail += oversampling.getTailLengthSamples() / sampleRate;
+    tail += filterChain.getTailLengthSeconds();
+
+    if (topology & multibandStageFlag)
+        tail += multibandSaturation.getTailLengthSeconds();
+
+    if (topology & cabinetStageFlag)
+        tail += cabinetSimulator.getTailLengthSeconds();
+
+    if (topology & limiterStageFlag)
+        tail += limiter.getLatencySamples() / sampleRate
+              + SilenceDetector::getDecayTimeSeconds(0.01); // Lookahead plus release
+
+    tailLengthSeconds.store(tail);
+    silenceDetector.setTailLengthSamples(static_cast<int>(std::ceil(tail * sampleRate)));
+}
+
+//==============================================================================
+template <typename SampleType>
+juce::uint32 SpiceEngine<SampleType>::getTopology(const SpiceParameters& parameters)
+{
+    juce::uint32 topology = 0;
+
+    if (parameters.lowCut > 20.0f)          topology |= lowCutStageFlag;
+    if (parameters.highCut < 20000.0f)      topology |= highCutStageFlag;
+    if (parameters.gateEnabled)             topology |= gateStageFlag;
+    if (parameters.autoGain)                topology |= autoGainStageFlag;
+    if (parameters.midSideEnabled)          topology |= midSideStageFlag;
+    if (parameters.cabinetEnabled)          topology |= cabinetStageFlag;
+    if (parameters.limiterEnabled)          topology |= limiterStageFlag;
+    if (parameters.multibandEnabled)        topology |= multibandStageFlag;
+
+    return topology;
+}
+
+template <typename SampleType>
+int SpiceEngine<SampleType>::getGateLookaheadSamples(const SpiceParameters& parameters) const
+{
+    return juce::roundToInt(parameters.gateLookahead * 0.001 * storedSpec.sampleRate);
+}
+
+template <typename SampleType>
+int SpiceEngine<SampleType>::calculateLatencySamples(const SpiceParameters& parameters) const
+{
+    const auto topology = getTopology(parameters);
+    int latency = 0;
+
+    if (topology & gateStageFlag)
+        latency += getGateLookaheadSamples(parameters);
+
+    if (topology & limiterStageFlag)
+        latency += limiter.getLatencySamples();
+
+    return latency;
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::compileGraph(const SpiceParameters& parameters)
+{
+    const auto topology = getTopology(parameters);
+    const auto latency = calculateLatencySamples(parameters);
+
+    processingGraph.compile(topology, [topology, latency](typename Graph::Builder& graph)
+    {
+        using Access = typename Graph::BufferAccess;
+        using Self = SpiceEngine;
+
+        // Pre-FX
+        if (topology & lowCutStageFlag)
+            graph.addStage("Low Cut", &Self::processLowCutStage);
+
+        if (topology & highCutStageFlag)
+            graph.addStage("High Cut", &Self::processHighCutStage);
+
+        if (topology & gateStageFlag)
+            graph.addStage("Noise Gate", &Self::processNoiseGateStage);
+
+        // Saturation core
+        graph.addStage("Dry Signal", &Self::processDrySignalStage, Access::readOnly);
+
+        // Input gain is a scalar, so it folds into the mid-side encode matrix unless the
+        // auto-gain tap has to observe the signal in between
+        if ((topology & midSideStageFlag) && !(topology & autoGainStageFlag))
+        {
+            graph.addStage("Input Gain + Mid-Side Encode", &Self::processInputGainMidSideEncodeStage);
+        }
+        else
+        {
+            graph.addStage("Input Gain", &Self::processInputGainStage);
+
+            if (topology & autoGainStageFlag)
+                graph.addStage("Auto Gain Input", &Self::processAutoGainInputStage, Access::readOnly);
+
+            if (topology & midSideStageFlag)
+                graph.addStage("Mid-Side Encode", &Self::processMidSideEncodeStage);
+        }
+
+        if (topology & multibandStageFlag)
+            graph.addStage("Multiband Saturation", &Self::processMultibandSaturationStage);
+        else
+            graph.addStage("Saturation", &Self::processSaturationStage);
+
+        // Back to stereo before the dry signal is mixed in, so everything after the
+        // saturation (cabinet, output gain, limiter) sees left/right again
+        if (topology & midSideStageFlag)
+            graph.addStage("Mid-Side Decode", &Self::processMidSideDecodeStage);
+
+        graph.addStage("Dry/Wet", &Self::processDryWetStage);
+
+        // Post-FX
+        if (topology & cabinetStageFlag)
+            graph.addStage("Cabinet", &Self::processCabinetStage, Access::needsCopy);
+
+        graph.addStage("Output Gain", &Self::processOutputGainStage);
+
+        if (topology & limiterStageFlag)
+            graph.addStage("Limiter", &Self::processLimiterStage);
+
+        graph.addStage("DC Blocker", &Self::processDCBlockerStage);
+
+        graph.setLatencySamples(latency);
+    });
+}
+
+//==============================================================================
+template <typename SampleType>
+void SpiceEngine<SampleType>::processLowCutStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    lowCutFilter.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processHighCutStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    highCutFilter.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processNoiseGateStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    const auto& parameters = *blockParameters;
+
+    if (!gatePrimed)
+    {
+        noiseGate.reset();
+        gatePrimed = true;
+    }
+
+    // Coefficients are only recomputed when a setting actually changes
+    noiseGate.setThreshold(parameters.gateThreshold);
+    noiseGate.setHysteresis(parameters.gateHysteresis);
+    noiseGate.setHoldTime(parameters.gateHold);
+
+    // The lookahead the graph was compiled with, so the gate delays by exactly the
+    // latency reported for it
+    auto lookahead = processingGraph.getActiveLatencySamples();
+
+    if (processingGraph.getActiveTopology() & limiterStageFlag)
+        lookahead -= limiter.getLatencySamples();
+
+    noiseGate.setLookaheadSamples(lookahead);
+
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    noiseGate.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+
+    // Publish the LED state once per block
+    gateInputLevel.store(noiseGate.getBlockInputLevel());
+    gateOpen.store(noiseGate.isOpen());
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processDrySignalStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    // Store dry signal for the saturation mix
+    dryWetMixer.pushDrySamples(juce::dsp::AudioBlock<SampleType>(buffer));
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processInputGainStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    inputGain.setGainDecibels(inputGainSmoothed.getCurrentValue());
+    inputGain.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processAutoGainInputStage(juce::AudioBuffer<SampleType>&, const juce::AudioBuffer<SampleType>& stageInput)
+{
+    if (blockParameters->autoGainMode == 1)
+    {
+        // Start from fresh windows so loudness from an earlier session is not compared
+        if (!loudnessMetersActive)
+        {
+            inputLoudness.reset();
+            outputLoudness.reset();
+            loudnessMetersActive = true;
+        }
+
+        inputLoudness.pushBlock(stageInput);
+        return;
+    }
+
+    // Measure the post-input-gain level in place instead of keeping a copy of the block
+    double sum = 0.0;
+
+    for (int channel = 0; channel < stageInput.getNumChannels(); ++channel)
+        sum += CpuDispatch::sumOfSquares(stageInput.getReadPointer(channel), stageInput.getNumSamples());
+
+    autoGainInputSumOfSquares = sum;
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processMidSideEncodeStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+
+    // Encode, mid/side gains and width in one pass over every channel pair
+    midSideProcessor.applyMatrix(block, getMidSideEncodeMatrix());
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processInputGainMidSideEncodeStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+
+    const auto gain = juce::Decibels::decibelsToGain(static_cast<SampleType>(inputGainSmoothed.getCurrentValue()));
+    const auto matrix = getMidSideEncodeMatrix().scaled(gain);
+
+    midSideProcessor.applyMatrix(block, matrix);
+
+    // Channels outside every pair still need the input gain
+    const auto numChannels = buffer.getNumChannels();
+    std::array<bool, maxChannels> paired {};
+
+    for (int pair = 0; pair < midSideProcessor.getNumChannelPairs(); ++pair)
+    {
+        const auto& channels = midSideProcessor.getChannelPair(pair);
+
+        if (channels.first < numChannels && channels.second < numChannels)
+        {
+            paired[static_cast<size_t>(channels.first)] = true;
+            paired[static_cast<size_t>(channels.second)] = true;
+        }
+    }
+
+    for (int channel = 0; channel < juce::jmin(numChannels, maxChannels); ++channel)
+        if (!paired[static_cast<size_t>(channel)])
+            juce::FloatVectorOperations::multiply(buffer.getWritePointer(channel), gain, buffer.getNumSamples());
+}
+
+template <typename SampleType>
+typename MidSideProcessor<SampleType>::Matrix SpiceEngine<SampleType>::getMidSideEncodeMatrix()
+{
+    const auto& parameters = *blockParameters;
+
+    midSideProcessor.setMidGain(static_cast<SampleType>(juce::Decibels::decibelsToGain(parameters.midGain)));
+    midSideProcessor.setSideGain(static_cast<SampleType>(juce::Decibels::decibelsToGain(parameters.sideGain)));
+    midSideProcessor.setStereoWidth(static_cast<SampleType>(parameters.stereoWidth / 100.0f)); // Convert from 0-300% to 0-3
+
+    return midSideProcessor.getEncodeMatrix();
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processSaturationStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    using Model = typename SaturationProcessor<SampleType>::Model;
+    const auto& parameters = *blockParameters;
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+
+    // Update processors with current smoothed values
+    saturationProcessor.setDrive(driveSmoothed.getCurrentValue());
+    saturationProcessor.setModel(static_cast<Model>(parameters.model));
+    saturationProcessor.setBias(biasSmoothed.getCurrentValue());
+    filterChain.setTone(toneSmoothed.getCurrentValue());
+
+    // Process with oversampling
+    auto oversampledBlock = oversampling.processSamplesUp(block);
+    juce::dsp::ProcessContextReplacing<SampleType> oversampledContext(oversampledBlock);
+
+    const auto& modelBlend = parameters.modelBlend;
+
+    if (modelBlend.isActive())
+    {
+        // Morphing between two models: a second engine runs the other model on a copy
+        // and the two outputs are crossfaded
+        auto morphBlock = juce::dsp::AudioBlock<SampleType>(morphBuffer)
+                              .getSubsetChannelBlock(0, oversampledBlock.getNumChannels())
+                              .getSubBlock(0, oversampledBlock.getNumSamples());
+        morphBlock.copyFrom(oversampledBlock);
+
+        saturationProcessor.setModel(static_cast<Model>(modelBlend.from));
+        morphSaturationProcessor.setModel(static_cast<Model>(modelBlend.to));
+        morphSaturationProcessor.setDrive(driveSmoothed.getCurrentValue());
+        morphSaturationProcessor.setBias(biasSmoothed.getCurrentValue());
+
+        saturationProcessor.process(oversampledContext);
+        morphSaturationProcessor.process(juce::dsp::ProcessContextReplacing<SampleType>(morphBlock));
+
+        oversampledBlock.multiplyBy(static_cast<SampleType>(1.0f - modelBlend.weight));
+        oversampledBlock.addProductOf(morphBlock, static_cast<SampleType>(modelBlend.weight));
+    }
+    else
+    {
+        saturationProcessor.process(oversampledContext);
+    }
+
+    filterChain.process(oversampledContext);
+    oversampling.processSamplesDown(block);
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processMultibandSaturationStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    using Saturation = SaturationProcessor<SampleType>;
+    using Multiband = MultibandSaturation<SampleType>;
+
+    const auto& parameters = *blockParameters;
+    auto& multiband = multibandSaturation;
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+
+    // Crossovers follow the oversampled rate, coefficients only change when a value does
+    multiband.setSampleRate(storedSpec.sampleRate * oversampling.getRateMultiplier());
+    multiband.setCrossoverFrequencies(parameters.lowMidCrossover, parameters.midHighCrossover);
+
+    for (int band = 0; band < Multiband::numBands; ++band)
+    {
+        auto& saturation = multiband.getBand(static_cast<typename Multiband::Band>(band));
+        saturation.setDrive(static_cast<SampleType>(bandDriveSmoothed[static_cast<size_t>(band)].getCurrentValue()));
+        saturation.setModel(static_cast<typename Saturation::Model>(parameters.bandModel[static_cast<size_t>(band)]));
+        saturation.setBias(biasSmoothed.getCurrentValue());
+    }
+
+    filterChain.setTone(toneSmoothed.getCurrentValue());
+
+    // One oversampler shared by all bands
+    auto oversampledBlock = oversampling.processSamplesUp(block);
+    juce::dsp::ProcessContextReplacing<SampleType> oversampledContext(oversampledBlock);
+    multiband.process(oversampledContext);
+    filterChain.process(oversampledContext);
+    oversampling.processSamplesDown(block);
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processDryWetStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    dryWetMixer.setWetMixProportion(mixSmoothed.getCurrentValue());
+    dryWetMixer.mixWetSamples(block);
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processCabinetStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput)
+{
+    using Cabinet = CabinetSimulator<SampleType>;
+    const auto& parameters = *blockParameters;
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+
+    auto cabinetModel = static_cast<typename Cabinet::CabinetModel>(parameters.cabinetModel);
+    auto cabinetPresence = parameters.cabinetPresence / 100.0f; // Convert to 0-1 range
+
+    const auto& cabinetBlend = parameters.cabinetModelBlend;
+
+    if (cabinetBlend.isActive())
+        cabinetModel = static_cast<typename Cabinet::CabinetModel>(cabinetBlend.from);
+
+    cabinetSimulator.setCabinetModel(cabinetModel);
+    cabinetSimulator.setPresence(cabinetPresence);
+    cabinetSimulator.setResonance(0.5f); // Fixed resonance for simplicity
+    cabinetSimulator.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+
+    if (cabinetBlend.isActive())
+    {
+        // Morphing between two cabinets: the second engine runs the other model on the
+        // stage input and the two outputs are crossfaded
+        auto morphBlock = juce::dsp::AudioBlock<SampleType>(morphBuffer)
+                              .getSubsetChannelBlock(0, block.getNumChannels())
+                              .getSubBlock(0, block.getNumSamples());
+        morphBlock.copyFrom(stageInput);
+
+        morphCabinetSimulator.setCabinetModel(static_cast<typename Cabinet::CabinetModel>(cabinetBlend.to));
+        morphCabinetSimulator.setPresence(cabinetPresence);
+        morphCabinetSimulator.setResonance(0.5f);
+        morphCabinetSimulator.process(juce::dsp::ProcessContextReplacing<SampleType>(morphBlock));
+
+        block.multiplyBy(static_cast<SampleType>(1.0f - cabinetBlend.weight));
+        block.addProductOf(morphBlock, static_cast<SampleType>(cabinetBlend.weight));
+    }
+
+    // Mix the cabinet output with the graph's copy of the stage input
+    auto numChannels = buffer.getNumChannels();
+    auto numSamples = buffer.getNumSamples();
+
+    if (cabinetMixSmoothed.isSmoothing())
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            auto wetAmount = static_cast<SampleType>(cabinetMixSmoothed.getNextValue());
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* wetData = buffer.getWritePointer(channel);
+                auto dry = stageInput.getSample(channel, sample);
+                wetData[sample] = dry + (wetData[sample] - dry) * wetAmount;
+            }
+        }
+    }
+    else
+    {
+        auto wetAmount = static_cast<SampleType>(cabinetMixSmoothed.getCurrentValue());
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* wetData = buffer.getWritePointer(channel);
+            juce::FloatVectorOperations::multiply(wetData, wetAmount, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(wetData, stageInput.getReadPointer(channel), SampleType(1) - wetAmount, numSamples);
+        }
+    }
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processOutputGainStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    const auto& parameters = *blockParameters;
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+
+    // Apply output gain with auto-gain compensation if enabled
+    float outputGainDb = outputSmoothed.getCurrentValue();
+    const bool loudnessMode = parameters.autoGainMode == 1;
+
+    if (!parameters.autoGain || !loudnessMode)
+        loudnessMetersActive = false;
+
+    if (parameters.autoGain)
+    {
+        // Update auto-gain compensation based on pre/post processing levels
+        if (loudnessMode)
+            updateLoudnessCompensation(buffer);
+        else
+            updateAutoGainCompensation(autoGainInputSumOfSquares, buffer);
+
+        // Apply compensation (convert linear gain to dB and add to output gain)
+        float compensationDb = juce::Decibels::gainToDecibels(autoGainCompensation.getNextValue());
+        outputGainDb += compensationDb;
+    }
+
+    outputGain.setGainDecibels(static_cast<SampleType>(outputGainDb));
+    outputGain.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processLimiterStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    if (!limiterPrimed)
+    {
+        limiter.reset();
+        limiterPrimed = true;
+    }
+
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    limiter.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processMidSideDecodeStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    // Convert back from mid-side to stereo
+    midSideProcessor.processMidSideToStereo(buffer);
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::processDCBlockerStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>&)
+{
+    // Apply DC blocking filter to remove any DC offset
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    dcBlocker.process(juce::dsp::ProcessContextReplacing<SampleType>(block));
+}
+
+//==============================================================================
+template <typename SampleType>
+void SpiceEngine<SampleType>::updatePreFXFilters(const SpiceParameters& parameters)
+{
+    // Cheap when nothing moved: the filters only redesign on a changed cutoff or slope
+    lowCutFilter.setCutoffFrequency(parameters.lowCut);
+    lowCutFilter.setSlope(static_cast<typename CutFilter<SampleType>::Slope>(parameters.lowCutSlope));
+
+    highCutFilter.setCutoffFrequency(parameters.highCut);
+    highCutFilter.setSlope(static_cast<typename CutFilter<SampleType>::Slope>(parameters.highCutSlope));
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::updateAutoGainCompensation(double inputSumOfSquares,
+                                                         const juce::AudioBuffer<SampleType>& outputBuffer)
+{
+    int numSamples = outputBuffer.getNumSamples();
+    int numChannels = outputBuffer.getNumChannels();
+
+    if (numSamples == 0 || numChannels == 0)
+        return;
+
+    // Calculate sum of squares for this block
+    double outputSum = 0.0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        outputSum += CpuDispatch::sumOfSquares(outputBuffer.getReadPointer(channel), numSamples);
+
+    // One entry per block, averaged across channels
+    inputRms.pushBlock(inputSumOfSquares / numChannels, numSamples);
+    outputRms.pushBlock(outputSum / numChannels, numSamples);
+
+    // Calculate RMS values
+    inputRmsLevel = inputRms.getRMS();
+    outputRmsLevel = outputRms.getRMS();
+
+    // Calculate gain compensation
+    if (outputRmsLevel > 0.0001f && inputRmsLevel > 0.0001f) // Avoid division by zero
+    {
+        float targetGain = inputRmsLevel / outputRmsLevel;
+
+        // Limit compensation range to ±12dB
+        targetGain = juce::jlimit(0.25f, 4.0f, targetGain);
+
+        // Smooth the compensation
+        autoGainCompensation.setTargetValue(targetGain);
+    }
+}
+
+template <typename SampleType>
+void SpiceEngine<SampleType>::updateLoudnessCompensation(const juce::AudioBuffer<SampleType>& outputBuffer)
+{
+    outputLoudness.pushBlock(outputBuffer);
+
+    // Hold the current compensation through pauses and decays
+    if (!loudnessMetersActive || inputLoudness.isGated() || outputLoudness.isGated())
+        return;
+
+    auto differenceDb = inputLoudness.getShortTermLoudness() - outputLoudness.getShortTermLoudness();
+    auto targetGain = juce::Decibels::decibelsToGain(static_cast<float>(differenceDb));
+
+    // Limit compensation range to ±12dB
+    autoGainCompensation.setTargetValue(juce::jlimit(0.25f, 4.0f, targetGain));
+}
+
+//==============================================================================
+template class SpiceEngine<float>;
+template class SpiceEngine<double>;
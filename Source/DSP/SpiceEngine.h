@@ -0,0 +1,279 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include "SaturationProcessor.h"
+#include "MultibandSaturation.h"
+#include "Oversampling.h"
+#include "FilterChain.h"
+#include "CabinetSimulator.h"
+#include "MidSideProcessor.h"
+#include "ChannelLaneFilter.h"
+#include "CutFilter.h"
+#include "TruePeakLimiter.h"
+#include "NoiseGate.h"
+#include "ProcessingGraph.h"
+#include "SilenceDetector.h"
+#include "RunningRMS.h"
+#include "LoudnessMeter.h"
+#include "StageProfiler.h"
+#include "CpuDispatch.h"
+
+/// Values the engine reads each block, in the units of the plugin parameters
+/// (dB, percent, Hz, ms and choice indices). The defaults match the plugin's.
+struct SpiceParameters
+{
+    /// Two values of a choice parameter and how far a morph has moved between them
+    struct Blend
+    {
+        int from = 0;
+        int to = 0;
+        float weight = 0.0f;    // 0 = from only, 1 = to only
+
+        bool isActive() const { return from != to && weight > 0.0f && weight < 1.0f; }
+    };
+
+    float inputGain = 0.0f;
+    float drive = 30.0f;
+    float mix = 100.0f;
+    float output = 0.0f;
+    int model = 0;
+    float tone = 50.0f;
+    float bias = 0.0f;
+    int quality = 1;
+    bool bypass = false;
+
+    float lowCut = 20.0f;
+    float highCut = 20000.0f;
+    int lowCutSlope = 0;
+    int highCutSlope = 0;
+
+    bool gateEnabled = false;
+    float gateThreshold = -40.0f;
+    float gateHysteresis = 0.0f;
+    float gateHold = 0.0f;
+    float gateLookahead = 0.0f;
+
+    bool cabinetEnabled = false;
+    int cabinetModel = 0;
+    float cabinetPresence = 30.0f;
+    float cabinetMix = 100.0f;
+
+    bool limiterEnabled = false;
+
+    bool midSideEnabled = false;
+    float midGain = 0.0f;
+    float sideGain = 0.0f;
+    float stereoWidth = 100.0f;
+
+    bool autoGain = false;
+    int autoGainMode = 0;
+
+    bool multibandEnabled = false;
+    float lowMidCrossover = 200.0f;
+    float midHighCrossover = 3000.0f;
+    std::array<float, 3> bandDrive { 30.0f, 30.0f, 30.0f };
+    std::array<int, 3> bandModel {};
+
+    // Choice parameters crossfaded with a second engine while a preset morph moves between them
+    Blend modelBlend;
+    Blend cabinetModelBlend;
+};
+
+/// The complete Spice signal chain without any plugin, parameter or GUI code.
+///
+/// The plugin wraps one engine per sample precision; offline tools, tests and benchmarks
+/// drive it directly with a SpiceParameters value. Enabled stages are compiled into a
+/// ProcessingGraph off the audio thread, so a changed stage configuration must be passed
+/// to compileGraph() before beginBlock() picks it up.
+template <typename SampleType>
+class SpiceEngine
+{
+public:
+    /// Widest bus the engine handles (9.1.6)
+    static constexpr int maxChannels = 16;
+
+    enum GraphStageFlags : juce::uint32
+    {
+        lowCutStageFlag     = 1 << 0,
+        highCutStageFlag    = 1 << 1,
+        gateStageFlag       = 1 << 2,
+        autoGainStageFlag   = 1 << 3,
+        midSideStageFlag    = 1 << 4,
+        cabinetStageFlag    = 1 << 5,
+        limiterStageFlag    = 1 << 6,
+        multibandStageFlag  = 1 << 7
+    };
+
+    SpiceEngine();
+
+    /// Allocate everything for playback and compile the graph for the given parameters.
+    /// The layout decides which channels form mid/side pairs and the loudness weights.
+    void prepare(const juce::dsp::ProcessSpec& spec, const juce::AudioChannelSet& layout,
+                 const SpiceParameters& parameters);
+    void reset();
+
+    /// Start a block (audio thread), taking the most recently compiled graph. Returns false
+    /// if the input and every stage tail are silent; the buffer has then been cleared and
+    /// process() must not be called for it.
+    bool beginBlock(juce::AudioBuffer<SampleType>& buffer, const SpiceParameters& parameters);
+
+    /// Run the chain, including the bypass crossfade, on a block accepted by beginBlock()
+    void process(juce::AudioBuffer<SampleType>& buffer, const SpiceParameters& parameters);
+
+    /// beginBlock() and process() in one call
+    void processBlock(juce::AudioBuffer<SampleType>& buffer, const SpiceParameters& parameters)
+    {
+        if (beginBlock(buffer, parameters))
+            process(buffer, parameters);
+    }
+
+    /// Stages the parameters switch on, as GraphStageFlags
+    static juce::uint32 getTopology(const SpiceParameters& parameters);
+
+    /// Compile and publish the graph for the parameters' stages. Must not be called
+    /// from the audio thread.
+    void compileGraph(const SpiceParameters& parameters);
+    juce::uint32 getPublishedTopology() const { return processingGraph.getPublishedTopology(); }
+
+    /// Lookahead delay of the graph the audio thread is running
+    int getLatencySamples() const { return processingGraph.getActiveLatencySamples(); }
+
+    /// Lookahead delay of the most recently compiled graph
+    int getPublishedLatencySamples() const { return processingGraph.getPublishedLatencySamples(); }
+
+    /// Lookahead delay the graph for these parameters would have
+    int calculateLatencySamples(const SpiceParameters& parameters) const;
+
+    /// True if the most recently compiled graph has other stages or another latency than
+    /// these parameters need. Lock-free, so the audio thread can ask for a compile with it.
+    bool isGraphOutdated(const SpiceParameters& parameters) const
+    {
+        return getTopology(parameters) != getPublishedTopology()
+            || calculateLatencySamples(parameters) != getPublishedLatencySamples();
+    }
+
+    /// Combined decay time of the active stages, refreshed whenever silence begins
+    double getTailLengthSeconds() const { return tailLengthSeconds.load(); }
+
+    /// Time the graph stages with this profiler while it is enabled. Pass nullptr to
+    /// detach; must not be changed while the audio thread is processing.
+    void setProfiler(StageProfiler* newProfiler) { profiler = newProfiler; }
+
+    // Noise gate state published once per block
+    float getGateInputLevel() const { return gateInputLevel.load(); }
+    bool isGateOpen() const { return gateOpen.load(); }
+
+private:
+    using Filter = ChannelLaneFilter<SampleType>;
+    using Graph = ProcessingGraph<SpiceEngine, SampleType>;
+
+    void updatePreFXFilters(const SpiceParameters& parameters);
+    void updateTailLength(const SpiceParameters& parameters);
+    int getGateLookaheadSamples(const SpiceParameters& parameters) const;
+    void updateAutoGainCompensation(double inputSumOfSquares, const juce::AudioBuffer<SampleType>& outputBuffer);
+    void updateLoudnessCompensation(const juce::AudioBuffer<SampleType>& outputBuffer);
+
+    /// Mid-side encode matrix for the current mid/side gain and width parameters
+    typename MidSideProcessor<SampleType>::Matrix getMidSideEncodeMatrix();
+
+    // Graph stages
+    void processLowCutStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processHighCutStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processNoiseGateStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processDrySignalStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processInputGainStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processAutoGainInputStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processMidSideEncodeStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processInputGainMidSideEncodeStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processSaturationStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processMultibandSaturationStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processDryWetStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processCabinetStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processOutputGainStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processLimiterStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processMidSideDecodeStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+    void processDCBlockerStage(juce::AudioBuffer<SampleType>& buffer, const juce::AudioBuffer<SampleType>& stageInput);
+
+    SaturationProcessor<SampleType> saturationProcessor;
+    SaturationProcessor<SampleType> morphSaturationProcessor;
+    MultibandSaturation<SampleType> multibandSaturation;
+    Oversampling<SampleType> oversampling;
+    FilterChain<SampleType> filterChain;
+    CabinetSimulator<SampleType> cabinetSimulator;
+    CabinetSimulator<SampleType> morphCabinetSimulator;
+    MidSideProcessor<SampleType> midSideProcessor;
+
+    juce::dsp::Gain<SampleType> inputGain;
+    juce::dsp::DryWetMixer<SampleType> dryWetMixer;
+    juce::dsp::Gain<SampleType> outputGain;
+    TruePeakLimiter<SampleType> limiter;
+
+    // Pre-FX filters
+    CutFilter<SampleType> lowCutFilter { CutFilter<SampleType>::Type::highPass };
+    CutFilter<SampleType> highCutFilter { CutFilter<SampleType>::Type::lowPass };
+    NoiseGate<SampleType> noiseGate;
+
+    // DC blocking filter
+    Filter dcBlocker;
+
+    // Processing graph - enabled stages are compiled into a flat callback list
+    Graph processingGraph;
+
+    // K-weighted loudness before and after processing for the LUFS auto-gain mode
+    LoudnessMeter<SampleType> inputLoudness;
+    LoudnessMeter<SampleType> outputLoudness;
+    bool loudnessMetersActive = false;
+
+    // False while the gate/limiter stages are out of the graph, so stale
+    // lookahead audio is flushed when they come back
+    bool gatePrimed = false;
+    bool limiterPrimed = false;
+
+    // Delays the bypass signal by the reported latency
+    juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::None> bypassDelay;
+
+    // Scratch buffers allocated in prepare()
+    juce::AudioBuffer<SampleType> bypassDryBuffer;
+    juce::AudioBuffer<SampleType> morphBuffer;
+
+    // Silence detection - the chain is skipped once every stage tail has decayed
+    SilenceDetector silenceDetector;
+    std::atomic<double> tailLengthSeconds {0.0};
+
+    // Noise gate state published for the LED
+    std::atomic<float> gateInputLevel {0.0f};
+    std::atomic<bool> gateOpen {false};
+
+    // Optional per-stage timing
+    StageProfiler* profiler = nullptr;
+
+    // Parameters of the block being processed, read by the graph stages
+    const SpiceParameters* blockParameters = nullptr;
+
+    // Parameter smoothing
+    juce::SmoothedValue<float> inputGainSmoothed;
+    juce::SmoothedValue<float> driveSmoothed;
+    juce::SmoothedValue<float> mixSmoothed;
+    juce::SmoothedValue<float> outputSmoothed;
+    juce::SmoothedValue<float> toneSmoothed;
+    juce::SmoothedValue<float> biasSmoothed;
+    juce::SmoothedValue<float> bypassSmoothed;
+    juce::SmoothedValue<float> cabinetMixSmoothed;
+    std::array<juce::SmoothedValue<float>, MultibandSaturation<SampleType>::numBands> bandDriveSmoothed;
+
+    // Auto-gain compensation
+    juce::SmoothedValue<float> autoGainCompensation;
+    double autoGainInputSumOfSquares = 0.0;
+    float inputRmsLevel = 0.0f;
+    float outputRmsLevel = 0.0f;
+    static constexpr float rmsWindowMs = 300.0f; // 300ms RMS window
+    RunningRMS inputRms;
+    RunningRMS outputRms;
+
+    // Stored spec for dynamic quality updates
+    juce::dsp::ProcessSpec storedSpec {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpiceEngine)
+};
@@ -0,0 +1,157 @@
+#include "StageProfiler.h"
+#include <algorithm>
+#include <cstring>
+
+StageProfiler::StageProfiler()
+    : ring(static_cast<size_t>(ringSize))
+{
+    histories.reserve(32);
+    sortScratch.reserve(historySize);
+}
+
+void StageProfiler::setEnabled(bool shouldBeEnabled)
+{
+    const juce::ScopedLock sl(readLock);
+
+    if (shouldBeEnabled == isEnabled())
+        return;
+
+    if (shouldBeEnabled)
+    {
+        // Discard whatever was still in flight when profiling last stopped
+        drainRing();
+        histories.clear();
+        droppedRecords.store(0);
+
+        referenceCycles = readCycleCounter();
+        referenceTicks = juce::Time::getHighResolutionTicks();
+    }
+
+    enabled.store(shouldBeEnabled);
+}
+
+void StageProfiler::pushRecord(const char* stageName, juce::uint64 cycles, int numSamples) noexcept
+{
+    const auto scope = fifo.write(1);
+
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring[static_cast<size_t>(scope.startIndex1)] = { stageName, cycles, numSamples };
+}
+
+void StageProfiler::drainRing()
+{
+    const auto scope = fifo.read(fifo.getNumReady());
+    const auto now = juce::Time::getMillisecondCounter();
+
+    auto addRecords = [this, now](int start, int count)
+    {
+        for (int i = start; i < start + count; ++i)
+        {
+            const auto& record = ring[static_cast<size_t>(i)];
+            auto& history = findHistory(record.name);
+
+            history.cycles[static_cast<size_t>(history.writePosition)] = record.cycles;
+            history.numSamples[static_cast<size_t>(history.writePosition)] = record.numSamples;
+            history.writePosition = (history.writePosition + 1) % historySize;
+            history.numEntries = juce::jmin(history.numEntries + 1, historySize);
+            history.lastSeenMs = now;
+        }
+    };
+
+    addRecords(scope.startIndex1, scope.blockSize1);
+    addRecords(scope.startIndex2, scope.blockSize2);
+}
+
+StageProfiler::History& StageProfiler::findHistory(const char* stageName)
+{
+    // Stage names are string literals, so the pointer usually matches; the same
+    // literal can still have different addresses in different translation units
+    for (auto& history : histories)
+        if (history.name == stageName)
+            return history;
+
+    for (auto& history : histories)
+        if (std::strcmp(history.name, stageName) == 0)
+            return history;
+
+    History history;
+    history.name = stageName;
+    history.cycles.resize(static_cast<size_t>(historySize));
+    history.numSamples.resize(static_cast<size_t>(historySize));
+    histories.push_back(std::move(history));
+    return histories.back();
+}
+
+double StageProfiler::getCyclesPerSecond() const
+{
+    const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - referenceTicks);
+    const auto elapsedCycles = static_cast<double>(readCycleCounter() - referenceCycles);
+
+    // Too early for a stable ratio; nothing meaningful has been recorded yet either
+    if (elapsedSeconds < 0.01 || elapsedCycles <= 0.0)
+        return 0.0;
+
+    return elapsedCycles / elapsedSeconds;
+}
+
+std::vector<StageProfiler::Statistics> StageProfiler::getStatistics()
+{
+    const juce::ScopedLock sl(readLock);
+
+    std::vector<Statistics> result;
+
+    if (! isEnabled())
+        return result;
+
+    drainRing();
+
+    const auto cyclesPerSecond = getCyclesPerSecond();
+
+    if (cyclesPerSecond <= 0.0)
+        return result;
+
+    const auto microsecondsPerCycle = 1.0e6 / cyclesPerSecond;
+    const auto sampleRate = currentSampleRate.load();
+    const auto now = juce::Time::getMillisecondCounter();
+
+    for (const auto& history : histories)
+    {
+        // Stages taken out of the graph stop reporting rather than showing stale figures
+        if (history.numEntries == 0 || now - history.lastSeenMs > staleTimeoutMs)
+            continue;
+
+        sortScratch.assign(history.cycles.begin(), history.cycles.begin() + history.numEntries);
+
+        juce::uint64 sum = 0;
+        double loadSum = 0.0;
+
+        for (int i = 0; i < history.numEntries; ++i)
+        {
+            const auto cycles = history.cycles[static_cast<size_t>(i)];
+            const auto blockSeconds = history.numSamples[static_cast<size_t>(i)] / sampleRate;
+            sum += cycles;
+
+            if (blockSeconds > 0.0)
+                loadSum += static_cast<double>(cycles) / cyclesPerSecond / blockSeconds;
+        }
+
+        const auto p99Index = static_cast<size_t>(juce::jmax(0, (history.numEntries * 99 + 99) / 100 - 1));
+        std::nth_element(sortScratch.begin(), sortScratch.begin() + static_cast<std::ptrdiff_t>(p99Index), sortScratch.end());
+
+        Statistics statistics;
+        statistics.name = history.name;
+        statistics.minMicroseconds = static_cast<double>(*std::min_element(sortScratch.begin(), sortScratch.end())) * microsecondsPerCycle;
+        statistics.averageMicroseconds = static_cast<double>(sum) / history.numEntries * microsecondsPerCycle;
+        statistics.p99Microseconds = static_cast<double>(sortScratch[p99Index]) * microsecondsPerCycle;
+        statistics.averageLoad = loadSum / history.numEntries;
+        statistics.numBlocks = history.numEntries;
+        result.push_back(statistics);
+    }
+
+    return result;
+}
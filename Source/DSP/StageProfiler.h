@@ -0,0 +1,151 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <vector>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+/// Opt-in timing of the processing stages, for finding the stage behind an overload.
+///
+/// While enabled, the audio thread reads the CPU's cycle counter around each stage and
+/// pushes one record per stage and block into a lock-free ring; nothing is aggregated on
+/// the audio thread. getStatistics() drains the ring on the message thread into a short
+/// history per stage and derives min, average and 99th percentile times from it.
+/// While disabled the graph runs its untimed loop, so the only cost is one atomic load
+/// per block.
+class StageProfiler
+{
+public:
+    /// Figures for one stage over its recent history
+    struct Statistics
+    {
+        juce::String name;
+        double minMicroseconds = 0.0;
+        double averageMicroseconds = 0.0;
+        double p99Microseconds = 0.0;
+        double averageLoad = 0.0;   // Average share of the block's real-time budget (1 = all of it)
+        int numBlocks = 0;          // Blocks the figures are taken over
+    };
+
+    /// Times one stage for one block. Does nothing if the profiler is null.
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(StageProfiler* profilerToUse, const char* stageName, int numSamples) noexcept
+            : profiler(profilerToUse),
+              name(stageName),
+              blockSize(numSamples),
+              start(profilerToUse != nullptr ? readCycleCounter() : 0)
+        {
+        }
+
+        ~ScopedTimer() noexcept
+        {
+            if (profiler != nullptr)
+                profiler->pushRecord(name, readCycleCounter() - start, blockSize);
+        }
+
+    private:
+        StageProfiler* const profiler;
+        const char* const name;
+        const int blockSize;
+        const juce::uint64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+    };
+
+    /// Blocks of history each stage's figures are taken over
+    static constexpr int historySize = 512;
+
+    StageProfiler();
+    ~StageProfiler() = default;
+
+    /// Set the sample rate block durations are measured against
+    void prepare(double sampleRate) { currentSampleRate.store(sampleRate); }
+
+    /// Start or stop collecting. Enabling starts with empty statistics.
+    /// Must not be called from the audio thread.
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    /// This profiler while it is enabled, otherwise nullptr (audio thread)
+    StageProfiler* getIfEnabled() noexcept { return isEnabled() ? this : nullptr; }
+
+    /// Store the time one stage took for one block (audio thread). The name must
+    /// outlive the profiler, e.g. a string literal.
+    void pushRecord(const char* stageName, juce::uint64 cycles, int numSamples) noexcept;
+
+    /// Collect the pending records and return the figures of every stage that ran in
+    /// the last couple of seconds, in the order the stages were first seen.
+    /// Must not be called from the audio thread.
+    std::vector<Statistics> getStatistics();
+
+    /// Records lost because the ring was full since profiling was enabled
+    int getNumDroppedRecords() const noexcept { return droppedRecords.load(); }
+
+    /// Current value of the CPU's cycle counter, or of the high resolution clock on
+    /// platforms without an accessible one. Assumes an invariant TSC on x86.
+    static juce::uint64 readCycleCounter() noexcept
+    {
+       #if JUCE_INTEL
+        return static_cast<juce::uint64>(__rdtsc());
+       #elif JUCE_ARM && JUCE_64BIT && (JUCE_GCC || JUCE_CLANG)
+        juce::uint64 value;
+        asm volatile ("mrs %0, cntvct_el0" : "=r" (value));
+        return value;
+       #else
+        return static_cast<juce::uint64>(juce::Time::getHighResolutionTicks());
+       #endif
+    }
+
+private:
+    struct Record
+    {
+        const char* name = nullptr;
+        juce::uint64 cycles = 0;
+        int numSamples = 0;
+    };
+
+    struct History
+    {
+        const char* name = nullptr;
+        std::vector<juce::uint64> cycles;
+        std::vector<int> numSamples;
+        int writePosition = 0;
+        int numEntries = 0;
+        juce::uint32 lastSeenMs = 0;
+    };
+
+    static constexpr int ringSize = 4096;
+    static constexpr juce::uint32 staleTimeoutMs = 2000;
+
+    void drainRing();
+    History& findHistory(const char* stageName);
+    double getCyclesPerSecond() const;
+
+    std::atomic<bool> enabled { false };
+    std::atomic<double> currentSampleRate { 44100.0 };
+    std::atomic<int> droppedRecords { 0 };
+
+    // Single-producer ring filled by the audio thread
+    juce::AbstractFifo fifo { ringSize };
+    std::vector<Record> ring;
+
+    // Message thread side
+    juce::CriticalSection readLock;
+    std::vector<History> histories;
+    std::vector<juce::uint64> sortScratch;
+
+    // Cycle counter calibration against the high resolution clock, taken when enabled
+    juce::uint64 referenceCycles = 0;
+    juce::int64 referenceTicks = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StageProfiler)
+};
@@ -0,0 +1,207 @@
+#include "TruePeakLimiter.h"
+
+namespace
+{
+    // ITU-R BS.1770-4 Annex 2 true-peak interpolation filter, one row per phase
+    constexpr double interpolationCoefficients[4][12] =
+    {
+        {  0.0017089843750,  0.0109863281250, -0.0196533203125,  0.0332031250000,
+          -0.0594482421875,  0.1373291015625,  0.9721679687500, -0.1022949218750,
+           0.0476074218750, -0.0266113281250,  0.0148925781250, -0.0083007812500 },
+        { -0.0291748046875,  0.0292968750000, -0.0517578125000,  0.0891113281250,
+          -0.1665039062500,  0.4650878906250,  0.7797851562500, -0.2003173828125,
+           0.1015625000000, -0.0582275390625,  0.0330810546875, -0.0189208984375 },
+        { -0.0189208984375,  0.0330810546875, -0.0582275390625,  0.1015625000000,
+          -0.2003173828125,  0.7797851562500,  0.4650878906250, -0.1665039062500,
+           0.0891113281250, -0.0517578125000,  0.0292968750000, -0.0291748046875 },
+        { -0.0083007812500,  0.0148925781250, -0.0266113281250,  0.0476074218750,
+          -0.1022949218750,  0.9721679687500,  0.1373291015625, -0.0594482421875,
+           0.0332031250000, -0.0196533203125,  0.0109863281250,  0.0017089843750 }
+    };
+}
+
+template <typename SampleType>
+TruePeakLimiter<SampleType>::TruePeakLimiter()
+{
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    maxBlockSize = static_cast<int>(spec.maximumBlockSize);
+
+    windowLength = juce::jmax(1, juce::roundToInt(lookaheadSeconds * sampleRate));
+
+    // A peak detected at sample n is fully attenuated windowLength - 1 samples later,
+    // and the interpolator reports peaks interpolationDelay samples after they occur
+    latencySamples = windowLength - 1 + interpolationDelay;
+
+    const auto numChannels = static_cast<int>(spec.numChannels);
+    interpolatorHistory.assign(static_cast<size_t>(numChannels), {});
+
+    dequeIndices.resize(static_cast<size_t>(windowLength + 1));
+    dequePeaks.resize(static_cast<size_t>(windowLength + 1));
+    boxHistory.resize(static_cast<size_t>(windowLength));
+
+    delayBuffer.setSize(numChannels, latencySamples + maxBlockSize);
+    gainBuffer.resize(static_cast<size_t>(maxBlockSize));
+
+    updateReleaseCoefficient();
+    reset();
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::reset()
+{
+    for (auto& history : interpolatorHistory)
+        history.fill(SampleType(0));
+
+    historyPosition = 0;
+
+    dequeHead = 0;
+    dequeSize = 0;
+    sampleIndex = 0;
+
+    envelope = SampleType(1);
+    std::fill(boxHistory.begin(), boxHistory.end(), SampleType(1));
+    boxPosition = 0;
+    boxSum = static_cast<double>(windowLength);
+
+    delayBuffer.clear();
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::setThreshold(SampleType thresholdDecibels)
+{
+    threshold = juce::Decibels::decibelsToGain(thresholdDecibels);
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::setRelease(SampleType releaseMilliseconds)
+{
+    releaseMs = juce::jmax(SampleType(0.1), releaseMilliseconds);
+    updateReleaseCoefficient();
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::updateReleaseCoefficient()
+{
+    releaseCoefficient = static_cast<SampleType>(std::exp(-1.0 / (sampleRate * releaseMs * 0.001)));
+}
+
+template <typename SampleType>
+void TruePeakLimiter<SampleType>::process(const juce::dsp::ProcessContextReplacing<SampleType>& context)
+{
+    if (context.isBypassed)
+        return;
+
+    auto& block = context.getOutputBlock();
+    const auto numChannels = juce::jmin(static_cast<int>(block.getNumChannels()), delayBuffer.getNumChannels());
+    const auto totalSamples = static_cast<int>(block.getNumSamples());
+
+    for (int start = 0; start < totalSamples; start += maxBlockSize)
+    {
+        const auto numSamples = juce::jmin(maxBlockSize, totalSamples - start);
+
+        // Detect the true peak across all channels and derive the gain for each sample
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            SampleType peak = 0;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                peak = juce::jmax(peak, detectTruePeak(block.getSample(channel, start + sample), channel));
+
+            historyPosition = (historyPosition + interpolationTaps - 1) % interpolationTaps;
+            gainBuffer[static_cast<size_t>(sample)] = computeGain(peak);
+        }
+
+        // Delay the audio by the lookahead and apply the gain
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* delayed = delayBuffer.getWritePointer(channel);
+            auto* data = block.getChannelPointer(static_cast<size_t>(channel)) + start;
+
+            juce::FloatVectorOperations::copy(delayed + latencySamples, data, numSamples);
+            juce::FloatVectorOperations::multiply(data, delayed, gainBuffer.data(), numSamples);
+
+            std::memmove(delayed, delayed + numSamples, static_cast<size_t>(latencySamples) * sizeof(SampleType));
+        }
+    }
+}
+
+template <typename SampleType>
+SampleType TruePeakLimiter<SampleType>::detectTruePeak(SampleType input, int channel)
+{
+    auto& history = interpolatorHistory[static_cast<size_t>(channel)];
+
+    // The write position moves backwards, so x[i] below is the input from i samples ago
+    history[static_cast<size_t>(historyPosition)] = input;
+    history[static_cast<size_t>(historyPosition + interpolationTaps)] = input;
+
+    const auto* x = history.data() + historyPosition;
+
+    // The sample itself, aligned with the interpolated phases
+    SampleType peak = std::abs(x[interpolationDelay]);
+
+    for (int phase = 0; phase < interpolationPhases; ++phase)
+    {
+        double sum = 0.0;
+
+        for (int tap = 0; tap < interpolationTaps; ++tap)
+            sum += interpolationCoefficients[phase][tap] * static_cast<double>(x[tap]);
+
+        peak = juce::jmax(peak, static_cast<SampleType>(std::abs(sum)));
+    }
+
+    return peak;
+}
+
+template <typename SampleType>
+SampleType TruePeakLimiter<SampleType>::computeGain(SampleType peak)
+{
+    const auto capacity = windowLength + 1;
+
+    // Sliding window maximum: drop smaller peaks from the back, expired peaks from the front
+    while (dequeSize > 0 && dequePeaks[static_cast<size_t>((dequeHead + dequeSize - 1) % capacity)] <= peak)
+        --dequeSize;
+
+    const auto back = static_cast<size_t>((dequeHead + dequeSize) % capacity);
+    dequeIndices[back] = sampleIndex;
+    dequePeaks[back] = peak;
+    ++dequeSize;
+
+    while (dequeIndices[static_cast<size_t>(dequeHead)] <= sampleIndex - windowLength)
+    {
+        dequeHead = (dequeHead + 1) % capacity;
+        --dequeSize;
+    }
+
+    ++sampleIndex;
+
+    const auto windowPeak = dequePeaks[static_cast<size_t>(dequeHead)];
+    const auto target = windowPeak > threshold ? threshold / windowPeak : SampleType(1);
+
+    // Instant attack (the lookahead already smooths it), exponential release
+    envelope = target < envelope ? target : target + releaseCoefficient * (envelope - target);
+
+    // Moving average over the window turns the held gain into a smooth ramp
+    auto& oldest = boxHistory[static_cast<size_t>(boxPosition)];
+    boxSum += static_cast<double>(envelope) - static_cast<double>(oldest);
+    oldest = envelope;
+
+    if (++boxPosition == windowLength)
+    {
+        // Recompute once per window so rounding errors in the running sum cannot accumulate
+        boxPosition = 0;
+        boxSum = 0.0;
+
+        for (auto value : boxHistory)
+            boxSum += static_cast<double>(value);
+    }
+
+    return static_cast<SampleType>(boxSum / windowLength);
+}
+
+template class TruePeakLimiter<float>;
+template class TruePeakLimiter<double>;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <vector>
+
+/// Lookahead brickwall limiter with true-peak detection.
+///
+/// Peaks are measured on a 4x polyphase interpolation of the input (ITU-R BS.1770-4 Annex 2),
+/// so inter-sample overs are caught as well. A sliding-window maximum over the lookahead
+/// window drives the gain, which is then box-filtered over the same window; the audio is
+/// delayed by the lookahead so the gain has fully settled by the time a peak arrives.
+template <typename SampleType>
+class TruePeakLimiter
+{
+public:
+    TruePeakLimiter();
+    ~TruePeakLimiter() = default;
+
+    /// Prepare the limiter for playback
+    void prepare(const juce::dsp::ProcessSpec& spec);
+
+    /// Clear the delay line and gain state
+    void reset();
+
+    /// Process audio block
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context);
+
+    /// Ceiling in dBTP
+    void setThreshold(SampleType thresholdDecibels);
+
+    /// Release time in milliseconds
+    void setRelease(SampleType releaseMilliseconds);
+
+    /// Delay the limiter adds to the signal, to be reported to the host
+    int getLatencySamples() const { return latencySamples; }
+
+    /// Lookahead window length
+    static constexpr double lookaheadSeconds = 0.002;
+
+private:
+    static constexpr int interpolationPhases = 4;
+    static constexpr int interpolationTaps = 12;
+
+    /// Group delay of the interpolation filter, rounded to whole samples
+    static constexpr int interpolationDelay = interpolationTaps / 2;
+
+    SampleType detectTruePeak(SampleType input, int channel);
+    SampleType computeGain(SampleType peak);
+    void updateReleaseCoefficient();
+
+    // Settings
+    SampleType threshold = 1;
+    SampleType releaseMs = 10;
+    SampleType releaseCoefficient = 0;
+    double sampleRate = 44100.0;
+
+    int windowLength = 1;
+    int latencySamples = 0;
+    int maxBlockSize = 0;
+
+    // Interpolator history per channel, written twice so every read is contiguous
+    std::vector<std::array<SampleType, interpolationTaps * 2>> interpolatorHistory;
+    int historyPosition = 0;
+
+    // Monotonic deque of (sample index, peak) for the sliding window maximum
+    std::vector<juce::int64> dequeIndices;
+    std::vector<SampleType> dequePeaks;
+    int dequeHead = 0;
+    int dequeSize = 0;
+    juce::int64 sampleIndex = 0;
+
+    // Gain envelope and its moving average over the window
+    SampleType envelope = 1;
+    std::vector<SampleType> boxHistory;
+    int boxPosition = 0;
+    double boxSum = 0.0;
+
+    // Per-channel delay line holding latencySamples of history followed by the current block
+    juce::AudioBuffer<SampleType> delayBuffer;
+    std::vector<SampleType> gainBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TruePeakLimiter)
+};
@@ -0,0 +1,56 @@
+#include "ParameterPublisher.h"
+
+ParameterPublisher::~ParameterPublisher()
+{
+    stopTimer();
+}
+
+void ParameterPublisher::setParameters(const juce::Array<juce::AudioProcessorParameter*>& newParameters)
+{
+    jassert(newParameters.size() <= maxParameters);
+
+    parameters.clear();
+
+    for (auto* parameter : newParameters)
+    {
+        if (static_cast<int>(parameters.size()) == maxParameters)
+            break;
+
+        parameters.push_back(parameter);
+    }
+
+    startTimerHz(30);
+}
+
+void ParameterPublisher::setValue(int index, float normalisedValue) noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, static_cast<int>(parameters.size())));
+
+    parameters[static_cast<size_t>(index)]->setValue(normalisedValue);
+    pending[static_cast<size_t>(index)].store(true);
+    anyPending.store(true);
+}
+
+void ParameterPublisher::setValueQuietly(int index, float normalisedValue) noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, static_cast<int>(parameters.size())));
+
+    parameters[static_cast<size_t>(index)]->setValue(normalisedValue);
+}
+
+void ParameterPublisher::publishPendingChanges()
+{
+    if (! anyPending.exchange(false))
+        return;
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        if (! pending[i].exchange(false))
+            continue;
+
+        // The value is already in place; this only runs the notifications it skipped. There is
+        // no gesture around it, so hosts in touch or latch mode do not record it as automation.
+        auto* parameter = parameters[i];
+        parameter->setValueNotifyingHost(parameter->getValue());
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+/// Lets the audio thread change plugin parameters without notifying anyone from there.
+///
+/// setValue() only stores the value in the parameter, where getValue() returns it right
+/// away, so the processor hears the change in the same block. Telling the host, the editor
+/// and the APVTS takes locks and may allocate, so a message thread timer does that for
+/// every parameter the audio thread touched since its last tick.
+class ParameterPublisher : private juce::Timer
+{
+public:
+    static constexpr int maxParameters = 64;
+
+    ParameterPublisher() = default;
+    ~ParameterPublisher() override;
+
+    /// Parameters in AudioProcessor::getParameters() order. Must be called on the message
+    /// thread before processing starts.
+    void setParameters(const juce::Array<juce::AudioProcessorParameter*>& parameters);
+
+    /// Change a parameter from the audio thread, by its index in the parameter list
+    void setValue(int index, float normalisedValue) noexcept;
+
+    /// Change a parameter from the audio thread without publishing it, for the steps of a
+    /// change that ends with setValue(). The host only hears about the final value.
+    void setValueQuietly(int index, float normalisedValue) noexcept;
+
+    /// Send out every change the audio thread has made since the last call (message thread)
+    void publishPendingChanges();
+
+private:
+    void timerCallback() override { publishPendingChanges(); }
+
+    std::vector<juce::AudioProcessorParameter*> parameters;
+    std::array<std::atomic<bool>, maxParameters> pending {};
+    std::atomic<bool> anyPending { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterPublisher)
+};
@@ -2,7 +2,7 @@
 #include "PluginEditor.h"   
 
 SpiceAudioProcessorEditor::SpiceAudioProcessorEditor (SpiceAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p), gateIndicatorLED(p)
+    : AudioProcessorEditor (&p), audioProcessor (p), profilerOverlay(p.getStageProfiler()), gateIndicatorLED(p)
 {
     // Load custom fonts
     auto piximData = BinaryData::Pixim_otf;
@@ -317,6 +317,7 @@ SpiceAudioProcessorEditor::SpiceAudioProcessorEditor (SpiceAudioProcessor& p)
     // Preset controls
     presetSelector.addListener(this);
     addAndMakeVisible(presetSelector);
+    audioProcessor.getPresetManager().addChangeListener(this);
     refreshPresetList();
     
     previousPresetButton.addListener(this);
@@ -337,6 +338,21 @@ SpiceAudioProcessorEditor::SpiceAudioProcessorEditor (SpiceAudioProcessor& p)
     savePresetButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xff606060));
     addAndMakeVisible(savePresetButton);
     
+    abSlotButton.addListener(this);
+    abSlotButton.setLookAndFeel(&lookAndFeel);
+    abSlotButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff0a0a0a));
+    abSlotButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xff606060));
+    abSlotButton.setTooltip("Switch between the A and B settings");
+    abSlotButton.setButtonText(audioProcessor.getPresetManager().getActiveSlot() == PresetManager::Slot::a ? "A" : "B");
+    addAndMakeVisible(abSlotButton);
+    
+    morphPresetsButton.addListener(this);
+    morphPresetsButton.setLookAndFeel(&lookAndFeel);
+    morphPresetsButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff0a0a0a));
+    morphPresetsButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xff606060));
+    updateMorphPresetsTooltip();
+    addAndMakeVisible(morphPresetsButton);
+    
     // Bypass button
     bypassButton.setOnOffText("BYPASS ON", "BYPASS OFF");
     addAndMakeVisible(bypassButton);
@@ -424,6 +440,17 @@ SpiceAudioProcessorEditor::SpiceAudioProcessorEditor (SpiceAudioProcessor& p)
     // compactViewAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
     //     audioProcessor.getAPVTS(), "compactView", compactViewButton);
     
+    // Per-stage CPU overlay, profiling only runs while it is shown
+    profilerButton.setClickingTogglesState(true);
+    profilerButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff0a0a0a));
+    profilerButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xff1a4a66));
+    profilerButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xff606060));
+    profilerButton.setColour(juce::TextButton::textColourOnId, juce::Colour(0xff57c4f1));
+    profilerButton.setTooltip("Show how long each processing stage takes");
+    profilerButton.addListener(this);
+    addAndMakeVisible(profilerButton);
+    addChildComponent(profilerOverlay);
+    
     presetLabel.setText("PRESET", juce::dontSendNotification);
     presetLabel.setJustificationType(juce::Justification::centred);
     presetLabel.setFont(dirtyHaroldFont.withHeight(18.0f));
@@ -435,6 +462,7 @@ SpiceAudioProcessorEditor::SpiceAudioProcessorEditor (SpiceAudioProcessor& p)
 
 SpiceAudioProcessorEditor::~SpiceAudioProcessorEditor()
 {
+    audioProcessor.getPresetManager().removeChangeListener(this);
     stopTimer();
     setLookAndFeel(nullptr);
 }
@@ -645,14 +673,18 @@ void SpiceAudioProcessorEditor::resized()
     nextModelButton.setBounds(modelControls.removeFromLeft(30));
     
     // Preset controls in the middle top
-    auto presetArea = juce::Rectangle<int>(centerX - 125, area.getY() - 10, 250, 45);
+    auto presetArea = juce::Rectangle<int>(centerX - 141, area.getY() - 10, 282, 45);
     presetLabel.setBounds(presetArea.removeFromTop(22));
     auto presetControls = presetArea;
     previousPresetButton.setBounds(presetControls.removeFromLeft(30));
     presetControls.removeFromLeft(2);
     nextPresetButton.setBounds(presetControls.removeFromLeft(30));
     presetControls.removeFromLeft(5);
-    presetSelector.setBounds(presetControls.removeFromLeft(130));
+    presetSelector.setBounds(presetControls.removeFromLeft(98));
+    presetControls.removeFromLeft(4);
+    abSlotButton.setBounds(presetControls.removeFromLeft(28));
+    presetControls.removeFromLeft(4);
+    morphPresetsButton.setBounds(presetControls.removeFromLeft(28));
     presetControls.removeFromLeft(5);
     savePresetButton.setBounds(presetControls);
     
@@ -661,6 +693,10 @@ void SpiceAudioProcessorEditor::resized()
     qualityLabel.setBounds(qualityArea.removeFromTop(22));
     qualitySelector.setBounds(qualityArea);
     
+    // CPU overlay toggle in the bottom left corner, the table opens above it
+    profilerButton.setBounds(20, area.getBottom() - 22, 44, 22);
+    profilerOverlay.setBounds(20, area.getBottom() - 22 - 6 - 240, 340, 240);
+    
     // Circular arrangement of controls around the center
     auto knobSize = 100;
     auto labelHeight = 25;
@@ -895,7 +931,7 @@ void SpiceAudioProcessorEditor::drawAmbientLight(juce::Graphics& g, juce::Point<
 
 void SpiceAudioProcessorEditor::refreshPresetList()
 {
-    presetSelector.clear();
+    presetSelector.clear(juce::dontSendNotification);
     
     auto& presetManager = audioProcessor.getPresetManager();
     auto presets = presetManager.getAllPresets();
@@ -920,6 +956,13 @@ void SpiceAudioProcessorEditor::comboBoxChanged(juce::ComboBox* comboBox)
     }
 }
 
+void SpiceAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    // The preset list changed, e.g. a background scan of the presets directory finished.
+    // The preset manager is the only broadcaster the editor listens to.
+    refreshPresetList();
+}
+
 void SpiceAudioProcessorEditor::buttonClicked(juce::Button* button)
 {
     if (button == &previousModelButton)
@@ -948,6 +991,23 @@ void SpiceAudioProcessorEditor::buttonClicked(juce::Button* button)
     {
         savePresetDialog();
     }
+    else if (button == &abSlotButton)
+    {
+        auto& presetManager = audioProcessor.getPresetManager();
+        auto slot = presetManager.getActiveSlot() == PresetManager::Slot::a ? PresetManager::Slot::b : PresetManager::Slot::a;
+        presetManager.selectSlot(slot);
+        abSlotButton.setButtonText(slot == PresetManager::Slot::a ? "A" : "B");
+        presetSelector.setText(presetManager.getCurrentPreset(), juce::dontSendNotification);
+    }
+    else if (button == &morphPresetsButton)
+    {
+        showMorphPresetMenu();
+    }
+    else if (button == &profilerButton)
+    {
+        profilerOverlay.setVisible(profilerButton.getToggleState());
+        profilerOverlay.toFront(false);
+    }
     
     // Trial notification buttons are now handled by the TrialNotificationComponent itself
     // Compact view functionality disabled
@@ -958,6 +1018,57 @@ void SpiceAudioProcessorEditor::buttonClicked(juce::Button* button)
     // }
 }
 
+void SpiceAudioProcessorEditor::showMorphPresetMenu()
+{
+    auto& presetManager = audioProcessor.getPresetManager();
+    const auto presets = presetManager.getAllPresets();
+    const auto morphPresets = presetManager.getMorphPresets();
+    
+    // Item 1 morphs between the slots, item i + 2 toggles preset i; picked presets are
+    // morphed through in the order they were picked
+    juce::PopupMenu menu;
+    menu.addSectionHeader("Morph between");
+    menu.addItem(1, "Slots A and B", true, morphPresets.isEmpty());
+    menu.addSeparator();
+    
+    for (int i = 0; i < presets.size(); ++i)
+    {
+        const auto position = morphPresets.indexOf(presets[i]);
+        const bool canToggle = position >= 0 || morphPresets.size() < PresetMorpher::maxPoints;
+        const auto text = position >= 0 ? juce::String(position + 1) + ". " + presets[i] : presets[i];
+        
+        menu.addItem(i + 2, text, canToggle, position >= 0);
+    }
+    
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&morphPresetsButton),
+                       [safeThis = juce::Component::SafePointer<SpiceAudioProcessorEditor>(this), presets](int result)
+    {
+        if (safeThis == nullptr || result == 0)
+            return;
+        
+        auto& manager = safeThis->audioProcessor.getPresetManager();
+        auto newMorphPresets = manager.getMorphPresets();
+        
+        if (result == 1)
+            newMorphPresets.clear();
+        else if (newMorphPresets.contains(presets[result - 2]))
+            newMorphPresets.removeString(presets[result - 2]);
+        else
+            newMorphPresets.add(presets[result - 2]);
+        
+        manager.setMorphPresets(newMorphPresets);
+        safeThis->updateMorphPresetsTooltip();
+    });
+}
+
+void SpiceAudioProcessorEditor::updateMorphPresetsTooltip()
+{
+    const auto morphPresets = audioProcessor.getPresetManager().getMorphPresets();
+    
+    morphPresetsButton.setTooltip(morphPresets.isEmpty() ? "Morph between slots A and B"
+                                                         : "Morph through " + morphPresets.joinIntoString(", "));
+}
+
 void SpiceAudioProcessorEditor::savePresetDialog()
 {
     auto currentPreset = audioProcessor.getPresetManager().getCurrentPreset();
@@ -8,12 +8,14 @@
 #include "UI/AnalogLamp.h"
 #include "UI/OnOffButton.h"
 #include "UI/PresetSaveDialog.h"
+#include "UI/ProfilerOverlay.h"
 
 
 class SpiceAudioProcessorEditor : public juce::AudioProcessorEditor,
                                         public juce::Timer,
                                         public juce::ComboBox::Listener,
-                                        public juce::Button::Listener
+                                        public juce::Button::Listener,
+                                        public juce::ChangeListener
 {
 public:
     SpiceAudioProcessorEditor (SpiceAudioProcessor&);
@@ -25,10 +27,13 @@ public:
     
     void comboBoxChanged(juce::ComboBox* comboBox) override;
     void buttonClicked(juce::Button* button) override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
     
 private:
     void refreshPresetList();
     void savePresetDialog();
+    void showMorphPresetMenu();
+    void updateMorphPresetsTooltip();
     void drawSectionSeparator(juce::Graphics& g, juce::Rectangle<float> area, float y, const juce::String& label);
     void drawAmbientLight(juce::Graphics& g, juce::Point<float> position, juce::Colour colour);
     void drawVintageMeterBezel(juce::Graphics& g, juce::Rectangle<int> bounds);
@@ -60,8 +65,11 @@ private:
     juce::TextButton previousPresetButton {"<"};
     juce::TextButton nextPresetButton {">"};
     juce::TextButton savePresetButton {"SAVE"};
+    juce::TextButton abSlotButton {"A"};
+    juce::TextButton morphPresetsButton {"M"};
     OnOffButton bypassButton;
     juce::TextButton compactViewButton {"COMPACT"};
+    juce::TextButton profilerButton {"CPU"};
     OnOffButton gateEnabledButton;
     OnOffButton cabinetEnabledButton;
     OnOffButton limiterEnabledButton;
@@ -123,6 +131,7 @@ private:
     foleys::LevelMeter outputMeter;
     WaveformVisualizer waveformDisplay;
     AnalogLamp saturationLamp;
+    ProfilerOverlay profilerOverlay;
     
     // Gate indicator LED
     class GateIndicatorLED : public juce::Component
@@ -140,11 +149,8 @@ private:
             
             if (gateEnabled)
             {
-                // Check if gate is actively gating by looking at input level vs threshold
-                auto gateThreshold = processor.getAPVTS().getRawParameterValue("gateThreshold")->load();
-                auto inputLevel = processor.getGateInputLevel();
-                auto thresholdLinear = juce::Decibels::decibelsToGain(gateThreshold);
-                bool gateOpen = inputLevel > thresholdLinear;
+                // Gate state as published by the audio thread (includes hysteresis and hold)
+                bool gateOpen = processor.isGateOpen();
                 
                 if (gateOpen)
                 {
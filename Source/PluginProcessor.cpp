@@ -13,38 +13,76 @@ SpiceAudioProcessor::SpiceAudioProcessor()
                        ),
 #endif
     apvts(*this, nullptr, "Parameters", createParameterLayout()),
-    oversampling(2, 2, Oversampling::filterHalfBandPolyphaseIIR),
     presetManager(apvts)
 {
     presetManager.setProcessor(this);
-    
-    inputGainParam = apvts.getRawParameterValue("inputGain");
-    driveParam = apvts.getRawParameterValue("drive");
-    mixParam = apvts.getRawParameterValue("mix");
-    outputParam = apvts.getRawParameterValue("output");
-    modelParam = apvts.getRawParameterValue("model");
-    toneParam = apvts.getRawParameterValue("tone");
-    biasParam = apvts.getRawParameterValue("bias");
-    qualityParam = apvts.getRawParameterValue("quality");
+    parameterPublisher.setParameters(getParameters());
+    presetCrossfader.setParameters(getParameters(), parameterPublisher);
+    presetCrossfader.onApply = [this](const ParameterSnapshot& snapshot) { compileGraphForSnapshot(snapshot); };
+    stateSerializer.setParameters(getParameters());
+    
+    inputGainParam = apvts.getParameter("inputGain");
+    driveParam = apvts.getParameter("drive");
+    mixParam = apvts.getParameter("mix");
+    outputParam = apvts.getParameter("output");
+    modelParam = apvts.getParameter("model");
+    toneParam = apvts.getParameter("tone");
+    biasParam = apvts.getParameter("bias");
+    qualityParam = apvts.getParameter("quality");
+    bypassParam = apvts.getParameter("bypass");
     // compactViewParam = apvts.getRawParameterValue("compactView");
-    lowCutParam = apvts.getRawParameterValue("lowCut");
-    highCutParam = apvts.getRawParameterValue("highCut");
-    gateThresholdParam = apvts.getRawParameterValue("gateThreshold");
-    gateEnabledParam = apvts.getRawParameterValue("gateEnabled");
-    cabinetModelParam = apvts.getRawParameterValue("cabinetModel");
-    cabinetPresenceParam = apvts.getRawParameterValue("cabinetPresence");
-    cabinetMixParam = apvts.getRawParameterValue("cabinetMix");
-    cabinetEnabledParam = apvts.getRawParameterValue("cabinetEnabled");
-    limiterEnabledParam = apvts.getRawParameterValue("limiterEnabled");
-    midSideEnabledParam = apvts.getRawParameterValue("midSideEnabled");
-    midGainParam = apvts.getRawParameterValue("midGain");
-    sideGainParam = apvts.getRawParameterValue("sideGain");
-    stereoWidthParam = apvts.getRawParameterValue("stereoWidth");
-    autoGainParam = apvts.getRawParameterValue("autoGain");
+    lowCutParam = apvts.getParameter("lowCut");
+    highCutParam = apvts.getParameter("highCut");
+    lowCutSlopeParam = apvts.getParameter("lowCutSlope");
+    highCutSlopeParam = apvts.getParameter("highCutSlope");
+    gateThresholdParam = apvts.getParameter("gateThreshold");
+    gateEnabledParam = apvts.getParameter("gateEnabled");
+    gateHysteresisParam = apvts.getParameter("gateHysteresis");
+    gateHoldParam = apvts.getParameter("gateHold");
+    gateLookaheadParam = apvts.getParameter("gateLookahead");
+    cabinetModelParam = apvts.getParameter("cabinetModel");
+    cabinetPresenceParam = apvts.getParameter("cabinetPresence");
+    cabinetMixParam = apvts.getParameter("cabinetMix");
+    cabinetEnabledParam = apvts.getParameter("cabinetEnabled");
+    limiterEnabledParam = apvts.getParameter("limiterEnabled");
+    midSideEnabledParam = apvts.getParameter("midSideEnabled");
+    midGainParam = apvts.getParameter("midGain");
+    sideGainParam = apvts.getParameter("sideGain");
+    stereoWidthParam = apvts.getParameter("stereoWidth");
+    autoGainParam = apvts.getParameter("autoGain");
+    autoGainModeParam = apvts.getParameter("autoGainMode");
+    multibandEnabledParam = apvts.getParameter("multibandEnabled");
+    lowMidCrossoverParam = apvts.getParameter("lowMidCrossover");
+    midHighCrossoverParam = apvts.getParameter("midHighCrossover");
+    bandDriveParams = { apvts.getParameter("lowDrive"), apvts.getParameter("midDrive"), apvts.getParameter("highDrive") };
+    bandModelParams = { apvts.getParameter("lowModel"), apvts.getParameter("midModel"), apvts.getParameter("highModel") };
+    morphEnabledParam = apvts.getParameter("morphEnabled");
+    morphParam = apvts.getParameter("morph");
+    
+    modelParameter = apvts.getParameter("model");
+    cabinetModelParameter = apvts.getParameter("cabinetModel");
+    qualityParameter = apvts.getParameter("quality");
+    
+    // The morph never drives its own controls or the bypass
+    presetMorpher.setParameters(getParameters(), { apvts.getParameter("morphEnabled"), apvts.getParameter("morph"), apvts.getParameter("bypass") }, parameterPublisher);
+    
+    floatChain.engine.setProfiler(&stageProfiler);
+    doubleChain.engine.setProfiler(&stageProfiler);
+    
+    // Parameters that add or remove stages from the processing graph
+    for (auto* id : { "lowCut", "highCut", "gateEnabled", "gateLookahead", "autoGain", "midSideEnabled", "cabinetEnabled", "limiterEnabled", "multibandEnabled" })
+        apvts.addParameterListener(id, this);
+    
+    rebuildProcessingGraph(getParameterValues());
+    startTimer(graphUpdateIntervalMs);
 }
 
 SpiceAudioProcessor::~SpiceAudioProcessor()
 {
+    for (auto* id : { "lowCut", "highCut", "gateEnabled", "gateLookahead", "autoGain", "midSideEnabled", "cabinetEnabled", "limiterEnabled", "multibandEnabled" })
+        apvts.removeParameterListener(id, this);
+    
+    stopTimer();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SpiceAudioProcessor::createParameterLayout()
@@ -154,6 +192,68 @@ juce::AudioProcessorValueTreeState::ParameterLayout SpiceAudioProcessor::createP
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         juce::ParameterID("autoGain", 6), "Auto Gain", false));
     
+    // Auto-gain measurement mode (new in version 7)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("autoGainMode", 7), "Auto Gain Mode", 
+        juce::StringArray{"RMS", "Loudness"}, 0));
+    
+    // Noise gate dynamics (new in version 7)
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("gateHysteresis", 7), "Gate Hysteresis", 
+        juce::NormalisableRange<float>(0.0f, 12.0f, 0.1f), 0.0f));
+    
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("gateHold", 7), "Gate Hold", 
+        juce::NormalisableRange<float>(0.0f, 500.0f, 1.0f, 0.5f), 0.0f));
+    
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("gateLookahead", 7), "Gate Lookahead", 
+        juce::NormalisableRange<float>(0.0f, 10.0f, 0.1f), 0.0f));
+    
+    // Pre-FX filter slopes (new in version 8)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("lowCutSlope", 8), "Low Cut Slope", 
+        juce::StringArray{"12 dB/oct", "24 dB/oct", "48 dB/oct"}, 0));
+    
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("highCutSlope", 8), "High Cut Slope", 
+        juce::StringArray{"12 dB/oct", "24 dB/oct", "48 dB/oct"}, 0));
+    
+    // Multiband saturation (new in version 9)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("multibandEnabled", 9), "Multiband Enable", false));
+    
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("lowMidCrossover", 9), "Low/Mid Crossover", 
+        juce::NormalisableRange<float>(40.0f, 1000.0f, 1.0f, 0.3f), 200.0f));
+    
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("midHighCrossover", 9), "Mid/High Crossover", 
+        juce::NormalisableRange<float>(1000.0f, 12000.0f, 1.0f, 0.3f), 3000.0f));
+    
+    const juce::StringArray modelNames {"Tube Saturation", "Transistor Drive", "Transformer Saturation", "Tape Compression", "Diode Clipping", "Vintage Console", "Warm Plexi", "Bright Crystal", "Fuzz Box", "Overdrive", "12AX7 Tube"};
+    
+    for (auto* band : { "low", "mid", "high" })
+    {
+        const auto bandName = juce::String(band).substring(0, 1).toUpperCase() + juce::String(band).substring(1);
+        
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(juce::String(band) + "Drive", 9), bandName + " Drive", 
+            juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 30.0f));
+        
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID(juce::String(band) + "Model", 9), bandName + " Model", 
+            modelNames, 0));
+    }
+    
+    // Preset morphing (new in version 10)
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("morphEnabled", 10), "Morph Enable", false));
+    
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("morph", 10), "Morph", 
+        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
+    
     return { params.begin(), params.end() };
 }
 
@@ -191,7 +291,8 @@ bool SpiceAudioProcessor::isMidiEffect() const
 
 double SpiceAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return isUsingDoublePrecision() ? doubleChain.engine.getTailLengthSeconds()
+                                    : floatChain.engine.getTailLengthSeconds();
 }
 
 int SpiceAudioProcessor::getNumPrograms()
@@ -224,108 +325,58 @@ void SpiceAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = getTotalNumOutputChannels();
     
-    storedSpec = spec;
-    
-    oversampling.prepare(spec);
-    
-    auto oversampledSpec = spec;
-    oversampledSpec.sampleRate *= oversampling.getOversamplingFactor();
-    
-    saturationProcessor.prepare(oversampledSpec);
-    filterChain.prepare(oversampledSpec);
-    
-    // Prepare cabinet simulator at normal sample rate (post-fx)
-    cabinetSimulator.prepare(spec);
-    
-    // Prepare mid-side processor
-    midSideProcessor.prepare(spec);
-    
-    inputGain.prepare(spec);
-    dryWetMixer.prepare(spec);
-    cabinetDryWetMixer.prepare(spec);
-    outputGain.prepare(spec);
+    presetCrossfader.prepare(sampleRate);
+    stageProfiler.prepare(sampleRate);
     
-    // Prepare limiter
-    limiter.prepare(spec);
-    limiter.setThreshold(0.0f);  // 0 dB threshold
-    limiter.setRelease(10.0f);   // 10ms release
-    
-    // Prepare pre-FX filters and noise gate
-    lowCutFilter.prepare(spec);
-    highCutFilter.prepare(spec);
-    gateEnvelope.resize(spec.numChannels, 0.0f);
-    smoothedGate.resize(spec.numChannels, 1.0f);
-    
-    dcBlocker.prepare(spec);
-    inputMeterDCBlocker.prepare(spec);
-    outputMeterDCBlocker.prepare(spec);
-    
-    dryWetMixer.setMixingRule(juce::dsp::DryWetMixingRule::linear);
-    cabinetDryWetMixer.setMixingRule(juce::dsp::DryWetMixingRule::linear);
-    
-    // Initialize DC blocker with high-pass at 5Hz
-    *dcBlocker.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 5.0f);
-    
-    // Initialize meter DC blockers with high-pass at 10Hz for more aggressive DC removal
-    *inputMeterDCBlocker.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 10.0f);
-    *outputMeterDCBlocker.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, 10.0f);
+    // Only the chain for the host's processing precision is needed
+    if (isUsingDoublePrecision())
+        prepareChain(doubleChain, spec);
+    else
+        prepareChain(floatChain, spec);
     
-    // Initialize pre-FX filters
-    updatePreFXFilters(sampleRate);
+    // Sized up front so the per-block copies never allocate
+    {
+        const juce::SpinLock::ScopedLockType sl(visualizationLock);
+        inputVisualizationBuffer.setSize(static_cast<int>(spec.numChannels), samplesPerBlock);
+        outputVisualizationBuffer.setSize(static_cast<int>(spec.numChannels), samplesPerBlock);
+    }
     
     // Initialize meters
     inputMeterSource.resize(spec.numChannels, spec.sampleRate * 0.1 / spec.maximumBlockSize);
     outputMeterSource.resize(spec.numChannels, spec.sampleRate * 0.1 / spec.maximumBlockSize);
     
-    // Initialize parameter smoothing to avoid clicks - instant response
-    inputGainSmoothed.reset(sampleRate, 0.002);  // 2ms for input gain
-    driveSmoothed.reset(sampleRate, 0.001);   // 1ms for instant response
-    mixSmoothed.reset(sampleRate, 0.001);     // 1ms
-    outputSmoothed.reset(sampleRate, 0.002);  // 2ms for output gain
-    toneSmoothed.reset(sampleRate, 0.001);    // 1ms
-    biasSmoothed.reset(sampleRate, 0.001);    // 1ms
-    bypassSmoothed.reset(sampleRate, 0.002);  // 2ms for bypass - fast response while still avoiding clicks
-    autoGainCompensation.reset(sampleRate, 0.5);  // 500ms for smooth auto-gain adjustments
-    
-    // Initialize bypass smoothed value with current parameter state
-    auto* bypassParam = apvts.getRawParameterValue("bypass");
-    if (bypassParam)
-    {
-        float initialBypassValue = bypassParam->load() > 0.5f ? 1.0f : 0.0f;
-        bypassSmoothed.setCurrentAndTargetValue(initialBypassValue);
-    }
+    // The prepared engine has already taken its graph
+    updateReportedLatency();
+}
+
+template <typename SampleType>
+void SpiceAudioProcessor::prepareChain(DSPChain<SampleType>& chain, const juce::dsp::ProcessSpec& spec)
+{
+    using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+    
+    chain.engine.prepare(spec, getChannelLayoutOfBus(false, 0), getParameterValues());
     
-    // Update oversampling based on quality setting
-    int qualityLevel = static_cast<int>(*qualityParam);
-    int oversamplingFactor = (qualityLevel == 0) ? 1 : (qualityLevel == 1) ? 2 : 4;
-    // Note: For dynamic quality changes, we'd need to re-prepare the oversampling
-    // For now, oversampling factor is set at construction time
+    chain.inputMeterDCBlocker.prepare(spec);
+    chain.outputMeterDCBlocker.prepare(spec);
     
-    // Initialize RMS buffers for auto-gain compensation
-    rmsBufferSize = static_cast<int>(sampleRate * rmsWindowMs / 1000.0f);
-    inputRmsBuffer.resize(rmsBufferSize, 0.0f);
-    outputRmsBuffer.resize(rmsBufferSize, 0.0f);
-    rmsWritePos = 0;
-    autoGainCompensation.setCurrentAndTargetValue(1.0f);
+    // Initialize meter DC blockers with high-pass at 10Hz for more aggressive DC removal
+    *chain.inputMeterDCBlocker.state = *Coefficients::makeHighPass(spec.sampleRate, SampleType(10));
+    *chain.outputMeterDCBlocker.state = *Coefficients::makeHighPass(spec.sampleRate, SampleType(10));
+    
+    chain.meterBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
 }
 
 void SpiceAudioProcessor::releaseResources()
 {
-    oversampling.reset();
-    saturationProcessor.reset();
-    filterChain.reset();
-    cabinetSimulator.reset();
-    midSideProcessor.reset();
-    inputGain.reset();
-    dryWetMixer.reset();
-    cabinetDryWetMixer.reset();
-    outputGain.reset();
-    limiter.reset();
-    lowCutFilter.reset();
-    highCutFilter.reset();
-    dcBlocker.reset();
-    inputMeterDCBlocker.reset();
-    outputMeterDCBlocker.reset();
+    auto resetChain = [](auto& chain)
+    {
+        chain.engine.reset();
+        chain.inputMeterDCBlocker.reset();
+        chain.outputMeterDCBlocker.reset();
+    };
+    
+    resetChain(floatChain);
+    resetChain(doubleChain);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -335,8 +386,10 @@ bool SpiceAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
     juce::ignoreUnused (layouts);
     return true;
   #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Every stage handles arbitrary channel counts, so accept any layout from mono up to 9.1.6
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    
+    if (mainOutput.isDisabled() || mainOutput.size() > maxBusChannels)
         return false;
 
    #if ! JucePlugin_IsSynth
@@ -350,6 +403,17 @@ bool SpiceAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
 #endif
 
 void SpiceAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processChain(buffer);
+}
+
+void SpiceAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processChain(buffer);
+}
+
+template <typename SampleType>
+void SpiceAudioProcessor::processChain(juce::AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -358,452 +422,267 @@ void SpiceAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+    auto& chain = getChain<SampleType>();
     
-    // Create DC-blocked copies for meter measurement
-    juce::AudioBuffer<float> inputMeterBuffer = buffer;
-    juce::dsp::AudioBlock<float> inputMeterBlock(inputMeterBuffer);
-    juce::dsp::ProcessContextReplacing<float> inputMeterContext(inputMeterBlock);
-    inputMeterDCBlocker.process(inputMeterContext);
+    // Whole-block time next to the per-stage times the engine records
+    const StageProfiler::ScopedTimer blockTimer(stageProfiler.getIfEnabled(), "processBlock", buffer.getNumSamples());
     
-    // Apply noise gate to meter signal only (not audio output)
-    const float meterNoiseGate = 0.00001f; // -100dB threshold
-    for (int channel = 0; channel < inputMeterBuffer.getNumChannels(); ++channel)
-    {
-        auto* channelData = inputMeterBuffer.getWritePointer(channel);
-        for (int sample = 0; sample < inputMeterBuffer.getNumSamples(); ++sample)
-        {
-            if (std::abs(channelData[sample]) < meterNoiseGate)
-                channelData[sample] = 0.0f;
-        }
-    }
+    // Step any preset change and the morph before the parameters are read
+    presetCrossfader.process(buffer.getNumSamples());
+    presetMorpher.process(getPlainValue(*morphEnabledParam) > 0.5f, getPlainValue(*morphParam) / 100.0f);
     
-    // Measure input levels with DC-blocked signal
-    inputMeterSource.measureBlock(inputMeterBuffer);
+    auto parameters = getParameterValues();
+    applyMorphBlends(parameters);
     
-    {
-        const juce::ScopedLock sl(visualizationLock);
-        inputVisualizationBuffer = buffer;
-    }
+    // Stages the audio thread switched itself (preset fades, the morph) are compiled on the
+    // timer's next tick rather than once the publisher has told the parameter listeners
+    if (chain.engine.isGraphOutdated(parameters))
+        graphDirty.store(true);
     
-    // Update bypass smoothing
-    auto* bypassParam = apvts.getRawParameterValue("bypass");
-    bypassSmoothed.setTargetValue(bypassParam->load() > 0.5f ? 1.0f : 0.0f);
+    // Silent blocks skip the meters too; they decay on their own when no new measurements arrive
+    if (! chain.engine.beginBlock(buffer, parameters))
+        return;
     
-    // Check if we're fully bypassed (no ramping needed)
-    bool isFullyBypassed = bypassSmoothed.isSmoothing() == false && bypassSmoothed.getCurrentValue() > 0.5f;
+    measureLevels(chain.inputMeterDCBlocker, chain.meterBuffer, buffer, inputMeterSource);
     
-    // If fully bypassed, skip all processing
-    if (isFullyBypassed)
     {
-        // Measure output for meters (bypassed signal)
-        outputMeterSource.measureBlock(buffer);
+        const juce::SpinLock::ScopedTryLockType sl(visualizationLock);
         
-        {
-            const juce::ScopedLock sl(visualizationLock);
-            outputVisualizationBuffer = buffer;
-        }
-        
-        return; // Skip all processing - pure bypass
-    }
-    
-    // Create a copy of the dry input for bypass crossfading (only if ramping)
-    juce::AudioBuffer<float> dryBuffer;
-    if (bypassSmoothed.isSmoothing())
-    {
-        dryBuffer.makeCopyOf(buffer);
+        if (sl.isLocked())
+            inputVisualizationBuffer.makeCopyOf(buffer, true);
     }
     
-    // Apply pre-FX processing (filters and noise gate)
-    updatePreFXFilters(getSampleRate());
-    
-    // Apply low cut filter
-    if (lowCutParam->load() > 20.0f)
-        lowCutFilter.process(context);
+    chain.engine.process(buffer, parameters);
     
-    // Apply high cut filter  
-    if (highCutParam->load() < 20000.0f)
-        highCutFilter.process(context);
+    measureLevels(chain.outputMeterDCBlocker, chain.meterBuffer, buffer, outputMeterSource);
     
-    // Apply noise gate
-    if (gateEnabledParam->load() > 0.5f)
     {
-        auto gateThreshold = gateThresholdParam->load();
-        auto numChannels = block.getNumChannels();
-        auto numSamples = block.getNumSamples();
+        const juce::SpinLock::ScopedTryLockType sl(visualizationLock);
         
-        for (size_t channel = 0; channel < numChannels; ++channel)
-        {
-            auto* channelData = block.getChannelPointer(channel);
-            for (size_t sample = 0; sample < numSamples; ++sample)
-            {
-                channelData[sample] = applyNoiseGate(channelData[sample], static_cast<int>(channel), gateThreshold, true);
-            }
-        }
-    }
-    
-    // Store dry signal
-    dryWetMixer.pushDrySamples(block);
-    
-    int qualityLevel = static_cast<int>(*qualityParam);
-    
-    int oversamplingFactor = (qualityLevel == 0) ? 1 : (qualityLevel == 1) ? 2 : 4;
-    oversampling.updateQuality(oversamplingFactor, storedSpec);
-    
-    // Update smoothed parameters
-    inputGainSmoothed.setTargetValue(inputGainParam->load());
-    driveSmoothed.setTargetValue(driveParam->load());
-    mixSmoothed.setTargetValue(mixParam->load() / 100.0f);
-    outputSmoothed.setTargetValue(outputParam->load());
-    toneSmoothed.setTargetValue(toneParam->load() / 100.0f);
-    biasSmoothed.setTargetValue(biasParam->load() / 50.0f); // -1 to 1 range for stronger effect
-    
-    // If we're loading a preset, use longer smoothing times to avoid clicks
-    if (isLoadingPreset)
-    {
-        const double presetSmoothTime = 0.05; // 50ms for preset changes
-        inputGainSmoothed.reset(getSampleRate(), presetSmoothTime);
-        driveSmoothed.reset(getSampleRate(), presetSmoothTime);
-        mixSmoothed.reset(getSampleRate(), presetSmoothTime);
-        outputSmoothed.reset(getSampleRate(), presetSmoothTime);
-        toneSmoothed.reset(getSampleRate(), presetSmoothTime);
-        biasSmoothed.reset(getSampleRate(), presetSmoothTime);
-        bypassSmoothed.reset(getSampleRate(), presetSmoothTime);
-        autoGainCompensation.reset(getSampleRate(), presetSmoothTime);
-        isLoadingPreset = false; // Reset flag after applying smoothing
-    }
-    
-    // Skip to current values immediately for instant response (except bypass)
-    inputGainSmoothed.skip(buffer.getNumSamples());
-    driveSmoothed.skip(buffer.getNumSamples());
-    mixSmoothed.skip(buffer.getNumSamples());
-    outputSmoothed.skip(buffer.getNumSamples());
-    toneSmoothed.skip(buffer.getNumSamples());
-    biasSmoothed.skip(buffer.getNumSamples());
-    // Don't skip bypass smoothing - we want it to ramp
-    
-    // Apply input gain first, before any processing
-    inputGain.setGainDecibels(inputGainSmoothed.getCurrentValue());
-    inputGain.process(context);
-    
-    // Capture post-input-gain signal for auto-gain compensation
-    juce::AudioBuffer<float> preProcessingBuffer;
-    if (autoGainParam->load() > 0.5f)
-    {
-        preProcessingBuffer.makeCopyOf(buffer);
+        if (sl.isLocked())
+            outputVisualizationBuffer.makeCopyOf(buffer, true);
     }
+}
+
+template <typename SampleType>
+void SpiceAudioProcessor::measureLevels(ChannelLaneFilter<SampleType>& dcBlocker, juce::AudioBuffer<SampleType>& meterBuffer,
+                                        const juce::AudioBuffer<SampleType>& buffer, foleys::LevelMeterSource& meterSource)
+{
+    // Create DC-blocked copy for meter measurement
+    meterBuffer.makeCopyOf(buffer, true);
+    juce::dsp::AudioBlock<SampleType> meterBlock(meterBuffer);
+    dcBlocker.process(juce::dsp::ProcessContextReplacing<SampleType>(meterBlock));
     
-    // Apply mid-side processing if enabled
-    if (midSideEnabledParam->load() > 0.5f)
+    // Apply noise gate to meter signal only (not audio output)
+    const SampleType meterNoiseGate = SampleType(0.00001); // -100dB threshold
+    for (int channel = 0; channel < meterBuffer.getNumChannels(); ++channel)
     {
-        // Convert to mid-side
-        midSideProcessor.processStereoToMidSide(buffer);
-        
-        // Apply mid-side gains directly to the buffer
-        auto midGain = juce::Decibels::decibelsToGain(midGainParam->load());
-        auto sideGain = juce::Decibels::decibelsToGain(sideGainParam->load());
-        auto width = stereoWidthParam->load() / 100.0f; // Convert from 0-300% to 0-3
-        
-        auto* leftData = buffer.getWritePointer(0);   // Now contains mid
-        auto* rightData = buffer.getWritePointer(1);  // Now contains side
-        auto numSamples = buffer.getNumSamples();
-        
-        for (int sample = 0; sample < numSamples; ++sample)
+        auto* channelData = meterBuffer.getWritePointer(channel);
+        for (int sample = 0; sample < meterBuffer.getNumSamples(); ++sample)
         {
-            leftData[sample] *= midGain;   // Apply mid gain
-            rightData[sample] *= sideGain * width; // Apply side gain and width
+            if (std::abs(channelData[sample]) < meterNoiseGate)
+                channelData[sample] = SampleType(0);
         }
     }
     
-    // Update processors with current smoothed values
-    saturationProcessor.setDrive(driveSmoothed.getCurrentValue());
-    saturationProcessor.setModel(static_cast<SaturationProcessor::Model>(modelParam->load()));
-    saturationProcessor.setBias(biasSmoothed.getCurrentValue());
-    filterChain.setTone(toneSmoothed.getCurrentValue());
-    
-    // Process with oversampling
-    auto oversampledBlock = oversampling.processSamplesUp(block);
-    juce::dsp::ProcessContextReplacing<float> oversampledContext(oversampledBlock);
-    saturationProcessor.process(oversampledContext);
-    filterChain.process(oversampledContext);
-    oversampling.processSamplesDown(block);
-    
-    // Apply dry/wet mix
-    dryWetMixer.setWetMixProportion(mixSmoothed.getCurrentValue());
-    dryWetMixer.mixWetSamples(block);
-    
-    // Apply cabinet simulation (post-fx) with dry/wet mixing - license required
-    if (cabinetEnabledParam->load() > 0.5f)
+    meterSource.measureBlock(meterBuffer);
+}
+
+//==============================================================================
+SpiceParameters SpiceAudioProcessor::getParameterValues(const ParameterSnapshot* snapshot) const
+{
+    // Values in the parameters' own units, from the snapshot if there is one
+    auto valueOf = [snapshot](const juce::RangedAudioParameter& parameter)
     {
-        auto cabinetModel = static_cast<CabinetSimulator::CabinetModel>(static_cast<int>(cabinetModelParam->load()));
-        auto cabinetPresence = cabinetPresenceParam->load() / 100.0f; // Convert to 0-1 range
-        auto cabinetMix = cabinetMixParam->load() / 100.0f; // Convert to 0-1 range
-        
-        // Store dry signal for cabinet mixing
-        cabinetDryWetMixer.pushDrySamples(block);
+        const auto index = static_cast<size_t>(parameter.getParameterIndex());
         
-        cabinetSimulator.setCabinetModel(cabinetModel);
-        cabinetSimulator.setPresence(cabinetPresence);
-        cabinetSimulator.setResonance(0.5f); // Fixed resonance for simplicity
-        cabinetSimulator.process(context);
+        if (snapshot != nullptr && index < snapshot->size())
+            return parameter.convertFrom0to1((*snapshot)[index]);
         
-        // Apply cabinet dry/wet mix
-        cabinetDryWetMixer.setWetMixProportion(cabinetMix);
-        cabinetDryWetMixer.mixWetSamples(block);
-    }
-    
-    // Apply output gain with auto-gain compensation if enabled
-    float outputGainDb = outputSmoothed.getCurrentValue();
-    
-    if (autoGainParam->load() > 0.5f && preProcessingBuffer.getNumChannels() > 0)
-    {
-        // Update auto-gain compensation based on pre/post processing levels
-        updateAutoGainCompensation(preProcessingBuffer, buffer);
-        
-        // Apply compensation (convert linear gain to dB and add to output gain)
-        float compensationDb = juce::Decibels::gainToDecibels(autoGainCompensation.getNextValue());
-        outputGainDb += compensationDb;
-    }
-    
-    outputGain.setGainDecibels(outputGainDb);
-    outputGain.process(context);
-    
-    // Apply limiter if enabled
-    if (limiterEnabledParam->load() > 0.5f)
-    {
-        limiter.process(context);
-    }
-    
-    // Convert back from mid-side to stereo if mid-side processing was enabled
-    if (midSideEnabledParam->load() > 0.5f)
+        return getPlainValue(parameter);
+    };
+    
+    SpiceParameters parameters;
+    
+    parameters.inputGain = valueOf(*inputGainParam);
+    parameters.drive = valueOf(*driveParam);
+    parameters.mix = valueOf(*mixParam);
+    parameters.output = valueOf(*outputParam);
+    parameters.model = static_cast<int>(valueOf(*modelParam));
+    parameters.tone = valueOf(*toneParam);
+    parameters.bias = valueOf(*biasParam);
+    parameters.quality = static_cast<int>(valueOf(*qualityParam));
+    parameters.bypass = valueOf(*bypassParam) > 0.5f;
+    
+    parameters.lowCut = valueOf(*lowCutParam);
+    parameters.highCut = valueOf(*highCutParam);
+    parameters.lowCutSlope = static_cast<int>(valueOf(*lowCutSlopeParam));
+    parameters.highCutSlope = static_cast<int>(valueOf(*highCutSlopeParam));
+    
+    parameters.gateEnabled = valueOf(*gateEnabledParam) > 0.5f;
+    parameters.gateThreshold = valueOf(*gateThresholdParam);
+    parameters.gateHysteresis = valueOf(*gateHysteresisParam);
+    parameters.gateHold = valueOf(*gateHoldParam);
+    parameters.gateLookahead = valueOf(*gateLookaheadParam);
+    
+    parameters.cabinetEnabled = valueOf(*cabinetEnabledParam) > 0.5f;
+    parameters.cabinetModel = static_cast<int>(valueOf(*cabinetModelParam));
+    parameters.cabinetPresence = valueOf(*cabinetPresenceParam);
+    parameters.cabinetMix = valueOf(*cabinetMixParam);
+    
+    parameters.limiterEnabled = valueOf(*limiterEnabledParam) > 0.5f;
+    
+    parameters.midSideEnabled = valueOf(*midSideEnabledParam) > 0.5f;
+    parameters.midGain = valueOf(*midGainParam);
+    parameters.sideGain = valueOf(*sideGainParam);
+    parameters.stereoWidth = valueOf(*stereoWidthParam);
+    
+    parameters.autoGain = valueOf(*autoGainParam) > 0.5f;
+    parameters.autoGainMode = static_cast<int>(valueOf(*autoGainModeParam));
+    
+    parameters.multibandEnabled = valueOf(*multibandEnabledParam) > 0.5f;
+    parameters.lowMidCrossover = valueOf(*lowMidCrossoverParam);
+    parameters.midHighCrossover = valueOf(*midHighCrossoverParam);
+    
+    for (size_t band = 0; band < bandDriveParams.size(); ++band)
     {
-        midSideProcessor.processMidSideToStereo(buffer);
+        parameters.bandDrive[band] = valueOf(*bandDriveParams[band]);
+        parameters.bandModel[band] = static_cast<int>(valueOf(*bandModelParams[band]));
     }
     
-    // Apply DC blocking filter to remove any DC offset
-    dcBlocker.process(context);
-    
-    // Apply smooth bypass crossfade only if we're ramping
-    if (bypassSmoothed.isSmoothing())
+    return parameters;
+}
+
+void SpiceAudioProcessor::applyMorphBlends(SpiceParameters& parameters) const
+{
+    auto toChoiceBlend = [this](const juce::RangedAudioParameter& parameter)
     {
-        auto numSamples = buffer.getNumSamples();
-        auto numChannels = buffer.getNumChannels();
+        const auto& blend = presetMorpher.getBlend(parameter);
         
-        for (int channel = 0; channel < numChannels; ++channel)
-        {
-            auto* wetData = buffer.getWritePointer(channel);
-            auto* dryData = dryBuffer.getReadPointer(channel);
-            
-            for (int sample = 0; sample < numSamples; ++sample)
-            {
-                auto bypassAmount = bypassSmoothed.getNextValue();
-                auto wetAmount = 1.0f - bypassAmount;
-                
-                // Crossfade between wet (processed) and dry (bypass) signals
-                wetData[sample] = wetData[sample] * wetAmount + dryData[sample] * bypassAmount;
-            }
-        }
-    }
-    
-    // Create DC-blocked copy for output meter measurement
-    juce::AudioBuffer<float> outputMeterBuffer = buffer;
-    juce::dsp::AudioBlock<float> outputMeterBlock(outputMeterBuffer);
-    juce::dsp::ProcessContextReplacing<float> outputMeterContext(outputMeterBlock);
-    outputMeterDCBlocker.process(outputMeterContext);
+        if (! blend.isActive())
+            return SpiceParameters::Blend {};
+        
+        return SpiceParameters::Blend { juce::roundToInt(parameter.convertFrom0to1(blend.from)),
+                                        juce::roundToInt(parameter.convertFrom0to1(blend.to)),
+                                        blend.weight };
+    };
     
-    // Apply noise gate to meter signal only (not audio output)
-    for (int channel = 0; channel < outputMeterBuffer.getNumChannels(); ++channel)
-    {
-        auto* channelData = outputMeterBuffer.getWritePointer(channel);
-        for (int sample = 0; sample < outputMeterBuffer.getNumSamples(); ++sample)
-        {
-            if (std::abs(channelData[sample]) < meterNoiseGate)
-                channelData[sample] = 0.0f;
-        }
-    }
+    parameters.modelBlend = toChoiceBlend(*modelParameter);
+    parameters.cabinetModelBlend = toChoiceBlend(*cabinetModelParameter);
     
-    // Measure output levels with DC-blocked signal
-    outputMeterSource.measureBlock(outputMeterBuffer);
+    // Morphing between two qualities runs at the higher one; the factors only differ in
+    // aliasing, so a second oversampled engine would cost double for no audible blend
+    const auto& qualityBlend = presetMorpher.getBlend(*qualityParameter);
     
-    {
-        const juce::ScopedLock sl(visualizationLock);
-        outputVisualizationBuffer = buffer;
-    }
+    if (qualityBlend.isActive())
+        parameters.quality = juce::roundToInt(qualityParameter->convertFrom0to1(juce::jmax(qualityBlend.from, qualityBlend.to)));
 }
 
-bool SpiceAudioProcessor::hasEditor() const
+float SpiceAudioProcessor::getGateInputLevel() const
 {
-    return true;
+    return isUsingDoublePrecision() ? doubleChain.engine.getGateInputLevel()
+                                    : floatChain.engine.getGateInputLevel();
 }
 
-juce::AudioProcessorEditor* SpiceAudioProcessor::createEditor()
+bool SpiceAudioProcessor::isGateOpen() const
 {
-    return new SpiceAudioProcessorEditor (*this);
+    return isUsingDoublePrecision() ? doubleChain.engine.isGateOpen()
+                                    : floatChain.engine.isGateOpen();
 }
 
-void SpiceAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+//==============================================================================
+void SpiceAudioProcessor::rebuildProcessingGraph(const SpiceParameters& parameters)
 {
-    auto state = apvts.copyState();
-    
-    // Add current preset to the saved state
-    state.setProperty("currentPreset", presetManager.getCurrentPreset(), nullptr);
-    
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    floatChain.engine.compileGraph(parameters);
+    doubleChain.engine.compileGraph(parameters);
 }
 
-void SpiceAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+void SpiceAudioProcessor::updateReportedLatency()
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    // Report the lookahead of the graph the audio thread actually runs, so the host never
+    // compensates for a graph that has not been swapped in yet
+    const auto latency = isUsingDoublePrecision() ? doubleChain.engine.getLatencySamples()
+                                                  : floatChain.engine.getLatencySamples();
     
-    if (xmlState.get() != nullptr)
-        if (xmlState->hasTagName(apvts.state.getType()))
-        {
-            auto newState = juce::ValueTree::fromXml(*xmlState);
-            apvts.replaceState(newState);
-            
-            // Restore the current preset if it was saved
-            if (newState.hasProperty("currentPreset"))
-            {
-                auto savedPresetName = newState.getProperty("currentPreset").toString();
-                if (savedPresetName.isNotEmpty())
-                {
-                    presetManager.loadPreset(savedPresetName);
-                }
-            }
-        }
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
 }
 
-void SpiceAudioProcessor::updatePreFXFilters(double sampleRate)
+void SpiceAudioProcessor::parameterChanged(const juce::String&, float)
 {
-    // Update low cut filter
-    auto lowCutFreq = lowCutParam->load();
-    if (lowCutFreq > 20.0f)
-    {
-        *lowCutFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(sampleRate, lowCutFreq);
-    }
-    
-    // Update high cut filter
-    auto highCutFreq = highCutParam->load();
-    if (highCutFreq < 20000.0f)
-    {
-        *highCutFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(sampleRate, highCutFreq);
-    }
+    // May be called from the audio thread, where neither compiling nor posting a message
+    // is allowed, so the change is only flagged for the timer
+    graphDirty.store(true);
 }
 
-float SpiceAudioProcessor::applyNoiseGate(float sample, int channel, float threshold, bool enabled)
+void SpiceAudioProcessor::compileGraphForSnapshot(const ParameterSnapshot& snapshot)
 {
-    if (!enabled || channel >= static_cast<int>(gateEnvelope.size()))
-        return sample;
-    
-    // Convert threshold from dB to linear
-    auto thresholdLinear = juce::Decibels::decibelsToGain(threshold);
-    
-    // Get absolute level of current sample
-    auto level = std::abs(sample);
-    
-    // Update gate input level for LED (only from first channel to avoid rapid changes)
-    if (channel == 0)
-    {
-        gateInputLevel.store(level);
-    }
-    
-    // Simple gate with fast attack, medium release
-    auto& envelope = gateEnvelope[channel];
-    auto& gateSmooth = smoothedGate[channel];
-    
-    if (level > thresholdLinear)
-    {
-        // Fast attack (1ms)
-        auto attackCoeff = std::exp(-1.0f / (getSampleRate() * 0.001f));
-        envelope = level + attackCoeff * (envelope - level);
-    }
-    else
-    {
-        // Medium release (50ms)
-        auto releaseCoeff = std::exp(-1.0f / (getSampleRate() * 0.05f));
-        envelope = envelope * releaseCoeff;
-    }
-    
-    // Apply gate
-    auto gateReduction = envelope > thresholdLinear ? 1.0f : 0.0f;
-    
-    // Smooth the gate to avoid clicks
-    auto smoothingCoeff = std::exp(-1.0f / (getSampleRate() * 0.001f));
-    gateSmooth = gateReduction + smoothingCoeff * (gateSmooth - gateReduction);
+    // Compiled before the snapshot is queued, so the audio thread can take the graph in the
+    // same block that switches the stages
+    const auto parameters = getParameterValues(&snapshot);
     
-    return sample * gateSmooth;
+    if (isGraphOutdated(parameters))
+        rebuildProcessingGraph(parameters);
 }
 
-void SpiceAudioProcessor::updateAutoGainCompensation(const juce::AudioBuffer<float>& inputBuffer, 
-                                                     const juce::AudioBuffer<float>& outputBuffer)
+bool SpiceAudioProcessor::isGraphOutdated(const SpiceParameters& parameters) const
 {
-    // Calculate RMS for input and output
-    float inputSum = 0.0f;
-    float outputSum = 0.0f;
-    int numSamples = inputBuffer.getNumSamples();
-    int numChannels = inputBuffer.getNumChannels();
-    
-    // Calculate sum of squares for this block
-    for (int channel = 0; channel < numChannels; ++channel)
+    return isUsingDoublePrecision() ? doubleChain.engine.isGraphOutdated(parameters)
+                                    : floatChain.engine.isGraphOutdated(parameters);
+}
+
+void SpiceAudioProcessor::timerCallback()
+{
+    // A queued snapshot already has its graph; the parameters catch up once the audio
+    // thread picks it up, so the flag is left for the next tick
+    if (! presetCrossfader.hasQueuedSnapshot() && graphDirty.exchange(false))
     {
-        const float* inputData = inputBuffer.getReadPointer(channel);
-        const float* outputData = outputBuffer.getReadPointer(channel);
+        const auto parameters = getParameterValues();
         
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            float inputSample = inputData[sample];
-            float outputSample = outputData[sample];
-            
-            inputSum += inputSample * inputSample;
-            outputSum += outputSample * outputSample;
-        }
+        if (isGraphOutdated(parameters))
+            rebuildProcessingGraph(parameters);
     }
     
-    // Average across channels
-    inputSum /= numChannels;
-    outputSum /= numChannels;
-    
-    // Add to RMS buffers
-    for (int i = 0; i < numSamples; ++i)
-    {
-        if (rmsWritePos >= rmsBufferSize)
-            rmsWritePos = 0;
-            
-        inputRmsBuffer[rmsWritePos] = inputSum / numSamples;
-        outputRmsBuffer[rmsWritePos] = outputSum / numSamples;
-        rmsWritePos++;
-    }
-    
-    // Calculate RMS values
-    inputRmsLevel = calculateRMS(inputRmsBuffer);
-    outputRmsLevel = calculateRMS(outputRmsBuffer);
-    
-    // Calculate gain compensation
-    if (outputRmsLevel > 0.0001f && inputRmsLevel > 0.0001f) // Avoid division by zero
-    {
-        float targetGain = inputRmsLevel / outputRmsLevel;
-        
-        // Limit compensation range to ±12dB
-        targetGain = juce::jlimit(0.25f, 4.0f, targetGain);
-        
-        // Smooth the compensation
-        autoGainCompensation.setTargetValue(targetGain);
-    }
+    // Follows the audio thread once it has taken a graph with a new latency
+    updateReportedLatency();
 }
 
-float SpiceAudioProcessor::calculateRMS(const std::vector<float>& buffer)
+bool SpiceAudioProcessor::hasEditor() const
+{
+    return true;
+}
+
+juce::AudioProcessorEditor* SpiceAudioProcessor::createEditor()
 {
-    float sum = 0.0f;
+    return new SpiceAudioProcessorEditor (*this);
+}
+
+void SpiceAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    stateSerializer.write(destData, presetManager.getState());
+}
+
+void SpiceAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    // The saved values already include any edits made after the preset was loaded, so
+    // only the preset name, the morph presets and the A/B slots are restored; the preset
+    // itself is never reloaded from disk
+    StateSerializer::PresetState presetState;
     
-    for (float value : buffer)
+    if (! stateSerializer.read(data, sizeInBytes, presetState))
     {
-        sum += value;
+        // Sessions saved before the binary format
+        std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+        
+        if (xmlState == nullptr || ! xmlState->hasTagName(apvts.state.getType()))
+            return;
+        
+        auto newState = juce::ValueTree::fromXml(*xmlState);
+        apvts.replaceState(newState);
+        presetState.currentPreset = newState.getProperty("currentPreset").toString();
     }
     
-    float mean = sum / buffer.size();
-    return std::sqrt(mean);
+    presetManager.setState(presetState);
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -2,15 +2,19 @@
 
 #include <JuceHeader.h>
 #include "ff_meters.h"
-#include "DSP/SaturationProcessor.h"
-#include "DSP/Oversampling.h"
-#include "DSP/FilterChain.h"
-#include "DSP/CabinetSimulator.h"
-#include "DSP/MidSideProcessor.h"
+#include "DSP/SpiceEngine.h"
+#include "DSP/ChannelLaneFilter.h"
+#include "DSP/StageProfiler.h"
 #include "PresetManager.h"
+#include "ParameterPublisher.h"
+#include "PresetCrossfader.h"
+#include "PresetMorpher.h"
+#include "StateSerializer.h"
     
 
-class SpiceAudioProcessor : public juce::AudioProcessor
+class SpiceAudioProcessor : public juce::AudioProcessor,
+                            private juce::AudioProcessorValueTreeState::Listener,
+                            private juce::Timer
 {
 public:
     SpiceAudioProcessor();
@@ -24,6 +28,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -57,129 +63,164 @@ public:
     // Visualization buffers
     void copyInputBuffer(juce::AudioBuffer<float>& dest) const
     {
-        const juce::ScopedLock sl(visualizationLock);
+        const juce::SpinLock::ScopedLockType sl(visualizationLock);
         dest = inputVisualizationBuffer;
     }
     
     void copyOutputBuffer(juce::AudioBuffer<float>& dest) const
     {
-        const juce::ScopedLock sl(visualizationLock);
+        const juce::SpinLock::ScopedLockType sl(visualizationLock);
         dest = outputVisualizationBuffer;
     }
     
     // Gate level monitoring for LED
-    float getGateInputLevel() const { return gateInputLevel.load(); }
+    float getGateInputLevel() const;
+    bool isGateOpen() const;
     
-    // Preset loading mode for smoother transitions
-    void setPresetLoadingMode(bool loading) { isLoadingPreset = loading; }
+    // Applies preset snapshots from the audio thread
+    PresetCrossfader& getPresetCrossfader() { return presetCrossfader; }
+    
+    // Morphs the parameters between stored snapshots, driven by the morph parameter
+    PresetMorpher& getPresetMorpher() { return presetMorpher; }
+    
+    // Opt-in per-stage CPU timing, shared by both precisions
+    StageProfiler& getStageProfiler() { return stageProfiler; }
 
 private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     
-    void updatePreFXFilters(double sampleRate);
-    float applyNoiseGate(float sample, int channel, float threshold, bool enabled);
-    void updateAutoGainCompensation(const juce::AudioBuffer<float>& inputBuffer, 
-                                   const juce::AudioBuffer<float>& outputBuffer);
-    float calculateRMS(const std::vector<float>& buffer);
-    
-    SaturationProcessor saturationProcessor;
-    Oversampling oversampling;
-    FilterChain filterChain;
-    CabinetSimulator cabinetSimulator;
-    MidSideProcessor midSideProcessor;
-    
-    juce::dsp::Gain<float> inputGain;
-    juce::dsp::DryWetMixer<float> dryWetMixer;
-    juce::dsp::DryWetMixer<float> cabinetDryWetMixer;
-    juce::dsp::Gain<float> outputGain;
-    juce::dsp::Limiter<float> limiter;
-    
-    // Pre-FX filters
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> lowCutFilter;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> highCutFilter;
-    
-    // Noise gate
-    std::vector<float> gateEnvelope;
-    std::vector<float> smoothedGate;
-    std::atomic<float> gateInputLevel {0.0f};
-    
-    // DC blocking filters
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> dcBlocker;
-    
-    // DC blocking for meter displays
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> inputMeterDCBlocker;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, 
-                                   juce::dsp::IIR::Coefficients<float>> outputMeterDCBlocker;
-    
-    std::atomic<float>* inputGainParam = nullptr;
-    std::atomic<float>* driveParam = nullptr;
-    std::atomic<float>* mixParam = nullptr;
-    std::atomic<float>* outputParam = nullptr;
-    std::atomic<float>* modelParam = nullptr;
-    std::atomic<float>* toneParam = nullptr;
-    std::atomic<float>* biasParam = nullptr;
-    std::atomic<float>* qualityParam = nullptr;
-    // std::atomic<float>* compactViewParam = nullptr;
-    std::atomic<float>* lowCutParam = nullptr;
-    std::atomic<float>* highCutParam = nullptr;
-    std::atomic<float>* gateThresholdParam = nullptr;
-    std::atomic<float>* gateEnabledParam = nullptr;
-    std::atomic<float>* cabinetModelParam = nullptr;
-    std::atomic<float>* cabinetPresenceParam = nullptr;
-    std::atomic<float>* cabinetMixParam = nullptr;
-    std::atomic<float>* cabinetEnabledParam = nullptr;
-    std::atomic<float>* limiterEnabledParam = nullptr;
-    std::atomic<float>* midSideEnabledParam = nullptr;
-    std::atomic<float>* midGainParam = nullptr;
-    std::atomic<float>* sideGainParam = nullptr;
-    std::atomic<float>* stereoWidthParam = nullptr;
-    std::atomic<float>* autoGainParam = nullptr;
-    
-    // Parameter smoothing
-    juce::SmoothedValue<float> inputGainSmoothed;
-    juce::SmoothedValue<float> driveSmoothed;
-    juce::SmoothedValue<float> mixSmoothed;
-    juce::SmoothedValue<float> outputSmoothed;
-    juce::SmoothedValue<float> toneSmoothed;
-    juce::SmoothedValue<float> biasSmoothed;
-    juce::SmoothedValue<float> bypassSmoothed;
-    
-    // Auto-gain compensation
-    juce::SmoothedValue<float> autoGainCompensation;
-    float inputRmsLevel = 0.0f;
-    float outputRmsLevel = 0.0f;
-    static constexpr float rmsWindowMs = 300.0f; // 300ms RMS window
-    std::vector<float> inputRmsBuffer;
-    std::vector<float> outputRmsBuffer;
-    int rmsBufferSize = 0;
-    int rmsWritePos = 0;
+    // Per-precision DSP state. Only the chain matching the host's processing
+    // precision is prepared, so double-precision hosts never convert samples.
+    template <typename SampleType>
+    struct DSPChain
+    {
+        SpiceEngine<SampleType> engine;
+        
+        // DC blocking for meter displays
+        ChannelLaneFilter<SampleType> inputMeterDCBlocker;
+        ChannelLaneFilter<SampleType> outputMeterDCBlocker;
+        
+        // Scratch buffer allocated in prepareToPlay
+        juce::AudioBuffer<SampleType> meterBuffer;
+    };
+    
+    template <typename SampleType>
+    DSPChain<SampleType>& getChain()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleChain;
+        else
+            return floatChain;
+    }
+    
+    template <typename SampleType>
+    void prepareChain(DSPChain<SampleType>& chain, const juce::dsp::ProcessSpec& spec);
+    
+    template <typename SampleType>
+    void processChain(juce::AudioBuffer<SampleType>& buffer);
+    
+    /// DC-block and gate a copy of the block, then feed it to a level meter
+    template <typename SampleType>
+    void measureLevels(ChannelLaneFilter<SampleType>& dcBlocker, juce::AudioBuffer<SampleType>& meterBuffer,
+                       const juce::AudioBuffer<SampleType>& buffer, foleys::LevelMeterSource& meterSource);
+    
+    /// Current parameter values for the engine, or the values a snapshot would set
+    SpiceParameters getParameterValues(const ParameterSnapshot* snapshot = nullptr) const;
+    
+    /// Value in the parameter's own units, lock-free
+    static float getPlainValue(const juce::RangedAudioParameter& parameter)
+    {
+        return parameter.convertFrom0to1(parameter.getValue());
+    }
+    
+    /// Hand the morph's two-engine blends to the engine parameters (audio thread)
+    void applyMorphBlends(SpiceParameters& parameters) const;
+    
+    // Widest bus accepted by isBusesLayoutSupported (9.1.6)
+    static constexpr int maxBusChannels = SpiceEngine<float>::maxChannels;
+    
+    void rebuildProcessingGraph(const SpiceParameters& parameters);
+    void compileGraphForSnapshot(const ParameterSnapshot& snapshot);
+    bool isGraphOutdated(const SpiceParameters& parameters) const;
+    void updateReportedLatency();
+    
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void timerCallback() override;
+    
+    // Set by parameter changes on any thread, the timer compiles the graph on the message thread
+    std::atomic<bool> graphDirty { false };
+    static constexpr int graphUpdateIntervalMs = 10;
+    
+    DSPChain<float> floatChain;
+    DSPChain<double> doubleChain;
+    
+    // Read through the parameters rather than the APVTS raw values, so the engine
+    // also sees values the audio thread set and the ParameterPublisher has not sent yet
+    juce::RangedAudioParameter* inputGainParam = nullptr;
+    juce::RangedAudioParameter* driveParam = nullptr;
+    juce::RangedAudioParameter* mixParam = nullptr;
+    juce::RangedAudioParameter* outputParam = nullptr;
+    juce::RangedAudioParameter* modelParam = nullptr;
+    juce::RangedAudioParameter* toneParam = nullptr;
+    juce::RangedAudioParameter* biasParam = nullptr;
+    juce::RangedAudioParameter* qualityParam = nullptr;
+    juce::RangedAudioParameter* bypassParam = nullptr;
+    // juce::RangedAudioParameter* compactViewParam = nullptr;
+    juce::RangedAudioParameter* lowCutParam = nullptr;
+    juce::RangedAudioParameter* highCutParam = nullptr;
+    juce::RangedAudioParameter* lowCutSlopeParam = nullptr;
+    juce::RangedAudioParameter* highCutSlopeParam = nullptr;
+    juce::RangedAudioParameter* gateThresholdParam = nullptr;
+    juce::RangedAudioParameter* gateEnabledParam = nullptr;
+    juce::RangedAudioParameter* gateHysteresisParam = nullptr;
+    juce::RangedAudioParameter* gateHoldParam = nullptr;
+    juce::RangedAudioParameter* gateLookaheadParam = nullptr;
+    juce::RangedAudioParameter* cabinetModelParam = nullptr;
+    juce::RangedAudioParameter* cabinetPresenceParam = nullptr;
+    juce::RangedAudioParameter* cabinetMixParam = nullptr;
+    juce::RangedAudioParameter* cabinetEnabledParam = nullptr;
+    juce::RangedAudioParameter* limiterEnabledParam = nullptr;
+    juce::RangedAudioParameter* midSideEnabledParam = nullptr;
+    juce::RangedAudioParameter* midGainParam = nullptr;
+    juce::RangedAudioParameter* sideGainParam = nullptr;
+    juce::RangedAudioParameter* stereoWidthParam = nullptr;
+    juce::RangedAudioParameter* autoGainParam = nullptr;
+    juce::RangedAudioParameter* autoGainModeParam = nullptr;
+    juce::RangedAudioParameter* multibandEnabledParam = nullptr;
+    juce::RangedAudioParameter* lowMidCrossoverParam = nullptr;
+    juce::RangedAudioParameter* midHighCrossoverParam = nullptr;
+    std::array<juce::RangedAudioParameter*, 3> bandDriveParams {};
+    std::array<juce::RangedAudioParameter*, 3> bandModelParams {};
+    juce::RangedAudioParameter* morphEnabledParam = nullptr;
+    juce::RangedAudioParameter* morphParam = nullptr;
+    
+    // Discrete parameters the morph crossfades with a second engine
+    juce::RangedAudioParameter* modelParameter = nullptr;
+    juce::RangedAudioParameter* cabinetModelParameter = nullptr;
+    juce::RangedAudioParameter* qualityParameter = nullptr;
     
     // Metering with ff_meters
     foleys::LevelMeterSource inputMeterSource;
     foleys::LevelMeterSource outputMeterSource;
     
-    // Visualization
-    mutable juce::CriticalSection visualizationLock;
+    // Visualization. The audio thread only ever tries the lock and skips the copy
+    // while the editor holds it, so it never waits.
+    mutable juce::SpinLock visualizationLock;
     juce::AudioBuffer<float> inputVisualizationBuffer;
     juce::AudioBuffer<float> outputVisualizationBuffer;
     
-    // Stored spec for dynamic quality updates
-    juce::dsp::ProcessSpec storedSpec;
-    
     // Preset manager
     PresetManager presetManager;
+    ParameterPublisher parameterPublisher;
+    PresetCrossfader presetCrossfader;
+    PresetMorpher presetMorpher;
+    StateSerializer stateSerializer;
+    StageProfiler stageProfiler;
 
     
     // Trial notification state (persists across editor recreation)
     bool trialNotificationDismissed = false;
     
-    // Preset loading state
-    bool isLoadingPreset = false;
-    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpiceAudioProcessor)
 };
@@ -0,0 +1,138 @@
+#include "PresetCrossfader.h"
+
+void PresetCrossfader::setParameters(const juce::Array<juce::AudioProcessorParameter*>& newParameters,
+                                     ParameterPublisher& parameterPublisher)
+{
+    jassert(newParameters.size() <= maxParameters);
+
+    publisher = &parameterPublisher;
+
+    parameters.clear();
+    isDiscrete.clear();
+
+    for (auto* parameter : newParameters)
+    {
+        if (static_cast<int>(parameters.size()) == maxParameters)
+            break;
+
+        parameters.push_back(parameter);
+        isDiscrete.push_back(parameter->isDiscrete() || parameter->isBoolean());
+    }
+}
+
+void PresetCrossfader::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+}
+
+bool PresetCrossfader::isAudioRunning() const
+{
+    return juce::Time::getMillisecondCounter() - lastBlockTime.load() < audioTimeoutMs;
+}
+
+void PresetCrossfader::apply(const ParameterSnapshot& snapshot, double crossfadeSeconds)
+{
+    const auto numValues = juce::jmin(snapshot.size(), parameters.size());
+
+    if (onApply != nullptr)
+        onApply(snapshot);
+
+    // Requests from before this one are dropped by the audio thread
+    const auto requestGeneration = ++generation;
+
+    if (crossfadeSeconds > 0.0 && isAudioRunning())
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+        {
+            auto& request = requests[static_cast<size_t>(scope.startIndex1)];
+            std::copy(snapshot.begin(), snapshot.begin() + static_cast<std::ptrdiff_t>(numValues), request.values.begin());
+            request.crossfadeSeconds = crossfadeSeconds;
+            request.generation = requestGeneration;
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < numValues; ++i)
+        if (parameters[i]->getValue() != snapshot[i])
+            parameters[i]->setValueNotifyingHost(snapshot[i]);
+}
+
+void PresetCrossfader::process(int numSamples)
+{
+    lastBlockTime.store(juce::Time::getMillisecondCounter());
+
+    // Only the most recent request matters
+    const Request* latest = nullptr;
+    const auto scope = fifo.read(fifo.getNumReady());
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+        latest = &requests[static_cast<size_t>(scope.startIndex1 + i)];
+
+    for (int i = 0; i < scope.blockSize2; ++i)
+        latest = &requests[static_cast<size_t>(scope.startIndex2 + i)];
+
+    // The read scope stays open until this function returns, so the slot cannot be reused yet
+    if (latest != nullptr && latest->generation == generation.load())
+        startFade(*latest);
+
+    if (! fading)
+        return;
+
+    // A later snapshot was applied directly, so this fade is stale
+    if (fadeGeneration != generation.load())
+    {
+        publishUnsentValues();
+        fading = false;
+        return;
+    }
+
+    fadePosition = juce::jmin(fadeLength, fadePosition + numSamples);
+    const auto progress = static_cast<float>(fadePosition) / static_cast<float>(fadeLength);
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        if (isDiscrete[i] || fadeStart[i] == fadeTarget[i])
+            continue;
+
+        // The steps in between are set quietly; only the final value is published
+        publisher->setValueQuietly(static_cast<int>(i), fadeStart[i] + (fadeTarget[i] - fadeStart[i]) * progress);
+        unsent[i] = true;
+    }
+
+    fading = fadePosition < fadeLength;
+
+    if (! fading)
+        publishUnsentValues();
+}
+
+void PresetCrossfader::publishUnsentValues()
+{
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        if (unsent[i])
+        {
+            publisher->setValue(static_cast<int>(i), parameters[i]->getValue());
+            unsent[i] = false;
+        }
+    }
+}
+
+void PresetCrossfader::startFade(const Request& request)
+{
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        fadeStart[i] = parameters[i]->getValue();
+        fadeTarget[i] = request.values[i];
+
+        // Discrete parameters cannot be interpolated, they switch as the fade starts
+        if (isDiscrete[i] && fadeStart[i] != fadeTarget[i])
+            publisher->setValue(static_cast<int>(i), fadeTarget[i]);
+    }
+
+    fadeGeneration = request.generation;
+    fadeLength = juce::jmax(1, juce::roundToInt(request.crossfadeSeconds * sampleRate));
+    fadePosition = 0;
+    fading = true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <functional>
+#include <vector>
+#include "ParameterPublisher.h"
+
+/// Normalised value of every plugin parameter, in AudioProcessor::getParameters() order
+using ParameterSnapshot = std::vector<float>;
+
+/// Applies parameter snapshots from the audio thread.
+///
+/// A snapshot is copied into a small lock-free FIFO and picked up at the start of the next
+/// block, so switching presets costs the message thread one copy instead of an APVTS state
+/// replacement. Continuous parameters then fade from their current value to the snapshot
+/// over the crossfade time, one step per block; discrete parameters switch as the fade starts.
+/// Values set from the audio thread go through a ParameterPublisher, so the host and the
+/// editor hear about them from the message thread. They are told about each parameter once,
+/// with its final value, so recalling a preset does not stream automation to the host.
+class PresetCrossfader
+{
+public:
+    static constexpr int maxParameters = 64;
+    static constexpr double defaultCrossfadeSeconds = 0.05;
+
+    PresetCrossfader() = default;
+
+    /// Parameters the snapshots refer to, and the publisher the audio thread sets them
+    /// through (before processing starts)
+    void setParameters(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                       ParameterPublisher& publisher);
+
+    void prepare(double sampleRate);
+
+    /// Apply a snapshot. With a crossfade time and a running audio thread the snapshot is
+    /// queued for it; otherwise every parameter is set right away from the calling thread,
+    /// replacing any fade that is queued or running.
+    void apply(const ParameterSnapshot& snapshot, double crossfadeSeconds);
+
+    /// Start queued snapshots and advance the running fade (audio thread)
+    void process(int numSamples);
+
+    /// True while blocks are being processed
+    bool isAudioRunning() const;
+
+    /// True while a snapshot waits for the audio thread to pick it up
+    bool hasQueuedSnapshot() const { return fifo.getNumReady() > 0; }
+
+    /// Called on the message thread with every snapshot before it is applied, so the owner
+    /// can get ready for its values (the processor compiles the processing graph for them)
+    std::function<void(const ParameterSnapshot&)> onApply;
+
+private:
+    struct Request
+    {
+        std::array<float, maxParameters> values {};
+        double crossfadeSeconds = 0.0;
+        juce::uint32 generation = 0;
+    };
+
+    static constexpr int queueSize = 4;
+    static constexpr juce::uint32 audioTimeoutMs = 250;
+
+    void startFade(const Request& request);
+    void publishUnsentValues();
+
+    std::vector<juce::AudioProcessorParameter*> parameters;
+    std::vector<bool> isDiscrete;
+    ParameterPublisher* publisher = nullptr;
+    double sampleRate = 44100.0;
+
+    // Message thread to audio thread
+    juce::AbstractFifo fifo { queueSize };
+    std::array<Request, queueSize> requests;
+    std::atomic<juce::uint32> generation { 0 };
+    std::atomic<juce::uint32> lastBlockTime { 0 };
+
+    // Running fade (audio thread)
+    std::array<float, maxParameters> fadeStart {};
+    std::array<float, maxParameters> fadeTarget {};
+    std::array<bool, maxParameters> unsent {};     // Set quietly, the publisher has not heard yet
+    juce::uint32 fadeGeneration = 0;
+    int fadeLength = 0;
+    int fadePosition = 0;
+    bool fading = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetCrossfader)
+};
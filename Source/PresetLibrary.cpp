@@ -0,0 +1,280 @@
+#include "PresetLibrary.h"
+#include <algorithm>
+
+int PresetLibrary::Index::indexOf(const juce::String& name) const
+{
+    auto first = std::lower_bound(entries.begin(), entries.end(), name,
+                                  [](const Entry& entry, const juce::String& key) { return entry.name.compareIgnoreCase(key) < 0; });
+
+    for (auto it = first; it != entries.end() && it->name.equalsIgnoreCase(name); ++it)
+        if (it->name == name)
+            return static_cast<int>(std::distance(entries.begin(), it));
+
+    return -1;
+}
+
+PresetLibrary::PresetLibrary()
+    : juce::Thread("Preset Watcher"),
+      index(std::make_shared<const Index>())
+{
+}
+
+PresetLibrary::~PresetLibrary()
+{
+    // Lets pending preset writes finish
+    stopThread(5000);
+}
+
+juce::File PresetLibrary::getPresetsDirectory()
+{
+    auto documentsDir = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory);
+    return documentsDir.getChildFile("Datanoise/Spice/Presets");
+}
+
+std::shared_ptr<const PresetLibrary::Index> PresetLibrary::getIndex()
+{
+    if (! complete.load())
+        startWatching();
+
+    const juce::ScopedLock sl(lock);
+    return index;
+}
+
+void PresetLibrary::rescan()
+{
+    startWatching();
+    notify();
+}
+
+void PresetLibrary::addChangeListener(juce::ChangeListener* listener)
+{
+    juce::ChangeBroadcaster::addChangeListener(listener);
+
+    {
+        const juce::ScopedLock sl(lock);
+        ++numListeners;
+    }
+
+    startWatching();
+}
+
+void PresetLibrary::removeChangeListener(juce::ChangeListener* listener)
+{
+    juce::ChangeBroadcaster::removeChangeListener(listener);
+
+    const juce::ScopedLock sl(lock);
+    jassert(numListeners > 0);
+    --numListeners;
+
+    // Wake the watcher so it stops polling for nobody
+    if (numListeners == 0)
+        notify();
+}
+
+void PresetLibrary::startWatching()
+{
+    {
+        const juce::ScopedLock sl(lock);
+
+        if (watching)
+            return;
+
+        watching = true;
+    }
+
+    // A watcher that has just decided to stop may still be on its way out
+    waitForThreadToExit(-1);
+    startThread();
+}
+
+bool PresetLibrary::keepWatching()
+{
+    const juce::ScopedLock sl(lock);
+
+    // Writes queued after the last pass still need the watcher
+    if (numListeners == 0 && pendingWrites.empty())
+        watching = false;
+
+    return watching;
+}
+
+void PresetLibrary::storeUserPreset(const juce::String& name, const juce::ValueTree& state)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        userEntries[name] = { name, state.createCopy(), false };
+        pendingWrites.push_back({ name, userEntries[name].state });
+        publish();
+    }
+
+    startWatching();
+    notify();
+}
+
+void PresetLibrary::removeUserPreset(const juce::String& name)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        userEntries.erase(name);
+        pendingWrites.push_back({ name, {} });
+        publish();
+    }
+
+    startWatching();
+    notify();
+}
+
+void PresetLibrary::run()
+{
+    if (! factoryPresetsLoaded)
+    {
+        loadFactoryPresets();
+        factoryPresetsLoaded = true;
+    }
+
+    while (! threadShouldExit())
+    {
+        performPendingWrites();
+        scanDirectory();
+
+        if (! complete.exchange(true))
+            sendChangeMessage();
+
+        if (! keepWatching())
+            return;
+
+        wait(watchIntervalMs);
+    }
+
+    performPendingWrites();
+}
+
+void PresetLibrary::loadFactoryPresets()
+{
+    auto xml = juce::parseXML(juce::String::createStringFromData(BinaryData::FactoryPresets_xml,
+                                                                 BinaryData::FactoryPresets_xmlSize));
+
+    if (xml == nullptr)
+        return;
+
+    std::vector<Entry> entries;
+
+    for (auto* preset : xml->getChildWithTagNameIterator("Preset"))
+    {
+        // Parameters a preset does not list are reset to their default by replaceState
+        if (auto* parameters = preset->getFirstChildElement())
+            entries.push_back({ preset->getStringAttribute("name"), juce::ValueTree::fromXml(*parameters), true });
+    }
+
+    const juce::ScopedLock sl(lock);
+    factoryEntries = std::move(entries);
+    publish();
+}
+
+void PresetLibrary::performPendingWrites()
+{
+    std::vector<PendingWrite> writes;
+
+    {
+        const juce::ScopedLock sl(lock);
+        writes.swap(pendingWrites);
+    }
+
+    auto presetsDir = getPresetsDirectory();
+
+    for (const auto& write : writes)
+    {
+        auto presetFile = presetsDir.getChildFile(write.name + presetFileExtension);
+
+        if (write.state.isValid())
+        {
+            presetsDir.createDirectory();
+
+            if (auto xml = write.state.createXml())
+                xml->writeTo(presetFile);
+
+            fileStamps[write.name] = { presetFile.getLastModificationTime(), presetFile.getSize() };
+        }
+        else
+        {
+            presetFile.deleteFile();
+            fileStamps.erase(write.name);
+        }
+    }
+}
+
+void PresetLibrary::scanDirectory()
+{
+    std::map<juce::String, FileStamp> foundStamps;
+    std::vector<Entry> changed;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(getPresetsDirectory(), false,
+                                                            "*" + juce::String(presetFileExtension),
+                                                            juce::File::findFiles))
+    {
+        auto name = entry.getFile().getFileNameWithoutExtension();
+        FileStamp stamp { entry.getModificationTime(), entry.getFileSize() };
+        foundStamps[name] = stamp;
+
+        auto known = fileStamps.find(name);
+
+        if (known != fileStamps.end() && known->second == stamp)
+            continue;
+
+        if (auto xml = juce::XmlDocument::parse(entry.getFile()))
+            changed.push_back({ name, juce::ValueTree::fromXml(*xml), false });
+    }
+
+    std::vector<juce::String> removed;
+
+    for (const auto& known : fileStamps)
+        if (foundStamps.find(known.first) == foundStamps.end())
+            removed.push_back(known.first);
+
+    fileStamps = std::move(foundStamps);
+
+    if (changed.empty() && removed.empty())
+        return;
+
+    const juce::ScopedLock sl(lock);
+
+    // Presets with a write still queued were changed after this scan looked at the disk
+    auto isPending = [this](const juce::String& name)
+    {
+        return std::any_of(pendingWrites.begin(), pendingWrites.end(),
+                           [&name](const PendingWrite& write) { return write.name == name; });
+    };
+
+    for (auto& entry : changed)
+        if (! isPending(entry.name))
+            userEntries[entry.name] = std::move(entry);
+
+    for (const auto& name : removed)
+        if (! isPending(name))
+            userEntries.erase(name);
+
+    publish();
+}
+
+void PresetLibrary::publish()
+{
+    auto newIndex = std::make_shared<Index>();
+    newIndex->entries.reserve(factoryEntries.size() + userEntries.size());
+
+    // A user preset shadows the factory preset of the same name
+    for (const auto& entry : factoryEntries)
+        if (userEntries.find(entry.name) == userEntries.end())
+            newIndex->entries.push_back(entry);
+
+    for (const auto& entry : userEntries)
+        newIndex->entries.push_back(entry.second);
+
+    std::sort(newIndex->entries.begin(), newIndex->entries.end(),
+              [](const Entry& a, const Entry& b) { return a.name.compareIgnoreCase(b.name) < 0; });
+
+    for (const auto& entry : newIndex->entries)
+        newIndex->names.add(entry.name);
+
+    index = std::move(newIndex);
+    sendChangeMessage();
+}
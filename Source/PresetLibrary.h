@@ -0,0 +1,111 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+/// Process-wide index of the factory and user presets, with every preset's parameter
+/// state already parsed.
+///
+/// A background watcher thread decodes the factory presets from BinaryData, then polls
+/// the presets directory and re-parses only the files whose size or modification time
+/// changed. Each change publishes a new immutable Index, so readers grab a snapshot and
+/// never wait on, or touch, the disk. Preset files are also written and deleted on the
+/// watcher thread.
+///
+/// The watcher starts on the first getIndex(), write or rescan, and only keeps polling
+/// while change listeners are registered; without any it stops after one pass. JUCE has
+/// no portable directory change notification, so polling is what a listener pays for.
+class PresetLibrary : private juce::ChangeBroadcaster,
+                      private juce::Thread
+{
+public:
+    struct Entry
+    {
+        juce::String name;
+        juce::ValueTree state;  // Shared by every snapshot, copy it before handing it to an APVTS
+        bool isFactory = false;
+    };
+
+    /// Immutable snapshot of all presets, sorted case-insensitively by name
+    struct Index
+    {
+        std::vector<Entry> entries;
+        juce::StringArray names;
+
+        /// Position of the named preset, or -1 (binary search)
+        int indexOf(const juce::String& name) const;
+        int size() const { return static_cast<int>(entries.size()); }
+    };
+
+    PresetLibrary();
+    ~PresetLibrary() override;
+
+    /// Latest published index. The first call starts reading the presets.
+    std::shared_ptr<const Index> getIndex();
+
+    /// True once the factory presets and the presets directory have been read
+    bool isComplete() const { return complete.load(); }
+
+    /// Add or replace a user preset. The index is updated right away, the file is written
+    /// by the watcher thread.
+    void storeUserPreset(const juce::String& name, const juce::ValueTree& state);
+
+    /// Remove a user preset from the index and delete its file on the watcher thread
+    void removeUserPreset(const juce::String& name);
+
+    /// Check the presets directory now instead of waiting for the next poll
+    void rescan();
+
+    /// Listeners get a change message whenever a new index is published, and keep the
+    /// watcher polling the presets directory while any are registered (message thread)
+    void addChangeListener(juce::ChangeListener* listener);
+    void removeChangeListener(juce::ChangeListener* listener);
+
+    static juce::File getPresetsDirectory();
+    static constexpr const char* presetFileExtension = ".spice";
+
+    /// How often the watcher polls the presets directory
+    static constexpr int watchIntervalMs = 1000;
+
+private:
+    struct FileStamp
+    {
+        juce::Time modified;
+        juce::int64 size = 0;
+
+        bool operator==(const FileStamp& other) const { return modified == other.modified && size == other.size; }
+    };
+
+    struct PendingWrite
+    {
+        juce::String name;
+        juce::ValueTree state;  // Invalid for deletions
+    };
+
+    void startWatching();
+    bool keepWatching();
+
+    void run() override;
+    void loadFactoryPresets();
+    void performPendingWrites();
+    void scanDirectory();
+    void publish();
+
+    // Published state, guarded by lock
+    juce::CriticalSection lock;
+    std::vector<Entry> factoryEntries;
+    std::map<juce::String, Entry> userEntries;
+    std::vector<PendingWrite> pendingWrites;
+    std::shared_ptr<const Index> index;
+    std::atomic<bool> complete { false };
+    int numListeners = 0;
+    bool watching = false;
+
+    // Watcher thread only
+    std::map<juce::String, FileStamp> fileStamps;
+    bool factoryPresetsLoaded = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetLibrary)
+};
@@ -3,428 +3,353 @@
 
 PresetManager::PresetManager(juce::AudioProcessorValueTreeState& apvts)
     : valueTreeState(apvts),
-      currentPresetName(defaultPresetName)
+      currentPresetName(defaultPresetName),
+      index(std::make_shared<const PresetLibrary::Index>())
 {
-    createPresetsDirectory();
-    
-    // Create default preset if it doesn't exist
-    auto defaultPreset = getPresetsDirectory().getChildFile(juce::String(defaultPresetName) + presetFileExtension);
-    if (!defaultPreset.existsAsFile())
-    {
-        saveDefaultPreset();
-    }
-    
-    // Check preset version file
-    auto versionFile = getPresetsDirectory().getChildFile("preset_version.txt");
-    bool needsRecreation = true;
-    
-    if (versionFile.existsAsFile())
+    // The library is first read when the presets are asked for, not while the plugin is built
+}
+
+PresetManager::~PresetManager()
+{
+    if (listeningToLibrary)
+        library->removeChangeListener(this);
+}
+
+void PresetManager::addChangeListener(juce::ChangeListener* listener)
+{
+    juce::ChangeBroadcaster::addChangeListener(listener);
+    ++numListeners;
+    updateLibraryListening();
+}
+
+void PresetManager::removeChangeListener(juce::ChangeListener* listener)
+{
+    juce::ChangeBroadcaster::removeChangeListener(listener);
+    --numListeners;
+    updateLibraryListening();
+}
+
+void PresetManager::updateLibraryListening()
+{
+    // Listening keeps the library polling the disk, so only do it while it matters
+    const bool shouldListen = numListeners > 0 || pendingPresetName.isNotEmpty() || morphPresetsPending;
+
+    if (shouldListen == listeningToLibrary)
+        return;
+
+    listeningToLibrary = shouldListen;
+
+    if (shouldListen)
+        library->addChangeListener(this);
+    else
+        library->removeChangeListener(this);
+}
+
+void PresetManager::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    updateIndex();
+
+    if (pendingPresetName.isNotEmpty())
     {
-        auto version = versionFile.loadFileAsString().trim();
-        if (version == "5")
+        auto position = index->indexOf(pendingPresetName);
+
+        if (position >= 0)
+        {
+            pendingPresetName.clear();
+            applyPreset(position, pendingSmooth);
+        }
+        else if (library->isComplete())
         {
-            needsRecreation = false;
+            pendingPresetName.clear();
         }
     }
-    
-    if (needsRecreation)
+
+    updateLibraryListening();
+    sendChangeMessage();
+}
+
+juce::StringArray PresetManager::getAllPresets()
+{
+    updateIndex();
+    return index->names;
+}
+
+void PresetManager::updateIndex()
+{
+    auto newIndex = library->getIndex();
+
+    if (newIndex == index && bank.size() == index->entries.size())
+        return;
+
+    // Snapshots already decoded for presets that are still the same state are kept, the
+    // rest are left empty until getSnapshot() needs them
+    std::vector<ParameterSnapshot> newBank(newIndex->entries.size());
+
+    for (size_t i = 0; i < newIndex->entries.size(); ++i)
     {
-        createFactoryPresets();
-        // Write version file
-        versionFile.replaceWithText("5");
+        const auto& entry = newIndex->entries[i];
+        auto previous = index->indexOf(entry.name);
+
+        if (previous >= 0 && static_cast<size_t>(previous) < bank.size()
+            && index->entries[static_cast<size_t>(previous)].state == entry.state)
+            newBank[i] = std::move(bank[static_cast<size_t>(previous)]);
     }
+
+    index = std::move(newIndex);
+    bank = std::move(newBank);
+    currentPosition = index->indexOf(currentPresetName);
+
+    if (! morphPresetNames.isEmpty())
+        updateMorphPoints();
 }
 
-void PresetManager::createPresetsDirectory()
+const ParameterSnapshot& PresetManager::getSnapshot(int position)
 {
-    auto presetsDir = getPresetsDirectory();
-    if (!presetsDir.exists())
+    auto& snapshot = bank[static_cast<size_t>(position)];
+
+    if (snapshot.empty())
+        snapshot = decodeSnapshot(index->entries[static_cast<size_t>(position)].state);
+
+    return snapshot;
+}
+
+ParameterSnapshot PresetManager::decodeSnapshot(const juce::ValueTree& state) const
+{
+    ParameterSnapshot snapshot;
+
+    for (auto* parameter : valueTreeState.processor.getParameters())
     {
-        presetsDir.createDirectory();
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+
+        if (ranged == nullptr)
+        {
+            snapshot.push_back(parameter->getValue());
+            continue;
+        }
+
+        // Parameters the preset does not list take their default, as with replaceState
+        auto child = state.getChildWithProperty("id", ranged->getParameterID());
+
+        if (child.isValid() && child.hasProperty("value"))
+            snapshot.push_back(ranged->convertTo0to1(static_cast<float>(child.getProperty("value"))));
+        else
+            snapshot.push_back(ranged->getDefaultValue());
     }
+
+    return snapshot;
 }
 
-juce::File PresetManager::getPresetsDirectory() const
+ParameterSnapshot PresetManager::captureSnapshot() const
 {
-    auto documentsDir = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory);
-    return documentsDir.getChildFile("Datanoise/Spice/Presets");
+    ParameterSnapshot snapshot;
+
+    for (auto* parameter : valueTreeState.processor.getParameters())
+        snapshot.push_back(parameter->getValue());
+
+    return snapshot;
 }
 
 void PresetManager::savePreset(const juce::String& presetName)
 {
     if (presetName.isEmpty())
         return;
-        
-    auto xml = valueTreeState.copyState().createXml();
-    if (xml != nullptr)
-    {
-        auto presetFile = getPresetsDirectory().getChildFile(presetName + presetFileExtension);
-        xml->writeTo(presetFile);
-        currentPresetName = presetName;
-    }
+
+    library->storeUserPreset(presetName, valueTreeState.copyState());
+    currentPresetName = presetName;
+    updateIndex();
+}
+
+void PresetManager::setCurrentPreset(const juce::String& presetName)
+{
+    // The position is found again whenever a newer index is picked up
+    currentPresetName = presetName;
+    currentPosition = index->indexOf(presetName);
+    pendingPresetName.clear();
+    updateLibraryListening();
 }
 
 void PresetManager::loadPreset(const juce::String& presetName)
 {
-    if (presetName.isEmpty())
-        return;
-        
-    auto presetFile = getPresetsDirectory().getChildFile(presetName + presetFileExtension);
-    if (!presetFile.existsAsFile())
-        return;
-        
-    auto xml = juce::XmlDocument::parse(presetFile);
-    if (xml != nullptr)
-    {
-        auto newState = juce::ValueTree::fromXml(*xml);
-        if (newState.isValid())
-        {
-            valueTreeState.replaceState(newState);
-            currentPresetName = presetName;
-        }
-    }
+    loadPresetNamed(presetName, false);
 }
 
 void PresetManager::loadPresetSmooth(const juce::String& presetName)
+{
+    loadPresetNamed(presetName, true);
+}
+
+void PresetManager::loadPresetNamed(const juce::String& presetName, bool smooth)
 {
     if (presetName.isEmpty())
         return;
-        
-    auto presetFile = getPresetsDirectory().getChildFile(presetName + presetFileExtension);
-    if (!presetFile.existsAsFile())
-        return;
-        
-    auto xml = juce::XmlDocument::parse(presetFile);
-    if (xml != nullptr)
+
+    updateIndex();
+    auto position = index->indexOf(presetName);
+
+    if (position >= 0)
     {
-        auto newState = juce::ValueTree::fromXml(*xml);
-        if (newState.isValid())
-        {
-            // Set the processor flag to enable smooth parameter transitions
-            if (processor != nullptr)
-            {
-                if (auto* spiceProc = dynamic_cast<SpiceAudioProcessor*>(processor))
-                {
-                    spiceProc->setPresetLoadingMode(true);
-                }
-            }
-            
-            // Replace the state which will trigger parameter changes
-            valueTreeState.replaceState(newState);
-            currentPresetName = presetName;
-        }
+        pendingPresetName.clear();
+        applyPreset(position, smooth);
     }
+    else if (! library->isComplete())
+    {
+        // Restored before the library finished reading; load it as soon as it is indexed
+        pendingPresetName = presetName;
+        pendingSmooth = smooth;
+    }
+
+    updateLibraryListening();
 }
 
-void PresetManager::deletePreset(const juce::String& presetName)
+void PresetManager::applyPreset(int position, bool smooth)
 {
-    if (presetName == defaultPresetName)
-        return; // Don't delete the default preset
-        
-    auto presetFile = getPresetsDirectory().getChildFile(presetName + presetFileExtension);
-    if (presetFile.existsAsFile())
+    applySnapshot(getSnapshot(position), smooth);
+    currentPresetName = index->entries[static_cast<size_t>(position)].name;
+    currentPosition = position;
+}
+
+void PresetManager::applySnapshot(const ParameterSnapshot& snapshot, bool smooth)
+{
+    if (auto* spiceProc = dynamic_cast<SpiceAudioProcessor*>(processor))
     {
-        presetFile.deleteFile();
+        spiceProc->getPresetCrossfader().apply(snapshot, smooth ? PresetCrossfader::defaultCrossfadeSeconds : 0.0);
+        return;
     }
+
+    const auto& parameters = valueTreeState.processor.getParameters();
+
+    for (int i = 0; i < juce::jmin(parameters.size(), static_cast<int>(snapshot.size())); ++i)
+        parameters[i]->setValueNotifyingHost(snapshot[static_cast<size_t>(i)]);
 }
 
-juce::StringArray PresetManager::getAllPresets()
+void PresetManager::selectSlot(Slot slot)
 {
-    juce::StringArray presets;
-    auto presetsDir = getPresetsDirectory();
-    
-    for (auto entry : presetsDir.findChildFiles(juce::File::findFiles, false, "*" + juce::String(presetFileExtension)))
+    if (slot == activeSlot)
+        return;
+
+    auto& previous = slotSnapshots[static_cast<size_t>(activeSlot)];
+    auto& next = slotSnapshots[static_cast<size_t>(slot)];
+
+    previous = captureSnapshot();
+    slotPresetNames[static_cast<size_t>(activeSlot)] = currentPresetName;
+    activeSlot = slot;
+
+    if (next.empty())
     {
-        presets.add(entry.getFileNameWithoutExtension());
+        next = previous;
+        slotPresetNames[static_cast<size_t>(slot)] = currentPresetName;
+        return;
     }
-    
-    presets.sort(true);
-    return presets;
+
+    applySnapshot(next, true);
+    currentPresetName = slotPresetNames[static_cast<size_t>(slot)];
+    currentPosition = index->indexOf(currentPresetName);
+
+    if (morphPresetNames.isEmpty())
+        updateMorphPoints();
 }
 
-void PresetManager::loadNextPreset()
+void PresetManager::setMorphPresets(const juce::StringArray& presetNames)
 {
-    auto presets = getAllPresets();
-    if (presets.isEmpty())
-        return;
-        
-    auto currentIndex = presets.indexOf(currentPresetName);
-    auto nextIndex = (currentIndex + 1) % presets.size();
-    loadPresetSmooth(presets[nextIndex]);
+    morphPresetNames = presetNames;
+    updateIndex();
+    updateMorphPoints();
+    updateLibraryListening();
 }
 
-void PresetManager::loadPreviousPreset()
+StateSerializer::PresetState PresetManager::getState() const
 {
-    auto presets = getAllPresets();
-    if (presets.isEmpty())
-        return;
-        
-    auto currentIndex = presets.indexOf(currentPresetName);
-    auto prevIndex = (currentIndex - 1 + presets.size()) % presets.size();
-    loadPresetSmooth(presets[prevIndex]);
+    StateSerializer::PresetState state;
+    state.currentPreset = currentPresetName;
+    state.morphPresets = morphPresetNames;
+    state.activeSlot = static_cast<int>(activeSlot);
+    state.slotPresetNames = slotPresetNames;
+    state.slotSnapshots = slotSnapshots;
+    return state;
 }
 
-void PresetManager::saveDefaultPreset()
+void PresetManager::setState(const StateSerializer::PresetState& state)
 {
-    // Save the current state as the default preset
-    savePreset(defaultPresetName);
-    
-    // Create additional factory presets
-    createFactoryPresets();
+    slotSnapshots = state.slotSnapshots;
+    slotPresetNames = state.slotPresetNames;
+    activeSlot = state.activeSlot == 0 ? Slot::a : Slot::b;
+    morphPresetNames = state.morphPresets;
+
+    if (state.currentPreset.isNotEmpty())
+        setCurrentPreset(state.currentPreset);
+
+    // Morph presets are found by name, so only they need the index
+    if (! morphPresetNames.isEmpty())
+        updateIndex();
+
+    updateMorphPoints();
+    updateLibraryListening();
 }
 
-void PresetManager::createFactoryPresets()
+void PresetManager::updateMorphPoints()
 {
-    // First delete all existing presets
-    auto presetsDir = getPresetsDirectory();
-    for (auto file : presetsDir.findChildFiles(juce::File::findFiles, false, "*" + juce::String(presetFileExtension)))
+    auto* spiceProc = dynamic_cast<SpiceAudioProcessor*>(processor);
+
+    if (spiceProc == nullptr)
+        return;
+
+    std::vector<ParameterSnapshot> points;
+    morphPresetsPending = false;
+
+    if (morphPresetNames.isEmpty())
     {
-        file.deleteFile();
+        for (const auto& snapshot : slotSnapshots)
+            if (! snapshot.empty())
+                points.push_back(snapshot);
     }
-    
-    // Helper lambda to set all parameters
-    auto setAllParams = [this](float inputGain, float drive, float mix, float output, int model, 
-                               float tone, float bias, int quality, float lowCut, float highCut,
-                               bool gateEnabled, float gateThreshold, bool cabinetEnabled, 
-                               int cabinetModel, float cabinetPresence, float cabinetMix, bool limiterEnabled,
-                               bool midSideEnabled, float midGain, float sideGain, float stereoWidth)
+    else
     {
-        valueTreeState.getParameter("inputGain")->setValueNotifyingHost(inputGain);
-        valueTreeState.getParameter("drive")->setValueNotifyingHost(drive);
-        valueTreeState.getParameter("mix")->setValueNotifyingHost(mix);
-        valueTreeState.getParameter("output")->setValueNotifyingHost(output);
-        valueTreeState.getParameter("model")->setValueNotifyingHost(model / 10.0f);
-        valueTreeState.getParameter("tone")->setValueNotifyingHost(tone);
-        valueTreeState.getParameter("bias")->setValueNotifyingHost(bias);
-        valueTreeState.getParameter("quality")->setValueNotifyingHost(quality / 2.0f);
-        valueTreeState.getParameter("lowCut")->setValueNotifyingHost(lowCut);
-        valueTreeState.getParameter("highCut")->setValueNotifyingHost(highCut);
-        valueTreeState.getParameter("gateEnabled")->setValueNotifyingHost(gateEnabled ? 1.0f : 0.0f);
-        valueTreeState.getParameter("gateThreshold")->setValueNotifyingHost(gateThreshold);
-        valueTreeState.getParameter("cabinetEnabled")->setValueNotifyingHost(cabinetEnabled ? 1.0f : 0.0f);
-        valueTreeState.getParameter("cabinetModel")->setValueNotifyingHost(cabinetModel / 9.0f);
-        valueTreeState.getParameter("cabinetPresence")->setValueNotifyingHost(cabinetPresence);
-        valueTreeState.getParameter("cabinetMix")->setValueNotifyingHost(cabinetMix);
-        valueTreeState.getParameter("limiterEnabled")->setValueNotifyingHost(limiterEnabled ? 1.0f : 0.0f);
-        valueTreeState.getParameter("midSideEnabled")->setValueNotifyingHost(midSideEnabled ? 1.0f : 0.0f);
-        valueTreeState.getParameter("midGain")->setValueNotifyingHost(midGain);
-        valueTreeState.getParameter("sideGain")->setValueNotifyingHost(sideGain);
-        valueTreeState.getParameter("stereoWidth")->setValueNotifyingHost(stereoWidth);
-    };
-    
-    // 1. Init (Default)
-    setAllParams(0.5f, 0.0f, 1.0f, 0.5f, 0, 0.5f, 0.5f, 1, 0.0f, 1.0f, false, 0.333f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Init");
-    
-    // 2. Clean Warmth
-    setAllParams(0.5f, 0.15f, 1.0f, 0.5f, 0, 0.45f, 0.5f, 1, 0.0f, 1.0f, false, 0.333f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Clean Warmth");
-    
-    // 3. Vintage Console
-    setAllParams(0.45f, 0.25f, 1.0f, 0.5f, 5, 0.6f, 0.55f, 2, 0.02f, 0.98f, false, 0.333f, true, 6, 0.4f, 0.8f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Vintage Console");
-    
-    // 4. Mid-Side Master - showcases mid-side processing
-    setAllParams(0.5f, 0.3f, 1.0f, 0.5f, 2, 0.5f, 0.5f, 2, 0.0f, 1.0f, false, 0.333f, false, 0, 0.3f, 1.0f, false, true, 0.52f, 0.4f, 180.0f);
-    savePreset("Mid-Side Master");
-    
-    // 5. Wide Stereo
-    setAllParams(0.48f, 0.2f, 1.0f, 0.5f, 0, 0.6f, 0.5f, 1, 0.0f, 1.0f, false, 0.333f, false, 0, 0.3f, 1.0f, false, true, 0.48f, 0.6f, 250.0f);
-    savePreset("Wide Stereo");
-    
-    // 6. Tape Glue
-    setAllParams(0.52f, 0.35f, 1.0f, 0.48f, 3, 0.4f, 0.45f, 1, 0.0f, 0.95f, false, 0.333f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Tape Glue");
-    
-    // 7. Rock Guitar with Mid-Side
-    setAllParams(0.58f, 0.65f, 1.0f, 0.45f, 9, 0.7f, 0.6f, 2, 0.08f, 1.0f, true, 0.4f, true, 3, 0.2f, 0.9f, false, true, 0.53f, 0.45f, 110.0f);
-    savePreset("Rock Guitar MS");
-    
-    // 7.5. Mono Focus - Mid emphasized, sides reduced
-    setAllParams(0.5f, 0.2f, 1.0f, 0.5f, 0, 0.5f, 0.5f, 1, 0.0f, 1.0f, false, 0.333f, false, 0, 0.3f, 1.0f, false, true, 0.6f, 0.2f, 50.0f);
-    savePreset("Mono Focus");
-    
-    // 8. Fuzz Madness
-    setAllParams(0.62f, 0.8f, 1.0f, 0.4f, 8, 0.8f, 0.7f, 1, 0.0f, 1.0f, false, 0.333f, true, 7, 0.5f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Fuzz Madness");
-    
-    // 7. Warm Bass
-    setAllParams(0.48f, 0.4f, 1.0f, 0.5f, 6, 0.3f, 0.4f, 1, 0.05f, 1.0f, true, 0.45f, true, 2, 0.3f, 0.7f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Warm Bass");
-    
-    // 8. Bright Presence
-    setAllParams(0.5f, 0.3f, 1.0f, 0.52f, 7, 0.8f, 0.6f, 2, 0.0f, 1.0f, false, 0.333f, true, 8, 0.6f, 0.5f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Bright Presence");
-    
-    // 9. Drum Punch
-    setAllParams(0.55f, 0.45f, 1.0f, 0.48f, 1, 0.55f, 0.65f, 1, 0.03f, 1.0f, true, 0.35f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Drum Punch");
-    
-    // 10. Vocal Silk
-    setAllParams(0.47f, 0.2f, 1.0f, 0.5f, 0, 0.5f, 0.45f, 2, 0.08f, 0.98f, true, 0.5f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Vocal Silk");
-    
-    // 11. Master Bus
-    setAllParams(0.5f, 0.1f, 0.8f, 0.5f, 2, 0.5f, 0.5f, 2, 0.0f, 1.0f, false, 0.333f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Master Bus");
-    
-    // 12. 12AX7 Clean
-    setAllParams(0.48f, 0.25f, 1.0f, 0.5f, 10, 0.55f, 0.55f, 1, 0.0f, 1.0f, false, 0.333f, true, 5, 0.25f, 0.9f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("12AX7 Clean");
-    
-    // 13. 12AX7 Crunch
-    setAllParams(0.53f, 0.55f, 1.0f, 0.47f, 10, 0.45f, 0.65f, 2, 0.02f, 1.0f, false, 0.333f, true, 1, 0.15f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("12AX7 Crunch");
-    
-    // 14. 12AX7 Lead
-    setAllParams(0.6f, 0.8f, 1.0f, 0.44f, 10, 0.65f, 0.6f, 2, 0.05f, 0.98f, true, 0.42f, true, 6, 0.1f, 0.95f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("12AX7 Lead");
-    
-    // 15. Analog Desk
-    setAllParams(0.49f, 0.35f, 0.95f, 0.5f, 5, 0.52f, 0.48f, 2, 0.01f, 0.99f, false, 0.333f, true, 4, 0.45f, 0.6f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Analog Desk");
-    
-    // 16. Kick Destroyer
-    setAllParams(0.65f, 0.7f, 1.0f, 0.42f, 4, 0.35f, 0.7f, 1, 0.1f, 0.9f, true, 0.38f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Kick Destroyer");
-    
-    // 17. Snare Crack
-    setAllParams(0.52f, 0.5f, 1.0f, 0.48f, 1, 0.7f, 0.6f, 1, 0.15f, 1.0f, true, 0.4f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Snare Crack");
-    
-    // 18. Piano Warmth
-    setAllParams(0.46f, 0.18f, 0.85f, 0.5f, 0, 0.4f, 0.45f, 2, 0.0f, 0.95f, false, 0.333f, true, 9, 0.7f, 0.4f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Piano Warmth");
-    
-    // 19. String Section
-    setAllParams(0.48f, 0.22f, 0.9f, 0.5f, 2, 0.58f, 0.5f, 2, 0.02f, 0.97f, false, 0.333f, true, 5, 0.5f, 0.5f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("String Section");
-    
-    // 20. Synth Grit
-    setAllParams(0.56f, 0.6f, 1.0f, 0.46f, 4, 0.75f, 0.55f, 0, 0.0f, 1.0f, false, 0.333f, true, 3, 0.2f, 0.8f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Synth Grit");
-    
-    // 21. Bass DI
-    setAllParams(0.51f, 0.32f, 1.0f, 0.5f, 1, 0.35f, 0.52f, 1, 0.08f, 0.98f, true, 0.5f, true, 2, 0.4f, 0.6f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Bass DI");
-    
-    // 22. Acoustic Guitar
-    setAllParams(0.45f, 0.15f, 0.75f, 0.5f, 7, 0.65f, 0.5f, 2, 0.04f, 1.0f, true, 0.55f, true, 9, 0.8f, 0.3f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Acoustic Guitar");
-    
-    // 23. Lo-Fi Magic
-    setAllParams(0.54f, 0.55f, 1.0f, 0.45f, 3, 0.25f, 0.65f, 0, 0.2f, 0.7f, false, 0.333f, true, 0, 0.9f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Lo-Fi Magic");
-    
-    // 24. Mix Bus Glue
-    setAllParams(0.5f, 0.12f, 0.7f, 0.5f, 3, 0.48f, 0.5f, 2, 0.0f, 1.0f, false, 0.333f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Mix Bus Glue");
-    
-    // 25. Parallel Smash
-    setAllParams(0.7f, 0.85f, 0.3f, 0.5f, 8, 0.6f, 0.7f, 1, 0.0f, 1.0f, false, 0.333f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Parallel Smash");
-    
-    // 26. Radio Voice
-    setAllParams(0.52f, 0.4f, 1.0f, 0.52f, 7, 0.85f, 0.55f, 0, 0.15f, 0.8f, true, 0.45f, true, 8, 0.6f, 0.7f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Radio Voice");
-    
-    // 27. Drum Bus
-    setAllParams(0.53f, 0.38f, 0.9f, 0.49f, 5, 0.55f, 0.58f, 1, 0.02f, 1.0f, true, 0.35f, true, 4, 0.3f, 0.6f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Drum Bus");
-    
-    // 28. Electric Lead
-    setAllParams(0.57f, 0.72f, 1.0f, 0.45f, 9, 0.62f, 0.65f, 2, 0.1f, 1.0f, true, 0.4f, true, 6, 0.15f, 0.95f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Electric Lead");
-    
-    // 29. Smooth Jazz
-    setAllParams(0.47f, 0.25f, 0.8f, 0.5f, 6, 0.38f, 0.45f, 2, 0.0f, 0.96f, false, 0.333f, true, 8, 0.75f, 0.4f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Smooth Jazz");
-    
-    // 30. Broken Speaker
-    setAllParams(0.68f, 0.9f, 1.0f, 0.38f, 8, 0.2f, 0.8f, 0, 0.0f, 0.6f, false, 0.333f, true, 7, 0.1f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Broken Speaker");
-    
-    // 31. API Style
-    setAllParams(0.49f, 0.28f, 1.0f, 0.51f, 1, 0.62f, 0.55f, 2, 0.01f, 1.0f, false, 0.333f, true, 5, 0.35f, 0.7f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("API Style");
-    
-    // 32. Neve Style
-    setAllParams(0.48f, 0.32f, 1.0f, 0.49f, 2, 0.45f, 0.52f, 2, 0.02f, 0.99f, false, 0.333f, true, 4, 0.5f, 0.6f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Neve Style");
-    
-    // 33. SSL Style
-    setAllParams(0.5f, 0.24f, 0.95f, 0.5f, 5, 0.68f, 0.5f, 2, 0.0f, 1.0f, false, 0.333f, true, 3, 0.4f, 0.5f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("SSL Style");
-    
-    // 34. Vocal Thickener
-    setAllParams(0.48f, 0.35f, 0.8f, 0.52f, 0, 0.58f, 0.48f, 2, 0.06f, 0.98f, true, 0.48f, false, 0, 0.3f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Vocal Thickener");
-    
-    // 35. Drum Room
-    setAllParams(0.54f, 0.42f, 0.85f, 0.48f, 3, 0.45f, 0.6f, 1, 0.0f, 1.0f, false, 0.333f, true, 9, 0.8f, 0.5f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Drum Room");
-    
-    // 36. Smooth Operator
-    setAllParams(0.46f, 0.18f, 0.75f, 0.51f, 6, 0.42f, 0.45f, 2, 0.0f, 1.0f, false, 0.333f, true, 1, 0.6f, 0.3f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Smooth Operator");
-    
-    // 37. Gritty Pump
-    setAllParams(0.62f, 0.75f, 1.0f, 0.4f, 4, 0.65f, 0.72f, 1, 0.05f, 1.0f, true, 0.38f, true, 7, 0.25f, 0.9f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Gritty Pump");
-    
-    // 38. Boutique Preamp
-    setAllParams(0.47f, 0.28f, 0.92f, 0.5f, 10, 0.55f, 0.52f, 2, 0.0f, 1.0f, false, 0.333f, true, 5, 0.45f, 0.8f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Boutique Preamp");
-    
-    // 39. Vintage Compressor
-    setAllParams(0.51f, 0.45f, 0.88f, 0.49f, 2, 0.48f, 0.55f, 2, 0.01f, 0.99f, false, 0.333f, true, 0, 0.55f, 0.5f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Vintage Compressor");
-    
-    // 40. Harmonic Enhancer
-    setAllParams(0.49f, 0.38f, 0.7f, 0.51f, 10, 0.6f, 0.65f, 2, 0.0f, 1.0f, false, 0.333f, true, 5, 0.3f, 0.6f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Harmonic Enhancer");
-    
-    // 41. Retro Channel
-    setAllParams(0.48f, 0.32f, 0.95f, 0.5f, 5, 0.52f, 0.5f, 2, 0.01f, 0.98f, false, 0.333f, true, 9, 0.65f, 0.4f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Retro Channel");
-    
-    // 42. Distorted Dreams
-    setAllParams(0.7f, 0.85f, 1.0f, 0.38f, 8, 0.3f, 0.8f, 0, 0.0f, 0.8f, false, 0.333f, true, 7, 0.05f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Distorted Dreams");
-    
-    // 43. Crystal Clean
-    setAllParams(0.44f, 0.08f, 0.6f, 0.52f, 7, 0.75f, 0.45f, 2, 0.0f, 1.0f, false, 0.333f, true, 8, 0.85f, 0.2f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Crystal Clean");
-    
-    // 44. Dark Matter
-    setAllParams(0.58f, 0.65f, 1.0f, 0.42f, 3, 0.25f, 0.7f, 1, 0.08f, 0.85f, true, 0.4f, true, 2, 0.2f, 0.9f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Dark Matter");
-    
-    // 45. Sparkle Top
-    setAllParams(0.46f, 0.22f, 0.7f, 0.52f, 7, 0.82f, 0.48f, 2, 0.0f, 1.0f, false, 0.333f, true, 8, 0.9f, 0.3f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Sparkle Top");
-    
-    // 46. Deep Groove
-    setAllParams(0.53f, 0.48f, 0.9f, 0.47f, 1, 0.35f, 0.6f, 1, 0.1f, 0.95f, true, 0.42f, true, 2, 0.35f, 0.7f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Deep Groove");
-    
-    // 47. Modern Edge
-    setAllParams(0.55f, 0.55f, 1.0f, 0.45f, 4, 0.72f, 0.62f, 2, 0.02f, 1.0f, false, 0.333f, true, 3, 0.25f, 0.85f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Modern Edge");
-    
-    // 48. Power Surge
-    setAllParams(0.65f, 0.8f, 1.0f, 0.4f, 9, 0.68f, 0.75f, 1, 0.05f, 1.0f, true, 0.38f, true, 6, 0.1f, 1.0f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Power Surge");
-    
-    // 49. Space Echo
-    setAllParams(0.5f, 0.35f, 0.9f, 0.49f, 3, 0.38f, 0.52f, 2, 0.0f, 0.92f, false, 0.333f, true, 0, 0.95f, 0.6f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Space Echo");
-    
-    // 50. Ultimate Spice
-    setAllParams(0.6f, 0.7f, 1.0f, 0.43f, 10, 0.6f, 0.65f, 2, 0.03f, 0.98f, true, 0.4f, true, 5, 0.2f, 0.9f, false, false, 0.5f, 0.5f, 100.0f);
-    savePreset("Ultimate Spice");
-    
-    
-    // Restore to Init preset
-    loadPreset(defaultPresetName);
-}
\ No newline at end of file
+        // Presets missing from the index are skipped until they show up
+        for (const auto& name : morphPresetNames)
+        {
+            auto position = index->indexOf(name);
+
+            if (position >= 0)
+                points.push_back(getSnapshot(position));
+            else if (! library->isComplete())
+                morphPresetsPending = true;
+        }
+    }
+
+    spiceProc->getPresetMorpher().setPoints(points);
+}
+
+void PresetManager::deletePreset(const juce::String& presetName)
+{
+    if (presetName == defaultPresetName)
+        return; // Don't delete the default preset
+
+    updateIndex();
+    auto position = index->indexOf(presetName);
+
+    if (position < 0 || index->entries[static_cast<size_t>(position)].isFactory)
+        return;
+
+    library->removeUserPreset(presetName);
+    updateIndex();
+}
+
+void PresetManager::loadNextPreset()
+{
+    updateIndex();
+    const auto numPresets = index->size();
+    if (numPresets == 0)
+        return;
+
+    applyPreset(currentPosition + 1 < numPresets ? currentPosition + 1 : 0, true);
+}
+
+void PresetManager::loadPreviousPreset()
+{
+    updateIndex();
+    const auto numPresets = index->size();
+    if (numPresets == 0)
+        return;
+
+    applyPreset(currentPosition > 0 ? currentPosition - 1 : numPresets - 1, true);
+}
@@ -1,39 +1,118 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PresetLibrary.h"
+#include "PresetCrossfader.h"
+#include "StateSerializer.h"
 
-class PresetManager
+/// Browses and applies the presets of the shared PresetLibrary.
+///
+/// Everything runs on the message thread against the library's latest in-memory index:
+/// the preset list, next/previous and loading never touch the disk, and the position of
+/// the current preset is kept so stepping through presets is constant time. A preset is
+/// decoded into a parameter snapshot the first time it is loaded or morphed, and loading
+/// hands that snapshot to the processor's PresetCrossfader instead of replacing the APVTS
+/// state. Two A/B slots hold snapshots of their own to compare settings, and the same
+/// snapshots feed the processor's PresetMorpher. The index is refreshed from the library
+/// whenever it is used; the library is only listened to while a preset waits to be read
+/// or someone listens here.
+class PresetManager : private juce::ChangeBroadcaster,
+                      private juce::ChangeListener
 {
 public:
+    enum class Slot
+    {
+        a,
+        b
+    };
+
     static constexpr const char* defaultPresetName = "Init";
-    static constexpr const char* presetFileExtension = ".spice";
-    
+    static constexpr const char* presetFileExtension = PresetLibrary::presetFileExtension;
+
     PresetManager(juce::AudioProcessorValueTreeState& apvts);
-    ~PresetManager() = default;
-    
+    ~PresetManager() override;
+
     void setProcessor(juce::AudioProcessor* proc) { processor = proc; }
-    
+
+    /// Listeners get a change message whenever the preset list changes. While any are
+    /// registered the library keeps watching the presets directory.
+    void addChangeListener(juce::ChangeListener* listener);
+    void removeChangeListener(juce::ChangeListener* listener);
+
     void savePreset(const juce::String& presetName);
     void loadPreset(const juce::String& presetName);
     void loadPresetSmooth(const juce::String& presetName);
     void deletePreset(const juce::String& presetName);
-    
+
+    /// Sorted names of all presets. Until the library has finished reading the factory
+    /// presets and the presets directory this can be incomplete.
     juce::StringArray getAllPresets();
     juce::String getCurrentPreset() const { return currentPresetName; }
-    
+
+    /// Mark a preset as the current one without loading it, e.g. when restoring a session
+    void setCurrentPreset(const juce::String& presetName);
+
+    /// Check the presets directory for changes now
+    void refreshUserPresets() { library->rescan(); }
+
     void loadNextPreset();
     void loadPreviousPreset();
-    
-    juce::File getPresetsDirectory() const;
-    
+
+    /// Keep the current settings in the active slot and crossfade to the other one. A slot
+    /// that was never used starts as a copy of the current settings.
+    void selectSlot(Slot slot);
+    Slot getActiveSlot() const { return activeSlot; }
+
+    /// Morph between two to four presets, in the given order. With an empty list the morph
+    /// goes from slot A to slot B once both have been used.
+    void setMorphPresets(const juce::StringArray& presetNames);
+    juce::StringArray getMorphPresets() const { return morphPresetNames; }
+
+    /// The current preset, the morph presets and the A/B slots, saved with the session
+    StateSerializer::PresetState getState() const;
+
+    /// Restore what getState() returned, after the parameters themselves were restored
+    void setState(const StateSerializer::PresetState& state);
+
+    juce::File getPresetsDirectory() const { return PresetLibrary::getPresetsDirectory(); }
+
 private:
-    void saveDefaultPreset();
-    void createPresetsDirectory();
-    void createFactoryPresets();
-    
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void updateIndex();
+    void updateLibraryListening();
+    void applyPreset(int position, bool smooth);
+    void applySnapshot(const ParameterSnapshot& snapshot, bool smooth);
+    void loadPresetNamed(const juce::String& presetName, bool smooth);
+    const ParameterSnapshot& getSnapshot(int position);
+    ParameterSnapshot decodeSnapshot(const juce::ValueTree& state) const;
+    ParameterSnapshot captureSnapshot() const;
+    void updateMorphPoints();
+
     juce::AudioProcessorValueTreeState& valueTreeState;
     juce::String currentPresetName;
     juce::AudioProcessor* processor = nullptr;
-    
+
+    juce::SharedResourcePointer<PresetLibrary> library;
+    std::shared_ptr<const PresetLibrary::Index> index;
+    int currentPosition = -1;
+    int numListeners = 0;
+    bool listeningToLibrary = false;
+
+    // Snapshot of every preset in the index, in index order; empty until first decoded
+    std::vector<ParameterSnapshot> bank;
+
+    // A/B comparison
+    std::array<ParameterSnapshot, 2> slotSnapshots;
+    std::array<juce::String, 2> slotPresetNames;
+    Slot activeSlot = Slot::a;
+
+    // Presets the morph runs through, empty to morph between the slots
+    juce::StringArray morphPresetNames;
+    bool morphPresetsPending = false;   // Some are not indexed yet
+
+    // Preset requested before the library had read it, applied once it shows up
+    juce::String pendingPresetName;
+    bool pendingSmooth = false;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetManager)
-};
\ No newline at end of file
+};
@@ -0,0 +1,115 @@
+#include "PresetMorpher.h"
+
+void PresetMorpher::setParameters(const juce::Array<juce::AudioProcessorParameter*>& newParameters,
+                                  const juce::Array<juce::AudioProcessorParameter*>& excluded,
+                                  ParameterPublisher& parameterPublisher)
+{
+    jassert(newParameters.size() <= maxParameters);
+
+    publisher = &parameterPublisher;
+
+    parameters.clear();
+    isDiscrete.clear();
+    isExcluded.clear();
+
+    for (auto* parameter : newParameters)
+    {
+        if (static_cast<int>(parameters.size()) == maxParameters)
+            break;
+
+        parameters.push_back(parameter);
+        isDiscrete.push_back(parameter->isDiscrete() || parameter->isBoolean());
+        isExcluded.push_back(excluded.contains(parameter));
+    }
+}
+
+void PresetMorpher::setPoints(const std::vector<ParameterSnapshot>& points)
+{
+    const juce::ScopedLock sl(writeLock);
+
+    auto& pointSet = pointSets[static_cast<size_t>(writeIndex)];
+    pointSet.numPoints = juce::jmin(maxPoints, static_cast<int>(points.size()));
+
+    for (int point = 0; point < pointSet.numPoints; ++point)
+    {
+        const auto& snapshot = points[static_cast<size_t>(point)];
+        auto& values = pointSet.values[static_cast<size_t>(point)];
+        const auto numValues = juce::jmin(snapshot.size(), parameters.size());
+
+        for (size_t i = 0; i < numValues; ++i)
+            values[i] = snapshot[i];
+    }
+
+    writeIndex = pendingIndex.exchange(writeIndex | freshFlag) & indexMask;
+    publishedNumPoints.store(pointSet.numPoints);
+}
+
+void PresetMorpher::process(bool enabled, float position)
+{
+    auto pointsChanged = false;
+
+    if ((pendingIndex.load() & freshFlag) != 0)
+    {
+        readIndex = pendingIndex.exchange(readIndex) & indexMask;
+        pointsChanged = true;
+    }
+
+    const auto& pointSet = pointSets[static_cast<size_t>(readIndex)];
+    enabled = enabled && pointSet.numPoints >= 2;
+
+    if (! enabled)
+    {
+        if (wasEnabled)
+            blends.fill({});
+
+        wasEnabled = false;
+        return;
+    }
+
+    position = juce::jlimit(0.0f, 1.0f, position);
+
+    if (wasEnabled && ! pointsChanged && position == lastPosition)
+        return;
+
+    wasEnabled = true;
+    lastPosition = position;
+
+    // Segment between two neighbouring points and the position within it
+    const auto scaled = position * static_cast<float>(pointSet.numPoints - 1);
+    const auto segment = juce::jmin(pointSet.numPoints - 2, static_cast<int>(scaled));
+    const auto weight = scaled - static_cast<float>(segment);
+
+    const auto& from = pointSet.values[static_cast<size_t>(segment)];
+    const auto& to = pointSet.values[static_cast<size_t>(segment + 1)];
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        if (isExcluded[i])
+            continue;
+
+        float value;
+
+        if (isDiscrete[i])
+        {
+            blends[i] = { from[i], to[i], weight };
+            value = weight < 0.5f ? from[i] : to[i];
+        }
+        else
+        {
+            value = from[i] + (to[i] - from[i]) * weight;
+        }
+
+        if (parameters[i]->getValue() != value)
+            publisher->setValue(static_cast<int>(i), value);
+    }
+}
+
+const PresetMorpher::Blend& PresetMorpher::getBlend(const juce::AudioProcessorParameter& parameter) const
+{
+    const auto index = parameter.getParameterIndex();
+
+    if (index < 0 || index >= static_cast<int>(parameters.size()))
+        return inactiveBlend;
+
+    return blends[static_cast<size_t>(index)];
+}
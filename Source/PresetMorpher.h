@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "PresetCrossfader.h"
+
+/// Morphs the plugin parameters between two to four stored snapshots.
+///
+/// The morph points are copied off the audio thread and handed over through a lock-free
+/// triple buffer. Each block the audio thread maps the morph position onto the segment
+/// between two neighbouring points: continuous parameters are interpolated, discrete ones
+/// take the value of the nearer point. For discrete parameters the processor can also run
+/// a second engine and crossfade between the two point values with getBlend(). The values
+/// are set through a ParameterPublisher, which notifies the host from the message thread.
+class PresetMorpher
+{
+public:
+    static constexpr int maxPoints = 4;
+    static constexpr int maxParameters = PresetCrossfader::maxParameters;
+
+    /// Two values of a discrete parameter and how far the morph has moved from one to the other
+    struct Blend
+    {
+        float from = 0.0f;      // Normalised value at the lower point
+        float to = 0.0f;        // Normalised value at the upper point
+        float weight = 0.0f;    // 0 = from only, 1 = to only
+
+        bool isActive() const { return from != to && weight > 0.0f && weight < 1.0f; }
+    };
+
+    PresetMorpher() = default;
+
+    /// Parameters the snapshots refer to, the ones the morph must never drive (e.g. the
+    /// morph controls themselves) and the publisher the audio thread sets them through
+    void setParameters(const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                       const juce::Array<juce::AudioProcessorParameter*>& excluded,
+                       ParameterPublisher& publisher);
+
+    /// Publish new morph points; fewer than two points disable the morph.
+    /// Must not be called from the audio thread.
+    void setPoints(const std::vector<ParameterSnapshot>& points);
+
+    /// Number of points in the most recently published set
+    int getNumPoints() const { return publishedNumPoints.load(); }
+
+    /// Move the morph to a position between 0 (first point) and 1 (last point) and update
+    /// the parameters and blends (audio thread). Parameters are only written when the
+    /// position or the points changed, so they can be edited while the morph stands still.
+    void process(bool enabled, float position);
+
+    /// Blend for a parameter, valid for the current block (audio thread)
+    const Blend& getBlend(const juce::AudioProcessorParameter& parameter) const;
+
+private:
+    struct PointSet
+    {
+        std::array<std::array<float, maxParameters>, maxPoints> values {};
+        int numPoints = 0;
+    };
+
+    static constexpr int freshFlag = 4;
+    static constexpr int indexMask = 3;
+
+    std::vector<juce::AudioProcessorParameter*> parameters;
+    std::vector<bool> isDiscrete;
+    std::vector<bool> isExcluded;
+    ParameterPublisher* publisher = nullptr;
+
+    // Triple buffer, written by setPoints()
+    juce::CriticalSection writeLock;
+    std::array<PointSet, 3> pointSets;
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> pendingIndex { 2 };
+    std::atomic<int> publishedNumPoints { 0 };
+
+    // Audio thread state
+    std::array<Blend, maxParameters> blends {};
+    Blend inactiveBlend;
+    float lastPosition = -1.0f;
+    bool wasEnabled = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetMorpher)
+};
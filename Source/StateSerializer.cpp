@@ -0,0 +1,227 @@
+#include "StateSerializer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+juce::uint32 StateSerializer::hashParameterID(const juce::String& parameterID)
+{
+    // 32-bit FNV-1a over the UTF-8 bytes
+    juce::uint32 hash = 2166136261u;
+
+    for (auto* c = parameterID.toRawUTF8(); *c != 0; ++c)
+    {
+        hash ^= static_cast<juce::uint8>(*c);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+void StateSerializer::setParameters(const juce::Array<juce::AudioProcessorParameter*>& newParameters)
+{
+    allParameters = newParameters;
+    parameters.clear();
+
+    for (auto* parameter : newParameters)
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            parameters.emplace_back(hashParameterID(ranged->getParameterID()), ranged);
+
+    std::sort(parameters.begin(), parameters.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // Two IDs with the same hash could not be told apart in saved sessions
+    jassert(std::adjacent_find(parameters.begin(), parameters.end(),
+                               [](const auto& a, const auto& b) { return a.first == b.first; }) == parameters.end());
+}
+
+int StateSerializer::findParameterIndex(juce::uint32 hash) const
+{
+    auto it = std::lower_bound(parameters.begin(), parameters.end(), hash,
+                               [](const auto& entry, juce::uint32 key) { return entry.first < key; });
+
+    if (it == parameters.end() || it->first != hash)
+        return -1;
+
+    return static_cast<int>(std::distance(parameters.begin(), it));
+}
+
+bool StateSerializer::isBinaryState(const void* data, int sizeInBytes)
+{
+    return data != nullptr
+        && sizeInBytes >= 8
+        && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+void StateSerializer::write(juce::MemoryBlock& destData, const PresetState& presetState) const
+{
+    destData.reset();
+    destData.ensureSize(8 + parameters.size() * 8 * 3 + static_cast<size_t>(presetState.currentPreset.getNumBytesAsUTF8()) + 64);
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(static_cast<int>(magic));
+    stream.writeShort(static_cast<short>(formatVersion));
+    stream.writeShort(static_cast<short>(parameters.size()));
+
+    for (const auto& [hash, parameter] : parameters)
+    {
+        stream.writeInt(static_cast<int>(hash));
+        stream.writeFloat(parameter->convertFrom0to1(parameter->getValue()));
+    }
+
+    stream.writeString(presetState.currentPreset);
+
+    // Version 2: morph presets and the A/B slots
+    stream.writeShort(static_cast<short>(presetState.morphPresets.size()));
+
+    for (const auto& name : presetState.morphPresets)
+        stream.writeString(name);
+
+    stream.writeByte(static_cast<char>(presetState.activeSlot));
+
+    for (size_t slot = 0; slot < presetState.slotSnapshots.size(); ++slot)
+    {
+        stream.writeString(presetState.slotPresetNames[slot]);
+        writeSnapshot(stream, presetState.slotSnapshots[slot]);
+    }
+}
+
+void StateSerializer::writeSnapshot(juce::MemoryOutputStream& stream, const std::vector<float>& snapshot) const
+{
+    if (snapshot.empty())
+    {
+        stream.writeShort(0);
+        return;
+    }
+
+    stream.writeShort(static_cast<short>(parameters.size()));
+
+    for (const auto& [hash, parameter] : parameters)
+    {
+        const auto index = static_cast<size_t>(parameter->getParameterIndex());
+        const auto value = index < snapshot.size() ? snapshot[index] : parameter->getDefaultValue();
+
+        stream.writeInt(static_cast<int>(hash));
+        stream.writeFloat(parameter->convertFrom0to1(value));
+    }
+}
+
+std::vector<float> StateSerializer::readSnapshot(juce::MemoryInputStream& stream) const
+{
+    const auto numValues = stream.getNumBytesRemaining() >= 2 ? static_cast<int>(static_cast<juce::uint16>(stream.readShort())) : 0;
+
+    if (numValues == 0)
+        return {};
+
+    // Parameters the slot does not list take their default, as in a decoded preset
+    std::vector<float> snapshot;
+    snapshot.reserve(static_cast<size_t>(allParameters.size()));
+
+    for (auto* parameter : allParameters)
+        snapshot.push_back(dynamic_cast<juce::RangedAudioParameter*>(parameter) != nullptr ? parameter->getDefaultValue()
+                                                                                             : parameter->getValue());
+
+    for (int i = 0; i < numValues && stream.getNumBytesRemaining() >= 8; ++i)
+    {
+        const auto hash = static_cast<juce::uint32>(stream.readInt());
+        const auto value = stream.readFloat();
+        const auto index = findParameterIndex(hash);
+
+        if (index >= 0)
+        {
+            auto* parameter = parameters[static_cast<size_t>(index)].second;
+            snapshot[static_cast<size_t>(parameter->getParameterIndex())] = parameter->convertTo0to1(value);
+        }
+    }
+
+    return snapshot;
+}
+
+bool StateSerializer::readValues(const void* data, int sizeInBytes,
+                                 std::vector<std::pair<juce::uint32, float>>& values, juce::String& presetName)
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+    return readValues(stream, values, presetName) <= formatVersion;
+}
+
+int StateSerializer::readValues(juce::MemoryInputStream& stream, std::vector<std::pair<juce::uint32, float>>& values,
+                                juce::String& presetName)
+{
+    stream.readInt();
+    values.clear();
+    presetName.clear();
+
+    // A newer format may store things this version would misread, so it is not parsed
+    const auto version = static_cast<int>(static_cast<juce::uint16>(stream.readShort()));
+
+    if (version > formatVersion)
+        return version;
+
+    const auto numValues = static_cast<int>(static_cast<juce::uint16>(stream.readShort()));
+    values.reserve(static_cast<size_t>(numValues));
+
+    // An entry cut short would read as a plain value of 0, so only whole entries count
+    for (int i = 0; i < numValues && stream.getNumBytesRemaining() >= 8; ++i)
+    {
+        const auto hash = static_cast<juce::uint32>(stream.readInt());
+        values.emplace_back(hash, stream.readFloat());
+    }
+
+    presetName = stream.isExhausted() ? juce::String() : stream.readString();
+    return version;
+}
+
+bool StateSerializer::read(const void* data, int sizeInBytes, PresetState& presetState) const
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+    std::vector<std::pair<juce::uint32, float>> storedValues;
+
+    presetState = {};
+    const auto version = readValues(stream, storedValues, presetState.currentPreset);
+
+    if (version > formatVersion)
+        return false;
+
+    std::vector<float> values(parameters.size(), std::numeric_limits<float>::quiet_NaN());
+
+    for (const auto& [hash, value] : storedValues)
+    {
+        const auto index = findParameterIndex(hash);
+
+        if (index >= 0)
+            values[static_cast<size_t>(index)] = value;
+    }
+
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        auto* parameter = parameters[i].second;
+        const auto normalised = std::isnan(values[i]) ? parameter->getDefaultValue()
+                                                      : parameter->convertTo0to1(values[i]);
+
+        if (parameter->getValue() != normalised)
+            parameter->setValueNotifyingHost(normalised);
+    }
+
+    if (version < 2 || stream.getNumBytesRemaining() < 2)
+        return true;
+
+    const auto numMorphPresets = static_cast<int>(static_cast<juce::uint16>(stream.readShort()));
+
+    for (int i = 0; i < numMorphPresets && ! stream.isExhausted(); ++i)
+        presetState.morphPresets.add(stream.readString());
+
+    presetState.activeSlot = stream.readByte() != 0 ? 1 : 0;
+
+    for (size_t slot = 0; slot < presetState.slotSnapshots.size(); ++slot)
+    {
+        presetState.slotPresetNames[slot] = stream.readString();
+        presetState.slotSnapshots[slot] = readSnapshot(stream);
+    }
+
+    return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <utility>
+#include <vector>
+
+/// Compact, versioned binary form of the plugin state.
+///
+/// Layout, little-endian:
+///     uint32  magic ("SPCB")
+///     uint16  format version
+///     uint16  number of parameters
+///     n x     uint32 FNV-1a hash of the parameter ID, float32 plain value
+///     string  current preset name (UTF-8, zero terminated)
+/// From version 2:
+///     uint16  number of morph presets
+///     n x     string  morph preset name
+///     uint8   active A/B slot
+///     2 x     string  slot preset name
+///             uint16  number of slot values, 0 for a slot never used
+///             n x     uint32 parameter ID hash, float32 plain value
+///
+/// Parameters are matched by the hash of their ID, so parameters can be added or removed
+/// between versions; parameters missing from the data return to their default. Data without
+/// the magic number is left to the XML reader for sessions saved by older versions, and data
+/// from a newer format version is rejected.
+class StateSerializer
+{
+public:
+    static constexpr juce::uint32 magic = 0x42435053; // "SPCB"
+    static constexpr int formatVersion = 2;
+
+    /// What the preset manager keeps next to the parameters
+    struct PresetState
+    {
+        juce::String currentPreset;
+        juce::StringArray morphPresets;
+        int activeSlot = 0;
+        std::array<juce::String, 2> slotPresetNames;
+
+        // Normalised values in AudioProcessor::getParameters() order, empty if never used
+        std::array<std::vector<float>, 2> slotSnapshots;
+    };
+
+    StateSerializer() = default;
+
+    /// Parameters to store (before the first save or restore)
+    void setParameters(const juce::Array<juce::AudioProcessorParameter*>& parameters);
+
+    void write(juce::MemoryBlock& destData, const PresetState& presetState) const;
+
+    /// Restore the parameters from binary data. Returns false, without touching any
+    /// parameter, if the data is not in this format or comes from a newer version. Data
+    /// from version 1 restores the current preset name only.
+    bool read(const void* data, int sizeInBytes, PresetState& presetState) const;
+
+    /// Hashed parameter IDs and plain values stored in binary data, without any parameters
+    /// to apply them to (for offline tools). Returns false if the data is not in this format
+    /// or comes from a newer version.
+    static bool readValues(const void* data, int sizeInBytes,
+                           std::vector<std::pair<juce::uint32, float>>& values, juce::String& presetName);
+
+    static bool isBinaryState(const void* data, int sizeInBytes);
+    static juce::uint32 hashParameterID(const juce::String& parameterID);
+
+private:
+    /// Reads everything up to the preset name and returns the format version; data from a
+    /// newer version is left unread
+    static int readValues(juce::MemoryInputStream& stream, std::vector<std::pair<juce::uint32, float>>& values,
+                          juce::String& presetName);
+
+    int findParameterIndex(juce::uint32 hash) const;
+
+    void writeSnapshot(juce::MemoryOutputStream& stream, const std::vector<float>& snapshot) const;
+    std::vector<float> readSnapshot(juce::MemoryInputStream& stream) const;
+
+    // Sorted by hash
+    std::vector<std::pair<juce::uint32, juce::RangedAudioParameter*>> parameters;
+
+    // Every parameter, in snapshot order
+    juce::Array<juce::AudioProcessorParameter*> allParameters;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StateSerializer)
+};
@@ -0,0 +1,90 @@
+#include "ProfilerOverlay.h"
+
+ProfilerOverlay::ProfilerOverlay(StageProfiler& profilerToShow)
+    : profiler(profilerToShow)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+ProfilerOverlay::~ProfilerOverlay()
+{
+    stopTimer();
+    profiler.setEnabled(false);
+}
+
+void ProfilerOverlay::visibilityChanged()
+{
+    profiler.setEnabled(isVisible());
+    statistics.clear();
+    droppedRecords = 0;
+    
+    if (isVisible())
+        startTimerHz(4);
+    else
+        stopTimer();
+    
+    repaint();
+}
+
+void ProfilerOverlay::timerCallback()
+{
+    statistics = profiler.getStatistics();
+    droppedRecords = profiler.getNumDroppedRecords();
+    repaint();
+}
+
+void ProfilerOverlay::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    
+    // Dark translucent panel
+    g.setColour(juce::Colour(0xe00a0a0a));
+    g.fillRoundedRectangle(bounds, 6.0f);
+    g.setColour(juce::Colour(0xff1a4a66));
+    g.drawRoundedRectangle(bounds.reduced(0.5f), 6.0f, 1.0f);
+    
+    auto area = getLocalBounds().reduced(8, 6);
+    g.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    
+    auto drawRow = [&g, &area](const juce::String& name, const juce::String& min, const juce::String& avg,
+                               const juce::String& p99, const juce::String& load)
+    {
+        auto row = area.removeFromTop(rowHeight);
+        const auto columnWidth = (row.getWidth() - 110) / 4;
+        g.drawText(name, row.removeFromLeft(110), juce::Justification::centredLeft, true);
+        g.drawText(min, row.removeFromLeft(columnWidth), juce::Justification::centredRight, false);
+        g.drawText(avg, row.removeFromLeft(columnWidth), juce::Justification::centredRight, false);
+        g.drawText(p99, row.removeFromLeft(columnWidth), juce::Justification::centredRight, false);
+        g.drawText(load, row, juce::Justification::centredRight, false);
+    };
+    
+    g.setColour(juce::Colour(0xff57c4f1));
+    drawRow("STAGE", "MIN us", "AVG us", "P99 us", "LOAD");
+    
+    if (statistics.empty())
+    {
+        g.setColour(juce::Colour(0xff606060));
+        g.drawText("Waiting for audio...", area.removeFromTop(rowHeight), juce::Justification::centredLeft, false);
+        return;
+    }
+    
+    for (const auto& stage : statistics)
+    {
+        if (area.getHeight() < rowHeight)
+            break;
+        
+        // Highlight stages that eat a noticeable part of the block budget
+        g.setColour(stage.averageLoad > 0.25 ? juce::Colour(0xffff4500) : juce::Colour(0xffd0d0d0));
+        drawRow(stage.name,
+                juce::String(stage.minMicroseconds, 1),
+                juce::String(stage.averageMicroseconds, 1),
+                juce::String(stage.p99Microseconds, 1),
+                juce::String(stage.averageLoad * 100.0, 1) + "%");
+    }
+    
+    if (droppedRecords > 0 && area.getHeight() >= rowHeight)
+    {
+        g.setColour(juce::Colour(0xff606060));
+        g.drawText(juce::String(droppedRecords) + " records dropped", area.removeFromTop(rowHeight), juce::Justification::centredLeft, false);
+    }
+}
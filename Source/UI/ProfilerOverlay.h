@@ -0,0 +1,26 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../DSP/StageProfiler.h"
+
+/// Table of per-stage CPU times drawn over the editor. The profiler only runs while
+/// the overlay is visible, so hiding it brings the processing back to full speed.
+class ProfilerOverlay : public juce::Component, public juce::Timer
+{
+public:
+    explicit ProfilerOverlay(StageProfiler& profilerToShow);
+    ~ProfilerOverlay() override;
+    
+    void paint(juce::Graphics& g) override;
+    void timerCallback() override;
+    void visibilityChanged() override;
+    
+private:
+    StageProfiler& profiler;
+    std::vector<StageProfiler::Statistics> statistics;
+    int droppedRecords = 0;
+    
+    static constexpr int rowHeight = 16;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
@@ -0,0 +1,122 @@
+#include <JuceHeader.h>
+#include "DSP/MultibandSaturation.h"
+#include "DSP/Oversampling.h"
+
+// Unit tests of individual DSP components, headless like the golden-output tests.
+//
+// Usage: spice_dsp_tests
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    /// The multiband crossovers run inside the oversampled block, so they have to be
+    /// designed for the rate the oversampler really produces at every quality. Each
+    /// crossover is checked where an LR4 filter must be 6 dB down.
+    class MultibandCrossoverTest : public juce::UnitTest
+    {
+    public:
+        MultibandCrossoverTest() : juce::UnitTest("Multiband crossover", "DSP") {}
+
+        void runTest() override
+        {
+            for (auto factor : Oversampling<float>::supportedFactors)
+            {
+                beginTest("Oversampling factor " + juce::String(factor));
+
+                expectWithinAbsoluteError(measureBandLevel(factor, MultibandSaturation<float>::lowBand, lowMidCrossover),
+                                          crossoverLevel, tolerance, "low band at the low/mid crossover");
+                expectWithinAbsoluteError(measureBandLevel(factor, MultibandSaturation<float>::highBand, midHighCrossover),
+                                          crossoverLevel, tolerance, "high band at the mid/high crossover");
+            }
+        }
+
+    private:
+        static constexpr float lowMidCrossover = 1000.0f;
+        static constexpr float midHighCrossover = 8000.0f;
+        static constexpr double crossoverLevel = -6.02;
+        static constexpr double tolerance = 0.5;
+
+        /// Level of one band relative to its input, in dB, for a sine at the given frequency
+        /// run through the oversampler and the crossover the way SpiceEngine chains them
+        double measureBandLevel(int factor, MultibandSaturation<float>::Band band, double frequency)
+        {
+            Oversampling<float> oversampling(1, factor, Oversampling<float>::filterHalfBandPolyphaseIIR);
+            oversampling.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 1 });
+
+            const auto multiplier = oversampling.getRateMultiplier();
+            const auto oversampledBlockSize = blockSize * multiplier;
+
+            MultibandSaturation<float> multiband;
+            multiband.prepare({ sampleRate * multiplier, static_cast<juce::uint32>(oversampledBlockSize), 1 });
+            multiband.setCrossoverFrequencies(lowMidCrossover, midHighCrossover);
+            multiband.setSampleRate(sampleRate * multiplier);
+
+            juce::AudioBuffer<float> input(1, blockSize);
+            juce::AudioBuffer<float> bands(MultibandSaturation<float>::numBands, oversampledBlockSize);
+
+            // Half a second, of which the second half is measured once the filters settle
+            const auto numBlocks = static_cast<int>(sampleRate / 2) / blockSize;
+            double inputSumOfSquares = 0.0;
+            double bandSumOfSquares = 0.0;
+            double phase = 0.0;
+            const auto phaseIncrement = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+            for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+            {
+                auto* samples = input.getWritePointer(0);
+
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    samples[i] = static_cast<float>(0.5 * std::sin(phase));
+                    phase += phaseIncrement;
+                }
+
+                juce::dsp::AudioBlock<float> block(input);
+                auto oversampledBlock = oversampling.processSamplesUp(block);
+
+                if (static_cast<int>(oversampledBlock.getNumSamples()) != oversampledBlockSize)
+                {
+                    expect(false, "rate multiplier " + juce::String(multiplier) + " differs from the oversampled block length");
+                    return 0.0;
+                }
+
+                const auto* oversampled = oversampledBlock.getChannelPointer(0);
+                multiband.splitBands(0, oversampled, bands.getWritePointer(MultibandSaturation<float>::lowBand),
+                                     bands.getWritePointer(MultibandSaturation<float>::midBand),
+                                     bands.getWritePointer(MultibandSaturation<float>::highBand), oversampledBlockSize);
+
+                if (blockIndex >= numBlocks / 2)
+                {
+                    const auto* bandSamples = bands.getReadPointer(band);
+
+                    for (int i = 0; i < oversampledBlockSize; ++i)
+                    {
+                        inputSumOfSquares += static_cast<double>(oversampled[i]) * oversampled[i];
+                        bandSumOfSquares += static_cast<double>(bandSamples[i]) * bandSamples[i];
+                    }
+                }
+            }
+
+            return 10.0 * std::log10(bandSumOfSquares / inputSumOfSquares);
+        }
+    };
+
+    MultibandCrossoverTest multibandCrossoverTest;
+}
+
+int main()
+{
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("DSP");
+
+    int numFailures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    std::cout << (numFailures == 0 ? "All tests passed" : juce::String(numFailures) + " failures") << std::endl;
+    return numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#include "GoldenComparison.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace golden
+{
+    namespace
+    {
+        constexpr int fftOrder = 11;
+        constexpr int fftSize = 1 << fftOrder;
+        constexpr int numBins = fftSize / 2 + 1;
+
+        // Bins more than this far below the reference peak are left out of the spectral
+        // comparison, where a tiny absolute change is a huge change in dB
+        constexpr double spectralFloorDb = -80.0;
+
+        /// Power spectrum averaged over Hann windowed frames with 50% overlap
+        std::vector<double> getAveragePowerSpectrum(const float* samples, int numSamples)
+        {
+            juce::dsp::FFT fft(fftOrder);
+            juce::dsp::WindowingFunction<float> window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+            std::vector<float> frame(static_cast<size_t>(fftSize * 2));
+            std::vector<double> power(static_cast<size_t>(numBins), 0.0);
+            int numFrames = 0;
+
+            // Signals shorter than one frame are zero padded into a single frame
+            for (int start = 0; start == 0 || start + fftSize <= numSamples; start += fftSize / 2)
+            {
+                std::fill(frame.begin(), frame.end(), 0.0f);
+                std::memcpy(frame.data(), samples + start, sizeof(float) * static_cast<size_t>(juce::jmin(fftSize, numSamples - start)));
+
+                window.multiplyWithWindowingTable(frame.data(), static_cast<size_t>(fftSize));
+                fft.performFrequencyOnlyForwardTransform(frame.data(), true);
+
+                for (int bin = 0; bin < numBins; ++bin)
+                    power[static_cast<size_t>(bin)] += static_cast<double>(frame[static_cast<size_t>(bin)]) * frame[static_cast<size_t>(bin)];
+
+                ++numFrames;
+            }
+
+            for (auto& value : power)
+                value /= numFrames;
+
+            return power;
+        }
+
+        double getMaxSpectralDifferenceDb(const float* rendered, const float* golden, int numSamples)
+        {
+            const auto renderedPower = getAveragePowerSpectrum(rendered, numSamples);
+            const auto goldenPower = getAveragePowerSpectrum(golden, numSamples);
+
+            const auto peak = *std::max_element(goldenPower.begin(), goldenPower.end());
+            const auto floor = peak * std::pow(10.0, spectralFloorDb / 10.0);
+            double maxDifference = 0.0;
+
+            for (size_t bin = 0; bin < goldenPower.size(); ++bin)
+            {
+                if (goldenPower[bin] <= floor || goldenPower[bin] <= 0.0)
+                    continue;
+
+                const auto difference = 10.0 * std::log10((renderedPower[bin] + floor) / (goldenPower[bin] + floor));
+                maxDifference = juce::jmax(maxDifference, std::abs(difference));
+            }
+
+            return maxDifference;
+        }
+    }
+
+    bool parseComparisonMode(const juce::String& text, ComparisonMode& mode)
+    {
+        if (text == "exact")    { mode = ComparisonMode::bitExact;    return true; }
+        if (text == "maxabs")   { mode = ComparisonMode::maxAbsError; return true; }
+        if (text == "spectral") { mode = ComparisonMode::spectral;    return true; }
+
+        return false;
+    }
+
+    juce::String getComparisonModeName(ComparisonMode mode)
+    {
+        switch (mode)
+        {
+            case ComparisonMode::bitExact:    return "exact";
+            case ComparisonMode::maxAbsError: return "maxabs";
+            case ComparisonMode::spectral:    return "spectral";
+        }
+
+        return {};
+    }
+
+    double getDefaultTolerance(ComparisonMode mode)
+    {
+        switch (mode)
+        {
+            case ComparisonMode::bitExact:    return 0.0;
+            case ComparisonMode::maxAbsError: return 1.0e-6;
+            case ComparisonMode::spectral:    return 0.1;
+        }
+
+        return 0.0;
+    }
+
+    juce::String ComparisonResult::describe() const
+    {
+        return juce::String(numDifferingSamples) + " samples differ, max abs error "
+             + juce::String(maxAbsError, 9) + ", max spectral difference "
+             + juce::String(maxSpectralDifferenceDb, 3) + " dB";
+    }
+
+    ComparisonResult compare(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& golden,
+                             const std::vector<int>& signalLengths, ComparisonMode mode, double tolerance)
+    {
+        ComparisonResult result;
+
+        if (rendered.getNumChannels() != golden.getNumChannels() || rendered.getNumSamples() != golden.getNumSamples())
+        {
+            result.numDifferingSamples = juce::jmax(rendered.getNumSamples(), golden.getNumSamples());
+            result.maxAbsError = std::numeric_limits<double>::infinity();
+            result.maxSpectralDifferenceDb = std::numeric_limits<double>::infinity();
+            return result;
+        }
+
+        for (int channel = 0; channel < golden.getNumChannels(); ++channel)
+        {
+            const auto* a = rendered.getReadPointer(channel);
+            const auto* b = golden.getReadPointer(channel);
+
+            for (int i = 0; i < golden.getNumSamples(); ++i)
+            {
+                // Bitwise, so that NaNs and signed zeros count as well
+                if (std::memcmp(a + i, b + i, sizeof(float)) != 0)
+                    ++result.numDifferingSamples;
+
+                const auto error = std::abs(static_cast<double>(a[i]) - b[i]);
+                result.maxAbsError = std::isnan(error) ? std::numeric_limits<double>::infinity()
+                                                       : juce::jmax(result.maxAbsError, error);
+            }
+
+            int start = 0;
+
+            for (const auto length : signalLengths)
+            {
+                result.maxSpectralDifferenceDb = juce::jmax(result.maxSpectralDifferenceDb,
+                                                            getMaxSpectralDifferenceDb(a + start, b + start, length));
+                start += length;
+            }
+        }
+
+        switch (mode)
+        {
+            case ComparisonMode::bitExact:    result.passed = result.numDifferingSamples == 0; break;
+            case ComparisonMode::maxAbsError: result.passed = result.maxAbsError <= tolerance; break;
+            case ComparisonMode::spectral:    result.passed = result.maxSpectralDifferenceDb <= tolerance; break;
+        }
+
+        return result;
+    }
+}
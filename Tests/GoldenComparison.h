@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+namespace golden
+{
+    /// How closely a render has to match its golden file
+    enum class ComparisonMode
+    {
+        bitExact,       // Every sample identical
+        maxAbsError,    // Largest sample difference at most the tolerance (linear)
+        spectral        // Averaged magnitude spectra of every signal within the tolerance (dB)
+    };
+
+    bool parseComparisonMode(const juce::String& text, ComparisonMode& mode);
+    juce::String getComparisonModeName(ComparisonMode mode);
+
+    /// Tolerance used when none is given: 0 for bitExact, 1e-6 (-120 dBFS) for maxAbsError
+    /// and 0.1 dB for spectral
+    double getDefaultTolerance(ComparisonMode mode);
+
+    struct ComparisonResult
+    {
+        bool passed = false;
+        int numDifferingSamples = 0;
+        double maxAbsError = 0.0;
+        double maxSpectralDifferenceDb = 0.0;
+
+        /// All three figures, for failure messages
+        juce::String describe() const;
+    };
+
+    /// Compare a render with its golden recording. Both hold the reference signals back to
+    /// back with the given lengths; the spectra are taken per signal. Every figure is
+    /// computed whatever the mode, the mode only decides which one has to pass.
+    ComparisonResult compare(const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& golden,
+                             const std::vector<int>& signalLengths, ComparisonMode mode, double tolerance);
+}
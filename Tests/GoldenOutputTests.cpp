@@ -0,0 +1,266 @@
+#include <JuceHeader.h>
+#include <iterator>
+#include "AsyncWavWriter.h"
+#include "DSP/SpiceEngine.h"
+#include "GoldenComparison.h"
+#include "MappedWavReader.h"
+#include "ReferenceSignals.h"
+
+// Renders the reference signals through every saturation model, cabinet (and no cabinet)
+// and oversampling quality, and compares each render with its golden recording.
+//
+// Usage: spice_golden_tests --golden-dir <directory> [--record]
+//                           [--mode exact|maxabs|spectral] [--tolerance <value>]
+//                           [--isa baseline|sse2|neon|avx2|avx512]
+//
+// --record writes the golden files instead of comparing, e.g. from the commit before a
+// performance change; the comparison run on the changed code then shows what moved.
+// The kernels run in the baseline instruction set unless --isa names another one, and a
+// recording notes the set it was made with. The wider builds contract multiply-adds, so
+// compare them to a baseline recording in maxabs or spectral mode; exact mode refuses to
+// compare across instruction sets.
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int numQualities = 3;
+    constexpr int numCabinets = 10;
+
+    // Written next to the golden files, with the instruction set they were recorded with
+    constexpr const char* recordingInfoFileName = "recording.xml";
+
+    const char* const modelNames[] = { "Tube", "Transistor", "Transformer", "Tape", "Diode", "Vintage",
+                                       "Warm", "Bright", "FuzzBox", "Overdrive", "Tube12AX7" };
+
+    struct Settings
+    {
+        juce::File goldenDirectory;
+        bool record = false;
+        golden::ComparisonMode mode = golden::ComparisonMode::bitExact;
+        double tolerance = 0.0;
+    };
+
+    struct TestCase
+    {
+        int model = 0;
+        int cabinet = -1;   // -1 = cabinet off
+        int quality = 0;
+
+        juce::String getName() const
+        {
+            return juce::String(modelNames[model]) + ", cabinet " + (cabinet < 0 ? juce::String("off") : juce::String(cabinet))
+                 + ", quality " + juce::String(quality);
+        }
+
+        juce::String getFileName() const
+        {
+            return "model" + juce::String(model).paddedLeft('0', 2)
+                 + "_cabinet" + (cabinet < 0 ? juce::String("off") : juce::String(cabinet).paddedLeft('0', 2))
+                 + "_quality" + juce::String(quality) + ".wav";
+        }
+
+        SpiceParameters getParameters() const
+        {
+            SpiceParameters parameters;
+            parameters.model = model;
+            parameters.drive = 60.0f;
+            parameters.quality = quality;
+            parameters.cabinetEnabled = cabinet >= 0;
+            parameters.cabinetModel = juce::jmax(0, cabinet);
+            return parameters;
+        }
+    };
+}
+
+class GoldenOutputTests : public juce::UnitTest
+{
+public:
+    explicit GoldenOutputTests(const Settings& settingsToUse)
+        : juce::UnitTest("Golden output", "Golden"),
+          settings(settingsToUse)
+    {
+    }
+
+    void runTest() override
+    {
+        const auto signals = golden::createReferenceSignals(sampleRate);
+
+        for (const auto& signal : signals)
+            signalLengths.push_back(signal.audio.getNumSamples());
+
+        for (int model = 0; model < static_cast<int>(std::size(modelNames)); ++model)
+        {
+            beginTest(modelNames[model]);
+
+            for (int cabinet = -1; cabinet < numCabinets; ++cabinet)
+                for (int quality = 0; quality < numQualities; ++quality)
+                    runCase({ model, cabinet, quality }, signals);
+        }
+    }
+
+private:
+    void runCase(const TestCase& testCase, const std::vector<golden::ReferenceSignal>& signals)
+    {
+        const auto rendered = render(testCase, signals);
+        const auto file = settings.goldenDirectory.getChildFile(testCase.getFileName());
+
+        if (settings.record)
+        {
+            offline::AsyncWavWriter writer(file, sampleRate, rendered.getNumChannels(), offline::SampleFormat::float32);
+            writer.write(rendered, 0, rendered.getNumSamples());
+            const auto result = writer.finish();
+            expect(result.wasOk(), file.getFullPathName() + ": " + result.getErrorMessage());
+            return;
+        }
+
+        offline::MappedWavReader reader(file);
+
+        if (! reader.openedOk())
+        {
+            expect(false, testCase.getName() + ": no golden file " + file.getFullPathName() + " (" + reader.getError() + ")");
+            return;
+        }
+
+        juce::AudioBuffer<float> recorded(reader.getNumChannels(), static_cast<int>(reader.getLengthInSamples()));
+        reader.read(recorded, 0, 0, recorded.getNumSamples());
+
+        const auto comparison = golden::compare(rendered, recorded, signalLengths, settings.mode, settings.tolerance);
+        expect(comparison.passed, testCase.getName() + ": " + comparison.describe());
+    }
+
+    /// Every signal through a freshly prepared engine, one after the other
+    static juce::AudioBuffer<float> render(const TestCase& testCase, const std::vector<golden::ReferenceSignal>& signals)
+    {
+        const auto parameters = testCase.getParameters();
+        const auto numChannels = signals.front().audio.getNumChannels();
+
+        int totalLength = 0;
+
+        for (const auto& signal : signals)
+            totalLength += signal.audio.getNumSamples();
+
+        juce::AudioBuffer<float> output(numChannels, totalLength);
+        int position = 0;
+
+        for (const auto& signal : signals)
+        {
+            SpiceEngine<float> engine;
+            engine.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) },
+                           juce::AudioChannelSet::canonicalChannelSet(numChannels), parameters);
+
+            juce::AudioBuffer<float> block(numChannels, blockSize);
+
+            for (int start = 0; start < signal.audio.getNumSamples(); start += blockSize)
+            {
+                const auto numSamples = juce::jmin(blockSize, signal.audio.getNumSamples() - start);
+                block.setSize(numChannels, numSamples, false, false, true);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    block.copyFrom(channel, 0, signal.audio, channel, start, numSamples);
+
+                engine.processBlock(block, parameters);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    output.copyFrom(channel, position + start, block, channel, 0, numSamples);
+            }
+
+            position += signal.audio.getNumSamples();
+        }
+
+        return output;
+    }
+
+    const Settings settings;
+    std::vector<int> signalLengths;
+};
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList arguments(argc, argv);
+    Settings settings;
+
+    if (! arguments.containsOption("--golden-dir"))
+    {
+        std::cerr << "Usage: spice_golden_tests --golden-dir <directory> [--record]\n"
+                     "                          [--mode exact|maxabs|spectral] [--tolerance <value>]\n"
+                     "                          [--isa baseline|sse2|neon|avx2|avx512]" << std::endl;
+        return 1;
+    }
+
+    settings.goldenDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption("--golden-dir"));
+    settings.record = arguments.containsOption("--record");
+
+    if (arguments.containsOption("--mode") && ! golden::parseComparisonMode(arguments.getValueForOption("--mode"), settings.mode))
+    {
+        std::cerr << "Unknown comparison mode " << arguments.getValueForOption("--mode") << std::endl;
+        return 1;
+    }
+
+    settings.tolerance = arguments.containsOption("--tolerance") ? arguments.getValueForOption("--tolerance").getDoubleValue()
+                                                                 : golden::getDefaultTolerance(settings.mode);
+
+    // Not the widest set the CPU supports, so recordings and comparisons agree across machines
+    auto instructionSet = CpuDispatch::InstructionSet::baseline;
+
+    if (arguments.containsOption("--isa")
+          && (! CpuDispatch::parseName(arguments.getValueForOption("--isa"), instructionSet)
+                || ! CpuDispatch::isSupported(instructionSet)))
+    {
+        std::cerr << "Instruction set " << arguments.getValueForOption("--isa") << " is unknown or not supported here" << std::endl;
+        return 1;
+    }
+
+    CpuDispatch::setActive(instructionSet);
+    const juce::String isaName = CpuDispatch::getName(instructionSet);
+    const auto recordingInfoFile = settings.goldenDirectory.getChildFile(recordingInfoFileName);
+
+    if (settings.record)
+    {
+        if (settings.goldenDirectory.createDirectory().failed())
+        {
+            std::cerr << "Could not create " << settings.goldenDirectory.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        juce::XmlElement recordingInfo("GoldenRecording");
+        recordingInfo.setAttribute("isa", isaName);
+
+        if (! recordingInfo.writeTo(recordingInfoFile))
+        {
+            std::cerr << "Could not write " << recordingInfoFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else if (auto recordingInfo = juce::parseXML(recordingInfoFile))
+    {
+        const auto recordedIsa = recordingInfo->getStringAttribute("isa");
+
+        // Contracted multiply-adds change the last bits, so bit-exact only holds within one set
+        if (recordedIsa != isaName && settings.mode == golden::ComparisonMode::bitExact)
+        {
+            std::cerr << "Golden files were recorded with " << recordedIsa << " kernels, which cannot match "
+                      << isaName << " bit for bit; pass --isa " << recordedIsa << " or compare in maxabs or spectral mode" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << (settings.record ? "Recording golden files in " : "Comparing against ")
+              << settings.goldenDirectory.getFullPathName()
+              << " with " << CpuDispatch::getName(CpuDispatch::getActive()) << " kernels"
+              << (settings.record ? juce::String() : " (" + golden::getComparisonModeName(settings.mode)
+                                                     + ", tolerance " + juce::String(settings.tolerance) + ")")
+              << std::endl;
+
+    GoldenOutputTests tests(settings);
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTests({ &tests });
+
+    int numFailures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    return numFailures == 0 ? 0 : 1;
+}
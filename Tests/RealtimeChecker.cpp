@@ -0,0 +1,282 @@
+#include "RealtimeChecker.h"
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <poll.h>
+ #include <pthread.h>
+ #include <sched.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace realtime
+{
+    namespace
+    {
+        constexpr auto numViolationTypes = static_cast<size_t>(Violation::numViolations);
+
+        // Plain storage only: these are touched from inside malloc, so nothing here may allocate
+        thread_local int sectionDepth = 0;
+        thread_local int lockAllowanceDepth = 0;
+        std::array<std::atomic<int>, numViolationTypes> counts {};
+        std::atomic<const char*> firstFunction { nullptr };
+        const bool abortOnViolation = std::getenv("SPICE_RT_ABORT") != nullptr;
+
+        void report(Violation type, const char* function) noexcept
+        {
+            if (sectionDepth == 0 || (type == Violation::lock && lockAllowanceDepth > 0))
+                return;
+
+            counts[static_cast<size_t>(type)].fetch_add(1);
+
+            const char* expected = nullptr;
+            firstFunction.compare_exchange_strong(expected, function);
+
+            if (abortOnViolation)
+                std::abort();
+        }
+    }
+
+    ScopedRealtimeSection::ScopedRealtimeSection() noexcept  { ++sectionDepth; }
+    ScopedRealtimeSection::~ScopedRealtimeSection() noexcept { --sectionDepth; }
+
+    ScopedLockAllowance::ScopedLockAllowance() noexcept  { ++lockAllowanceDepth; }
+    ScopedLockAllowance::~ScopedLockAllowance() noexcept { --lockAllowanceDepth; }
+
+    bool isCheckingSupported()
+    {
+       #if JUCE_LINUX
+        return true;
+       #else
+        return false;
+       #endif
+    }
+
+    void resetViolations()
+    {
+        for (auto& count : counts)
+            count.store(0);
+
+        firstFunction.store(nullptr);
+    }
+
+    int getNumViolations(Violation type)
+    {
+        return counts[static_cast<size_t>(type)].load();
+    }
+
+    int getNumViolations()
+    {
+        int total = 0;
+
+        for (const auto& count : counts)
+            total += count.load();
+
+        return total;
+    }
+
+    juce::String describeViolations()
+    {
+        if (getNumViolations() == 0)
+            return "no violations";
+
+        juce::String description;
+        description << getNumViolations(Violation::allocation) << " allocations, "
+                    << getNumViolations(Violation::deallocation) << " deallocations, "
+                    << getNumViolations(Violation::lock) << " locks, "
+                    << getNumViolations(Violation::systemCall) << " system calls; first in "
+                    << (firstFunction.load() != nullptr ? firstFunction.load() : "?");
+        return description;
+    }
+}
+
+#if JUCE_LINUX
+//==============================================================================
+// Interposed C library functions. Definitions in the executable take precedence over
+// libc's, for JUCE (linked in statically) as well as for libstdc++'s operator new.
+
+using realtime::Violation;
+using realtime::report;
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+
+    void* malloc(size_t size)
+    {
+        report(Violation::allocation, "malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        report(Violation::allocation, "calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size)
+    {
+        report(Violation::allocation, "realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        report(Violation::allocation, "memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        report(Violation::allocation, "aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size)
+    {
+        report(Violation::allocation, "posix_memalign");
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            report(Violation::deallocation, "free");
+
+        __libc_free(pointer);
+    }
+}
+
+namespace
+{
+    /// The next definitions in link order, i.e. the C library's, of the functions hooked
+    /// below. Zero until resolveNextDefinitions() has run.
+    struct NextDefinitions
+    {
+        decltype(&::pthread_mutex_lock) pthread_mutex_lock;
+        decltype(&::pthread_rwlock_rdlock) pthread_rwlock_rdlock;
+        decltype(&::pthread_rwlock_wrlock) pthread_rwlock_wrlock;
+        decltype(&::sem_wait) sem_wait;
+        decltype(&::read) read;
+        decltype(&::write) write;
+        decltype(&::poll) poll;
+        decltype(&::nanosleep) nanosleep;
+        decltype(&::usleep) usleep;
+        decltype(&::sched_yield) sched_yield;
+    };
+
+    NextDefinitions next {};
+
+    void resolveNextDefinitions() noexcept
+    {
+       #define SPICE_RESOLVE(function) \
+        next.function = reinterpret_cast<decltype(next.function)>(dlsym(RTLD_NEXT, #function))
+
+        SPICE_RESOLVE(pthread_mutex_lock);
+        SPICE_RESOLVE(pthread_rwlock_rdlock);
+        SPICE_RESOLVE(pthread_rwlock_wrlock);
+        SPICE_RESOLVE(sem_wait);
+        SPICE_RESOLVE(read);
+        SPICE_RESOLVE(write);
+        SPICE_RESOLVE(poll);
+        SPICE_RESOLVE(nanosleep);
+        SPICE_RESOLVE(usleep);
+        SPICE_RESOLVE(sched_yield);
+
+       #undef SPICE_RESOLVE
+    }
+
+    // dlsym may itself allocate and lock, so every symbol is resolved once at load time,
+    // ahead of the program's own static constructors and long before the first
+    // ScopedRealtimeSection. Only shared libraries initialised before this executable can
+    // call a hook earlier; the hook then resolves everything itself, still single-threaded.
+    __attribute__((constructor(101))) void resolveAtStartup()
+    {
+        resolveNextDefinitions();
+    }
+
+    #define SPICE_FORWARD(function, ...) \
+        if (next.function == nullptr) \
+            resolveNextDefinitions(); \
+        return next.function(__VA_ARGS__)
+}
+
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        report(Violation::lock, "pthread_mutex_lock");
+        SPICE_FORWARD(pthread_mutex_lock, mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+    {
+        report(Violation::lock, "pthread_rwlock_rdlock");
+        SPICE_FORWARD(pthread_rwlock_rdlock, lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+    {
+        report(Violation::lock, "pthread_rwlock_wrlock");
+        SPICE_FORWARD(pthread_rwlock_wrlock, lock);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        report(Violation::lock, "sem_wait");
+        SPICE_FORWARD(sem_wait, semaphore);
+    }
+
+    ssize_t read(int fd, void* data, size_t size)
+    {
+        report(Violation::systemCall, "read");
+        SPICE_FORWARD(read, fd, data, size);
+    }
+
+    ssize_t write(int fd, const void* data, size_t size)
+    {
+        report(Violation::systemCall, "write");
+        SPICE_FORWARD(write, fd, data, size);
+    }
+
+    int poll(struct pollfd* fds, nfds_t numFds, int timeout)
+    {
+        report(Violation::systemCall, "poll");
+        SPICE_FORWARD(poll, fds, numFds, timeout);
+    }
+
+    int nanosleep(const struct timespec* duration, struct timespec* remaining)
+    {
+        report(Violation::systemCall, "nanosleep");
+        SPICE_FORWARD(nanosleep, duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        report(Violation::systemCall, "usleep");
+        SPICE_FORWARD(usleep, microseconds);
+    }
+
+    int sched_yield()
+    {
+        report(Violation::systemCall, "sched_yield");
+        SPICE_FORWARD(sched_yield);
+    }
+}
+
+#undef SPICE_FORWARD
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/// Catches calls that have no place on the audio thread.
+///
+/// The test executable interposes malloc and friends, pthread_mutex_lock, the rwlock and
+/// semaphore waits and a few blocking system calls (read, write, poll, sleeps, yields).
+/// Inside a ScopedRealtimeSection every such call on that thread is counted as a violation;
+/// everywhere else the hooks only forward to the C library. Set SPICE_RT_ABORT=1 to abort
+/// on the first violation instead, so a debugger shows where it came from.
+namespace realtime
+{
+    enum class Violation
+    {
+        allocation,
+        deallocation,
+        lock,
+        systemCall,
+        numViolations
+    };
+
+    /// Arms the hooks for the calling thread while it exists. Sections can nest.
+    class ScopedRealtimeSection
+    {
+    public:
+        ScopedRealtimeSection() noexcept;
+        ~ScopedRealtimeSection() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+    };
+
+    /// Stops counting locks on the calling thread while it exists. Only for library code
+    /// that locks on the audio thread by design, such as JUCE's parameter listener lists
+    /// when a host's automation is applied; allocations and system calls are still caught.
+    class ScopedLockAllowance
+    {
+    public:
+        ScopedLockAllowance() noexcept;
+        ~ScopedLockAllowance() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedLockAllowance)
+    };
+
+    /// False on platforms where the hooks are not compiled in; nothing is checked there
+    bool isCheckingSupported();
+
+    /// Forget all violations seen so far
+    void resetViolations();
+
+    int getNumViolations();
+    int getNumViolations(Violation type);
+
+    /// Counts per type and the first function caught, for test failure messages
+    juce::String describeViolations();
+}
@@ -0,0 +1,415 @@
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "RealtimeChecker.h"
+
+namespace
+{
+    void runOnMessageThread(std::function<void()> function)
+    {
+        juce::MessageManager::getInstance()->callFunctionOnMessageThread([](void* data) -> void*
+        {
+            (*static_cast<std::function<void()>*>(data))();
+            return nullptr;
+        }, &function);
+    }
+
+    /// Stands in for a host's audio thread: calls processBlock with varying block sizes as
+    /// fast as the processor allows, applying queued automation right before each block.
+    /// Only the automation and the processBlock call are checked.
+    class SimulatedAudioThread : public juce::Thread
+    {
+    public:
+        SimulatedAudioThread(juce::AudioProcessor& processorToUse, int maximumBlockSize)
+            : juce::Thread("Simulated audio"),
+              processor(processorToUse),
+              maxBlockSize(maximumBlockSize),
+              floatBuffer(processorToUse.getTotalNumOutputChannels(), maximumBlockSize),
+              doubleBuffer(processorToUse.getTotalNumOutputChannels(), maximumBlockSize)
+        {
+        }
+
+        ~SimulatedAudioThread() override
+        {
+            stopThread(-1);
+        }
+
+        /// Feed digital silence instead of noise, for the silence detection path
+        void setSilent(bool shouldBeSilent) { silent.store(shouldBeSilent); }
+
+        int getNumBlocksProcessed() const { return numBlocks.load(); }
+
+        /// Queue a parameter change for the audio thread to make before its next block, the
+        /// way a host applies automation (one thread only)
+        void automate(juce::AudioProcessorParameter& parameter, float normalisedValue)
+        {
+            while (automationFifo.getFreeSpace() == 0 && ! threadShouldExit())
+                juce::Thread::sleep(1);
+
+            const auto scope = automationFifo.write(1);
+
+            if (scope.blockSize1 > 0)
+                automation[static_cast<size_t>(scope.startIndex1)] = { &parameter, normalisedValue };
+        }
+
+        void run() override
+        {
+            juce::Random random(42);
+
+            while (! threadShouldExit())
+            {
+                const auto numSamples = random.nextInt({ 16, maxBlockSize + 1 });
+
+                if (processor.isUsingDoublePrecision())
+                    processBlock(doubleBuffer, numSamples, random);
+                else
+                    processBlock(floatBuffer, numSamples, random);
+
+                numBlocks.fetch_add(1);
+
+                // Give the message thread room, as a host's callback period would
+                wait(1);
+            }
+        }
+
+    private:
+        template <typename SampleType>
+        void processBlock(juce::AudioBuffer<SampleType>& storage, int numSamples, juce::Random& random)
+        {
+            // Refers to the preallocated channels, like the buffer a host passes in
+            juce::AudioBuffer<SampleType> block(storage.getArrayOfWritePointers(), storage.getNumChannels(), numSamples);
+            const auto isSilent = silent.load();
+
+            for (int channel = 0; channel < block.getNumChannels(); ++channel)
+            {
+                auto* data = block.getWritePointer(channel);
+
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = isSilent ? SampleType(0) : static_cast<SampleType>(random.nextFloat() - 0.5f);
+            }
+
+            const realtime::ScopedRealtimeSection realtimeSection;
+            applyAutomation();
+            processor.processBlock(block, midi);
+        }
+
+        struct ParameterChange
+        {
+            juce::AudioProcessorParameter* parameter = nullptr;
+            float value = 0.0f;
+        };
+
+        /// As the JUCE plugin wrappers do: store the value, then notify the parameter's
+        /// listeners, the processor's own among them, from the audio thread
+        void applyAutomation()
+        {
+            const auto scope = automationFifo.read(automationFifo.getNumReady());
+
+            auto apply = [this](int start, int size)
+            {
+                for (int i = start; i < start + size; ++i)
+                {
+                    const auto& change = automation[static_cast<size_t>(i)];
+                    change.parameter->setValue(change.value);
+
+                    // JUCE locks its listener lists here under every host; anything the
+                    // listeners allocate or call into the system is still caught
+                    const realtime::ScopedLockAllowance listenerLocks;
+                    change.parameter->sendValueChangedMessageToListeners(change.value);
+                }
+            };
+
+            apply(scope.startIndex1, scope.blockSize1);
+            apply(scope.startIndex2, scope.blockSize2);
+        }
+
+        static constexpr int automationQueueSize = 256;
+
+        juce::AudioProcessor& processor;
+        const int maxBlockSize;
+        juce::AudioBuffer<float> floatBuffer;
+        juce::AudioBuffer<double> doubleBuffer;
+        juce::MidiBuffer midi;
+        juce::AbstractFifo automationFifo { automationQueueSize };
+        std::array<ParameterChange, automationQueueSize> automation;
+        std::atomic<bool> silent { false };
+        std::atomic<int> numBlocks { 0 };
+
+        JUCE_DECLARE_NON_COPYABLE(SimulatedAudioThread)
+    };
+}
+
+/// Drives the processor through parameter, preset, quality, precision and editor changes
+/// while a simulated audio thread runs, and fails on any allocation, lock or blocking
+/// system call made from inside processBlock or the automation applied before it.
+class RealtimeSafetyTests : public juce::UnitTest
+{
+public:
+    RealtimeSafetyTests() : juce::UnitTest("Real-time safety", "Realtime") {}
+
+    void runTest() override
+    {
+        runOnMessageThread([this] { processor = std::make_unique<SpiceAudioProcessor>(); });
+        waitForPresetLibrary();
+
+        beginTest("Stage combinations");
+        runScenario(juce::AudioProcessor::singlePrecision, [this](SimulatedAudioThread&) { switchStageCombinations(); });
+
+        beginTest("Every choice of every choice parameter");
+        runScenario(juce::AudioProcessor::singlePrecision, [this](SimulatedAudioThread&) { stepThroughChoices(); });
+
+        beginTest("Oversampling quality changes");
+        runScenario(juce::AudioProcessor::singlePrecision, [this](SimulatedAudioThread&) { switchQuality(); });
+
+        beginTest("Preset changes, A/B slots and morphing");
+        runScenario(juce::AudioProcessor::singlePrecision, [this](SimulatedAudioThread&) { changePresets(); });
+
+        beginTest("State restore");
+        runScenario(juce::AudioProcessor::singlePrecision, [this](SimulatedAudioThread&) { restoreState(); });
+
+        beginTest("Editor open with the profiler enabled");
+        runScenario(juce::AudioProcessor::singlePrecision, [this](SimulatedAudioThread&) { openEditorWithProfiler(); });
+
+        beginTest("Silence detection");
+        runScenario(juce::AudioProcessor::singlePrecision, [this](SimulatedAudioThread& audioThread) { alternateSilence(audioThread); });
+
+        beginTest("Double precision");
+        runScenario(juce::AudioProcessor::doublePrecision, [this](SimulatedAudioThread&)
+        {
+            switchStageCombinations();
+            switchQuality();
+            changePresets();
+        });
+
+        runOnMessageThread([this] { processor.reset(); });
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+
+    /// Prepare the processor, run the changes against a running audio thread and check
+    /// that nothing inside processBlock broke the rules
+    void runScenario(juce::AudioProcessor::ProcessingPrecision precision, std::function<void(SimulatedAudioThread&)> changes)
+    {
+        runOnMessageThread([this, precision]
+        {
+            processor->releaseResources();
+            processor->setProcessingPrecision(precision);
+            processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor->prepareToPlay(sampleRate, blockSize);
+        });
+
+        realtime::resetViolations();
+
+        SimulatedAudioThread audioThread(*processor, blockSize);
+        audioThread.startThread(juce::Thread::Priority::highest);
+
+        automationThread = &audioThread;
+        changes(audioThread);
+        juce::Thread::sleep(200);
+        automationThread = nullptr;
+        audioThread.stopThread(-1);
+
+        expectGreaterThan(audioThread.getNumBlocksProcessed(), 0);
+        expectEquals(realtime::getNumViolations(), 0, realtime::describeViolations());
+    }
+
+    void waitForPresetLibrary()
+    {
+        for (int attempt = 0; attempt < 100 && presetNames.isEmpty(); ++attempt)
+        {
+            runOnMessageThread([this] { presetNames = processor->getPresetManager().getAllPresets(); });
+
+            if (presetNames.isEmpty())
+                juce::Thread::sleep(50);
+        }
+
+        expect(! presetNames.isEmpty(), "Factory presets were not loaded");
+    }
+
+    juce::RangedAudioParameter& getParameter(const juce::String& parameterID)
+    {
+        auto* parameter = processor->getAPVTS().getParameter(parameterID);
+        jassert(parameter != nullptr);
+        return *parameter;
+    }
+
+    /// Sets a parameter the way a host's automation would: on the simulated audio thread,
+    /// inside its checked section. Without one it is set from the test thread.
+    void setParameter(juce::AudioProcessorParameter& parameter, float normalisedValue)
+    {
+        if (automationThread != nullptr)
+            automationThread->automate(parameter, normalisedValue);
+        else
+            parameter.setValueNotifyingHost(normalisedValue);
+    }
+
+    void setParameter(const juce::String& parameterID, float normalisedValue)
+    {
+        setParameter(getParameter(parameterID), normalisedValue);
+    }
+
+    void randomiseContinuousParameters()
+    {
+        for (auto* parameter : processor->getParameters())
+            if (auto* floatParameter = dynamic_cast<juce::AudioParameterFloat*>(parameter))
+                setParameter(*floatParameter, random.nextFloat());
+    }
+
+    void switchStageCombinations()
+    {
+        const juce::StringArray stageParameters { "gateEnabled", "cabinetEnabled", "limiterEnabled",
+                                                  "midSideEnabled", "autoGain", "multibandEnabled" };
+
+        for (int combination = 0; combination < (1 << stageParameters.size()); ++combination)
+        {
+            for (int i = 0; i < stageParameters.size(); ++i)
+                setParameter(stageParameters[i], (combination >> i) & 1 ? 1.0f : 0.0f);
+
+            randomiseContinuousParameters();
+            juce::Thread::sleep(30);
+        }
+    }
+
+    void stepThroughChoices()
+    {
+        for (auto* parameter : processor->getParameters())
+        {
+            if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(parameter))
+            {
+                for (int i = 0; i < choice->choices.size(); ++i)
+                {
+                    setParameter(*choice, choice->convertTo0to1(static_cast<float>(i)));
+                    juce::Thread::sleep(30);
+                }
+            }
+        }
+    }
+
+    void switchQuality()
+    {
+        auto& quality = getParameter("quality");
+        const auto numSteps = quality.getNumSteps();
+
+        for (int i = 0; i < 40; ++i)
+        {
+            setParameter(quality, static_cast<float>(random.nextInt(numSteps)) / static_cast<float>(juce::jmax(1, numSteps - 1)));
+            juce::Thread::sleep(random.nextInt({ 1, 40 }));
+        }
+    }
+
+    void changePresets()
+    {
+        auto& presetManager = processor->getPresetManager();
+
+        for (int i = 0; i < juce::jmin(8, presetNames.size()); ++i)
+        {
+            const auto name = presetNames[i];
+            runOnMessageThread([&presetManager, name] { presetManager.loadPresetSmooth(name); });
+            juce::Thread::sleep(60);
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            runOnMessageThread([&presetManager] { presetManager.loadNextPreset(); });
+            juce::Thread::sleep(60);
+        }
+
+        runOnMessageThread([&presetManager] { presetManager.selectSlot(PresetManager::Slot::b); });
+        juce::Thread::sleep(100);
+        runOnMessageThread([&presetManager] { presetManager.selectSlot(PresetManager::Slot::a); });
+        juce::Thread::sleep(100);
+
+        juce::StringArray morphPresets;
+
+        for (int i = 0; i < juce::jmin(3, presetNames.size()); ++i)
+            morphPresets.add(presetNames[i]);
+
+        runOnMessageThread([&presetManager, morphPresets] { presetManager.setMorphPresets(morphPresets); });
+        setParameter("morphEnabled", 1.0f);
+
+        for (int i = 0; i <= 100; ++i)
+        {
+            setParameter("morph", static_cast<float>(i % 51) / 50.0f);
+            juce::Thread::sleep(5);
+        }
+
+        setParameter("morphEnabled", 0.0f);
+    }
+
+    void restoreState()
+    {
+        juce::MemoryBlock state;
+        juce::StringArray morphPresets;
+
+        runOnMessageThread([this, &state, &morphPresets]
+        {
+            processor->getStateInformation(state);
+            morphPresets = processor->getPresetManager().getMorphPresets();
+        });
+
+        for (int i = 0; i < 10; ++i)
+        {
+            randomiseContinuousParameters();
+            juce::Thread::sleep(20);
+            runOnMessageThread([this, &state] { processor->setStateInformation(state.getData(), static_cast<int>(state.getSize())); });
+            juce::Thread::sleep(20);
+        }
+
+        // The morph presets and slots are part of the session, not only the parameters
+        runOnMessageThread([this, &morphPresets]
+        {
+            expect(processor->getPresetManager().getMorphPresets() == morphPresets, "morph presets were not restored");
+        });
+    }
+
+    void openEditorWithProfiler()
+    {
+        std::unique_ptr<juce::AudioProcessorEditor> editor;
+
+        runOnMessageThread([this, &editor]
+        {
+            editor.reset(processor->createEditorIfNeeded());
+            processor->getStageProfiler().setEnabled(true);
+        });
+
+        // JUCE's editor attachments post a message for every change made off the message
+        // thread, so here the parameters change from the test thread, as from a host's own UI
+        const juce::ScopedValueSetter<SimulatedAudioThread*> offAudioThread(automationThread, nullptr);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            randomiseContinuousParameters();
+            juce::Thread::sleep(50);
+        }
+
+        runOnMessageThread([this, &editor]
+        {
+            processor->getStageProfiler().setEnabled(false);
+            editor.reset();
+        });
+    }
+
+    void alternateSilence(SimulatedAudioThread& audioThread)
+    {
+        setParameter("cabinetEnabled", 1.0f);
+        setParameter("limiterEnabled", 1.0f);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            // Long enough for every tail to decay and the chain to be skipped
+            audioThread.setSilent(true);
+            juce::Thread::sleep(1500);
+
+            audioThread.setSilent(false);
+            juce::Thread::sleep(200);
+        }
+    }
+
+    std::unique_ptr<SpiceAudioProcessor> processor;
+    SimulatedAudioThread* automationThread = nullptr;
+    juce::StringArray presetNames;
+    juce::Random random { 1234 };
+};
+
+static RealtimeSafetyTests realtimeSafetyTests;
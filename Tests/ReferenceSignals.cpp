@@ -0,0 +1,103 @@
+#include "ReferenceSignals.h"
+#include <cmath>
+#include <iterator>
+
+namespace golden
+{
+    namespace
+    {
+        constexpr int numChannels = 2;
+
+        juce::AudioBuffer<float> createImpulse()
+        {
+            juce::AudioBuffer<float> audio(numChannels, 2048);
+            audio.clear();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                audio.setSample(channel, 0, 0.5f);
+
+            return audio;
+        }
+
+        juce::AudioBuffer<float> createSweep(double sampleRate)
+        {
+            // Exponential sweep over the audible range at -6 dBFS
+            constexpr int length = 8192;
+            constexpr double startHz = 20.0;
+            const auto endHz = juce::jmin(20000.0, sampleRate * 0.45);
+            const auto duration = length / sampleRate;
+            const auto rate = std::log(endHz / startHz);
+
+            juce::AudioBuffer<float> audio(numChannels, length);
+
+            for (int i = 0; i < length; ++i)
+            {
+                const auto t = i / sampleRate;
+                const auto phase = juce::MathConstants<double>::twoPi * startHz * duration / rate
+                                   * (std::exp(t / duration * rate) - 1.0);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    audio.setSample(channel, i, static_cast<float>(0.5 * std::sin(phase)));
+            }
+
+            return audio;
+        }
+
+        juce::AudioBuffer<float> createNoise()
+        {
+            // Independent channels, so stereo stages see a real side signal
+            juce::AudioBuffer<float> audio(numChannels, 4096);
+            juce::Random random(0x5eed);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < audio.getNumSamples(); ++i)
+                    audio.setSample(channel, i, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+
+            return audio;
+        }
+
+        juce::AudioBuffer<float> createChord(double sampleRate)
+        {
+            // Stands in for a music excerpt: a strummed A major chord of plucked notes with
+            // decaying harmonics, panned slightly apart
+            constexpr int length = 8192;
+            constexpr double noteHz[] = { 110.0, 164.81, 220.0, 277.18 };
+            constexpr int numHarmonics = 8;
+
+            juce::AudioBuffer<float> audio(numChannels, length);
+            audio.clear();
+
+            for (int note = 0; note < static_cast<int>(std::size(noteHz)); ++note)
+            {
+                const auto onset = note * 600;
+                const auto pan = 0.35 + 0.1 * note;
+
+                for (int i = onset; i < length; ++i)
+                {
+                    const auto t = (i - onset) / sampleRate;
+                    double sample = 0.0;
+
+                    for (int harmonic = 1; harmonic <= numHarmonics; ++harmonic)
+                        sample += std::sin(juce::MathConstants<double>::twoPi * noteHz[note] * harmonic * t)
+                                  * std::exp(-t * 3.0 * harmonic) / harmonic;
+
+                    sample *= 0.15;
+                    audio.addSample(0, i, static_cast<float>(sample * (1.0 - pan)));
+                    audio.addSample(1, i, static_cast<float>(sample * pan));
+                }
+            }
+
+            return audio;
+        }
+    }
+
+    std::vector<ReferenceSignal> createReferenceSignals(double sampleRate)
+    {
+        std::vector<ReferenceSignal> signals;
+        signals.push_back({ "impulse", createImpulse() });
+        signals.push_back({ "sweep", createSweep(sampleRate) });
+        signals.push_back({ "noise", createNoise() });
+        signals.push_back({ "chord", createChord(sampleRate) });
+        return signals;
+    }
+}
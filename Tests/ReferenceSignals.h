@@ -0,0 +1,20 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+/// Deterministic test signals for the golden-output tests. Every signal is stereo and
+/// generated from fixed seeds, so a golden file recorded on one machine describes the
+/// same input everywhere.
+namespace golden
+{
+    struct ReferenceSignal
+    {
+        const char* name;
+        juce::AudioBuffer<float> audio;
+    };
+
+    /// Impulse, logarithmic sine sweep, white noise and a synthesised chord excerpt, in
+    /// the order they appear in a golden file
+    std::vector<ReferenceSignal> createReferenceSignals(double sampleRate);
+}
@@ -0,0 +1,43 @@
+#include <JuceHeader.h>
+#include "RealtimeChecker.h"
+
+namespace
+{
+    /// Runs the registered unit tests away from the message thread, which the processor,
+    /// its preset library and the editor need to be serviced while the tests wait.
+    class TestThread : public juce::Thread
+    {
+    public:
+        TestThread() : juce::Thread("Unit tests") {}
+
+        void run() override
+        {
+            juce::UnitTestRunner runner;
+            runner.setAssertOnFailure(false);
+            runner.runAllTests();
+
+            for (int i = 0; i < runner.getNumResults(); ++i)
+                numFailures += runner.getResult(i)->failures;
+
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+        }
+
+        int numFailures = 0;
+    };
+}
+
+int main()
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    if (! realtime::isCheckingSupported())
+        std::cout << "Real-time checks are not supported on this platform; only the scenarios run" << std::endl;
+
+    TestThread testThread;
+    testThread.startThread();
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    testThread.stopThread(-1);
+
+    std::cout << (testThread.numFailures == 0 ? "All tests passed" : juce::String(testThread.numFailures) + " failures") << std::endl;
+    return testThread.numFailures == 0 ? 0 : 1;
+}
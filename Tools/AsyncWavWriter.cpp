@@ -0,0 +1,309 @@
+#include "AsyncWavWriter.h"
+
+namespace offline
+{
+    namespace
+    {
+        constexpr juce::int64 ds64ChunkSize = 28;
+        constexpr juce::int64 maxRiffSize = 0xffffffff;
+        constexpr juce::uint8 subformatGuidTail[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
+                                                        0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 };
+
+        juce::uint32 getChannelMask(int numChannels)
+        {
+            // Speaker positions in WAVE_FORMAT_EXTENSIBLE order; past 18 there are none
+            return numChannels <= 18 ? (1u << numChannels) - 1 : 0;
+        }
+    }
+
+    //==============================================================================
+    class AsyncWavWriter::WriterThread : public juce::Thread
+    {
+    public:
+        explicit WriterThread(juce::OutputStream& streamToUse)
+            : juce::Thread("WAV writer"),
+              output(streamToUse)
+        {
+            idle.signal();
+        }
+
+        ~WriterThread() override
+        {
+            signalThreadShouldExit();
+            work.signal();
+            stopThread(-1);
+        }
+
+        /// Hand a buffer to the thread, waiting for the previous one to be written first
+        void submit(const juce::uint8* data, size_t size)
+        {
+            idle.wait(-1);
+            idle.reset();
+
+            pendingData = data;
+            pendingSize = size;
+            work.signal();
+        }
+
+        void waitUntilIdle() { idle.wait(-1); }
+        bool hasFailed() const { return failed.load(); }
+
+        void run() override
+        {
+            for (;;)
+            {
+                work.wait(-1);
+
+                if (pendingSize > 0)
+                {
+                    if (! output.write(pendingData, pendingSize))
+                        failed.store(true);
+
+                    pendingSize = 0;
+                }
+
+                idle.signal();
+
+                if (threadShouldExit())
+                    return;
+            }
+        }
+
+    private:
+        juce::OutputStream& output;
+        juce::WaitableEvent work;
+        juce::WaitableEvent idle { true };
+
+        // Handed over through the events
+        const juce::uint8* pendingData = nullptr;
+        size_t pendingSize = 0;
+
+        std::atomic<bool> failed { false };
+    };
+
+    //==============================================================================
+    AsyncWavWriter::AsyncWavWriter(const juce::File& file, double rate, int channels, SampleFormat sampleFormat,
+                                   int framesPerBuffer)
+        : sampleRate(rate),
+          numChannels(channels),
+          format(sampleFormat),
+          bytesPerFrame(channels * getBytesPerSample(sampleFormat)),
+          bufferFrames(juce::jmax(1, framesPerBuffer))
+    {
+        if (numChannels < 1 || numChannels > 0xffff)
+        {
+            error = "Unsupported channel count " + juce::String(numChannels);
+            return;
+        }
+
+        if (file.exists() && ! file.deleteFile())
+        {
+            error = "Could not replace " + file.getFullPathName();
+            return;
+        }
+
+        stream = std::make_unique<juce::FileOutputStream>(file);
+
+        if (stream->failedToOpen())
+        {
+            error = "Could not create " + file.getFullPathName() + ": " + stream->getStatus().getErrorMessage();
+            stream.reset();
+            return;
+        }
+
+        interleaved.resize(static_cast<size_t>(bufferFrames * numChannels));
+
+        for (auto& buffer : buffers)
+            buffer.resize(static_cast<size_t>(bufferFrames * bytesPerFrame));
+
+        writeHeader();
+
+        writerThread = std::make_unique<WriterThread>(*stream);
+        writerThread->startThread();
+    }
+
+    AsyncWavWriter::~AsyncWavWriter()
+    {
+        if (openedOk() && ! finished)
+            finish();
+    }
+
+    bool AsyncWavWriter::getSampleFormat(int bitsPerSample, bool floatingPoint, SampleFormat& result)
+    {
+        if (floatingPoint)
+        {
+            if (bitsPerSample != 32 && bitsPerSample != 64)
+                return false;
+
+            result = bitsPerSample == 32 ? SampleFormat::float32 : SampleFormat::float64;
+            return true;
+        }
+
+        switch (bitsPerSample)
+        {
+            case 8:  result = SampleFormat::uint8; return true;
+            case 16: result = SampleFormat::int16; return true;
+            case 24: result = SampleFormat::int24; return true;
+            case 32: result = SampleFormat::int32; return true;
+            default: return false;
+        }
+    }
+
+    void AsyncWavWriter::writeHeader()
+    {
+        const auto bitsPerSample = getBytesPerSample(format) * 8;
+        const auto isFloat = format == SampleFormat::float32 || format == SampleFormat::float64;
+        const auto formatTag = isFloat ? 3 : 1;
+        const auto extensible = numChannels > 2 || bitsPerSample > 16;
+
+        stream->write("RIFF", 4);
+        stream->writeInt(0);                 // Patched by finish()
+        stream->write("WAVE", 4);
+
+        // Placeholder that finish() turns into the ds64 chunk if the file outgrows RIFF
+        stream->write("JUNK", 4);
+        stream->writeInt(static_cast<int>(ds64ChunkSize));
+        stream->writeRepeatedByte(0, static_cast<size_t>(ds64ChunkSize));
+
+        stream->write("fmt ", 4);
+        stream->writeInt(extensible ? 40 : 16);
+        stream->writeShort(static_cast<short>(extensible ? 0xfffe : formatTag));
+        stream->writeShort(static_cast<short>(numChannels));
+        stream->writeInt(static_cast<int>(sampleRate));
+        stream->writeInt(static_cast<int>(sampleRate) * bytesPerFrame);
+        stream->writeShort(static_cast<short>(bytesPerFrame));
+        stream->writeShort(static_cast<short>(bitsPerSample));
+
+        if (extensible)
+        {
+            stream->writeShort(22);
+            stream->writeShort(static_cast<short>(bitsPerSample));
+            stream->writeInt(static_cast<int>(getChannelMask(numChannels)));
+            stream->writeShort(static_cast<short>(formatTag));
+            stream->write(subformatGuidTail, sizeof(subformatGuidTail));
+        }
+
+        stream->write("data", 4);
+        stream->writeInt(0);                 // Patched by finish()
+
+        headerSize = stream->getPosition();
+    }
+
+    bool AsyncWavWriter::write(const juce::AudioBuffer<float>& source, int startSample, int numSamples)
+    {
+        jassert(openedOk() && ! finished && source.getNumChannels() >= numChannels);
+
+        for (int done = 0; done < numSamples;)
+        {
+            const auto count = juce::jmin(numSamples - done, bufferFrames - framesInFillBuffer);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const auto* input = source.getReadPointer(channel, startSample + done);
+                auto* output = interleaved.data() + channel;
+
+                for (int i = 0; i < count; ++i)
+                    output[i * numChannels] = input[i];
+            }
+
+            convertFromFloat(format, interleaved.data(),
+                             buffers[fillIndex].data() + static_cast<size_t>(framesInFillBuffer * bytesPerFrame),
+                             static_cast<size_t>(count * numChannels));
+
+            framesInFillBuffer += count;
+            done += count;
+
+            if (framesInFillBuffer == bufferFrames)
+                submitFillBuffer();
+        }
+
+        return ! writerThread->hasFailed();
+    }
+
+    void AsyncWavWriter::submitFillBuffer()
+    {
+        if (framesInFillBuffer == 0)
+            return;
+
+        // Blocks only while the other buffer is still on its way to disk
+        writerThread->submit(buffers[fillIndex].data(), static_cast<size_t>(framesInFillBuffer * bytesPerFrame));
+
+        numFramesWritten += framesInFillBuffer;
+        framesInFillBuffer = 0;
+        fillIndex ^= 1;
+    }
+
+    juce::Result AsyncWavWriter::finish()
+    {
+        if (! openedOk())
+            return juce::Result::fail(error);
+
+        if (finished)
+            return juce::Result::ok();
+
+        finished = true;
+
+        submitFillBuffer();
+        writerThread->waitUntilIdle();
+
+        const auto failed = writerThread->hasFailed();
+        writerThread.reset();
+
+        if (failed || ! patchHeader())
+        {
+            error = "Write error: " + stream->getStatus().getErrorMessage();
+            stream.reset();
+            return juce::Result::fail(error);
+        }
+
+        stream.reset();
+        return juce::Result::ok();
+    }
+
+    bool AsyncWavWriter::patchHeader()
+    {
+        const auto dataBytes = numFramesWritten * bytesPerFrame;
+
+        // Chunks are word aligned
+        if ((dataBytes & 1) != 0)
+            stream->writeByte(0);
+
+        const auto riffSize = stream->getPosition() - 8;
+
+        if (riffSize <= maxRiffSize)
+        {
+            if (! stream->setPosition(4))
+                return false;
+
+            stream->writeInt(static_cast<int>(static_cast<juce::uint32>(riffSize)));
+
+            if (! stream->setPosition(headerSize - 4))
+                return false;
+
+            stream->writeInt(static_cast<int>(static_cast<juce::uint32>(dataBytes)));
+        }
+        else
+        {
+            if (! stream->setPosition(0))
+                return false;
+
+            stream->write("RF64", 4);
+            stream->writeInt(-1);
+            stream->write("WAVE", 4);
+            stream->write("ds64", 4);
+            stream->writeInt(static_cast<int>(ds64ChunkSize));
+            stream->writeInt64(riffSize);
+            stream->writeInt64(dataBytes);
+            stream->writeInt64(numFramesWritten);
+            stream->writeInt(0);             // No table entries
+
+            if (! stream->setPosition(headerSize - 4))
+                return false;
+
+            stream->writeInt(-1);
+        }
+
+        stream->flush();
+        return stream->getStatus().wasOk();
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "SampleConversion.h"
+
+namespace offline
+{
+    /// Writes a WAV file from a background thread, so disk I/O overlaps the processing.
+    ///
+    /// Two buffers alternate: the caller converts audio into one while the writer thread
+    /// writes the other to disk, and only waits if the disk has fallen a whole buffer
+    /// behind. The header reserves room for an RF64 ds64 chunk, so files that pass 4 GB are
+    /// turned into RF64 when finished and smaller ones stay plain RIFF WAV.
+    class AsyncWavWriter
+    {
+    public:
+        AsyncWavWriter(const juce::File& file, double sampleRate, int numChannels, SampleFormat format,
+                       int bufferFrames = 65536);
+
+        /// Finishes the file if finish() has not been called
+        ~AsyncWavWriter();
+
+        /// Empty if the file was created
+        const juce::String& getError() const { return error; }
+        bool openedOk() const { return error.isEmpty(); }
+
+        /// Append frames from the source's first channels. Returns false once an I/O error
+        /// has happened.
+        bool write(const juce::AudioBuffer<float>& source, int startSample, int numSamples);
+
+        /// Write what is left, complete the header and close the file
+        juce::Result finish();
+
+        juce::int64 getNumFramesWritten() const { return numFramesWritten; }
+
+        /// WAV format for the given bit depth and encoding, or false if WAV has none
+        static bool getSampleFormat(int bitsPerSample, bool floatingPoint, SampleFormat& format);
+
+    private:
+        class WriterThread;
+
+        void writeHeader();
+        void submitFillBuffer();
+        bool patchHeader();
+
+        std::unique_ptr<juce::FileOutputStream> stream;
+        std::unique_ptr<WriterThread> writerThread;
+        juce::String error;
+
+        const double sampleRate;
+        const int numChannels;
+        const SampleFormat format;
+        const int bytesPerFrame;
+        const int bufferFrames;
+
+        // Interleaved floats for one buffer's worth, then the two encoded buffers
+        std::vector<float> interleaved;
+        std::vector<juce::uint8> buffers[2];
+        int fillIndex = 0;
+        int framesInFillBuffer = 0;
+
+        juce::int64 numFramesWritten = 0;
+        juce::int64 headerSize = 0;
+        bool finished = false;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AsyncWavWriter)
+    };
+}
@@ -0,0 +1,163 @@
+#include "FileRenderer.h"
+#include <array>
+#include "AsyncWavWriter.h"
+#include "MappedWavReader.h"
+
+namespace render
+{
+    FileRenderer::FileRenderer(const SpiceParameters& parametersToUse, int engineBlockSize, int chunkSize)
+        : parameters(parametersToUse),
+          blockSize(juce::jmax(1, engineBlockSize)),
+          // Whole engine blocks per chunk, so only the last block of a file is short
+          chunkSamples(juce::jmax(1, chunkSize / blockSize) * blockSize)
+    {
+        formatManager.registerBasicFormats();
+    }
+
+    juce::Result FileRenderer::render(const juce::File& input, const juce::File& output)
+    {
+        if (output.getParentDirectory().createDirectory().failed())
+            return juce::Result::fail("Could not create " + output.getParentDirectory().getFullPathName());
+
+        bool handled = false;
+        auto result = renderWav(input, output, handled);
+
+        if (! handled)
+            result = renderWithAudioFormats(input, output);
+
+        if (result.failed())
+            output.deleteFile();
+
+        return result;
+    }
+
+    juce::Result FileRenderer::renderWav(const juce::File& input, const juce::File& output, bool& handled)
+    {
+        if (! input.hasFileExtension("wav;wave"))
+            return juce::Result::ok();
+
+        offline::MappedWavReader reader(input);
+
+        // Encodings the mapped reader does not handle still get JUCE's reader
+        if (! reader.openedOk())
+            return juce::Result::ok();
+
+        handled = true;
+        const auto numChannels = reader.getNumChannels();
+
+        if (numChannels > SpiceEngine<float>::maxChannels)
+            return juce::Result::fail("Unsupported channel count " + juce::String(numChannels));
+
+        offline::AsyncWavWriter writer(output, reader.getSampleRate(), numChannels, reader.getSampleFormat(), chunkSamples);
+
+        if (! writer.openedOk())
+            return juce::Result::fail(writer.getError());
+
+        auto result = renderStream(reader.getSampleRate(), numChannels, reader.getLengthInSamples(),
+                                   [&reader](juce::AudioBuffer<float>& chunk, juce::int64 position, int numSamples)
+                                   {
+                                       reader.setPosition(position);
+                                       reader.readNext(chunk, numSamples);
+                                       return true;
+                                   },
+                                   [&writer](const juce::AudioBuffer<float>& chunk, int startSample, int numSamples)
+                                   {
+                                       return writer.write(chunk, startSample, numSamples);
+                                   });
+
+        const auto finished = writer.finish();
+        return result.failed() ? result : finished;
+    }
+
+    juce::Result FileRenderer::renderWithAudioFormats(const juce::File& input, const juce::File& output)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+
+        if (reader == nullptr)
+            return juce::Result::fail("Unsupported or unreadable audio file");
+
+        const auto numChannels = static_cast<int>(reader->numChannels);
+
+        if (numChannels < 1 || numChannels > SpiceEngine<float>::maxChannels)
+            return juce::Result::fail("Unsupported channel count " + juce::String(numChannels));
+
+        // Same format as the input, chosen by the input's extension
+        auto* format = formatManager.findFormatForFileExtension(input.getFileExtension());
+
+        if (format == nullptr)
+            return juce::Result::fail("No writer for " + input.getFileExtension() + " files");
+
+        if (output.exists() && ! output.deleteFile())
+            return juce::Result::fail("Could not replace " + output.getFullPathName());
+
+        auto stream = output.createOutputStream();
+
+        if (stream == nullptr)
+            return juce::Result::fail("Could not create " + output.getFullPathName());
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), reader->sampleRate,
+                                                                                static_cast<unsigned int>(numChannels),
+                                                                                static_cast<int>(reader->bitsPerSample),
+                                                                                reader->metadataValues, 0));
+
+        if (writer == nullptr)
+            return juce::Result::fail(format->getFormatName() + " cannot store " + juce::String(reader->bitsPerSample)
+                                      + " bit audio at " + juce::String(reader->sampleRate) + " Hz");
+
+        // The writer owns the stream from here on
+        stream.release();
+
+        return renderStream(reader->sampleRate, numChannels, reader->lengthInSamples,
+                            [&reader](juce::AudioBuffer<float>& chunk, juce::int64 position, int numSamples)
+                            {
+                                return reader->read(&chunk, 0, numSamples, position, true, true);
+                            },
+                            [&writer](const juce::AudioBuffer<float>& chunk, int startSample, int numSamples)
+                            {
+                                return writer->writeFromAudioSampleBuffer(chunk, startSample, numSamples);
+                            });
+    }
+
+    juce::Result FileRenderer::renderStream(double sampleRate, int numChannels, juce::int64 lengthInSamples,
+                                            const ReadFunction& read, const WriteFunction& write)
+    {
+        const juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize),
+                                            static_cast<juce::uint32>(numChannels) };
+
+        // Prepared for every file, so no state carries over and results do not depend on
+        // which worker or file order rendered them
+        engine.prepare(spec, juce::AudioChannelSet::canonicalChannelSet(numChannels), parameters);
+        chunk.setSize(numChannels, chunkSamples, false, false, true);
+
+        const auto latency = static_cast<juce::int64>(engine.getLatencySamples());
+        const auto totalToProcess = lengthInSamples + latency;
+        std::array<float*, SpiceEngine<float>::maxChannels> channels {};
+
+        for (juce::int64 position = 0; position < totalToProcess; position += chunkSamples)
+        {
+            const auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(chunkSamples), totalToProcess - position));
+
+            // Reads past the end of the file return silence, which flushes the lookahead
+            if (! read(chunk, position, numSamples))
+                return juce::Result::fail("Read error at sample " + juce::String(position));
+
+            for (int offset = 0; offset < numSamples; offset += blockSize)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    channels[static_cast<size_t>(channel)] = chunk.getWritePointer(channel, offset);
+
+                juce::AudioBuffer<float> block(channels.data(), numChannels, juce::jmin(blockSize, numSamples - offset));
+                engine.processBlock(block, parameters);
+            }
+
+            // Drop the first latency samples so the output lines up with the input
+            const auto skip = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples), latency - position));
+
+            if (skip < numSamples && ! write(chunk, skip, numSamples - skip))
+                return juce::Result::fail("Write error at sample " + juce::String(position));
+        }
+
+        secondsRendered += static_cast<double>(lengthInSamples) / sampleRate;
+        return juce::Result::ok();
+    }
+}
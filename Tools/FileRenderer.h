@@ -0,0 +1,50 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include "DSP/SpiceEngine.h"
+
+namespace render
+{
+    /// Renders audio files through one SpiceEngine, one file at a time.
+    ///
+    /// Files are streamed: a fixed-size chunk is read, processed in engine-sized blocks and
+    /// written before the next chunk is read, so memory use does not depend on file length.
+    /// WAV and RF64 files go through the memory-mapped reader and the asynchronous writer,
+    /// other formats through JUCE's readers and writers.
+    /// The output has the input's format, sample rate, bit depth, channel count and length;
+    /// the engine's lookahead latency is compensated by flushing it with silence at the end.
+    /// Each worker thread owns its own renderer.
+    class FileRenderer
+    {
+    public:
+        FileRenderer(const SpiceParameters& parametersToUse, int engineBlockSize, int chunkSize);
+
+        /// Process one file, replacing the output file
+        juce::Result render(const juce::File& input, const juce::File& output);
+
+        /// Audio rendered so far by this renderer, in seconds
+        double getSecondsRendered() const { return secondsRendered; }
+
+    private:
+        /// Fill the chunk with frames from the given position; frames past the end are silence
+        using ReadFunction = std::function<bool(juce::AudioBuffer<float>& chunk, juce::int64 position, int numSamples)>;
+        using WriteFunction = std::function<bool(const juce::AudioBuffer<float>& chunk, int startSample, int numSamples)>;
+
+        juce::Result renderWav(const juce::File& input, const juce::File& output, bool& handled);
+        juce::Result renderWithAudioFormats(const juce::File& input, const juce::File& output);
+        juce::Result renderStream(double sampleRate, int numChannels, juce::int64 lengthInSamples,
+                                  const ReadFunction& read, const WriteFunction& write);
+
+        const SpiceParameters parameters;
+        const int blockSize;
+        const int chunkSamples;
+
+        juce::AudioFormatManager formatManager;
+        SpiceEngine<float> engine;
+        juce::AudioBuffer<float> chunk;
+        double secondsRendered = 0.0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileRenderer)
+    };
+}
@@ -0,0 +1,221 @@
+#include "MappedWavReader.h"
+#include <cstring>
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD || JUCE_ANDROID
+ #include <sys/mman.h>
+ #include <unistd.h>
+ #define SPICE_HAS_MADVISE 1
+#else
+ #define SPICE_HAS_MADVISE 0
+#endif
+
+namespace offline
+{
+    namespace
+    {
+        // Frames converted per run, small enough for the interleaved floats to stay in L1
+        constexpr int conversionFrames = 1024;
+
+        constexpr juce::uint16 pcmFormatTag = 1;
+        constexpr juce::uint16 floatFormatTag = 3;
+        constexpr juce::uint16 extensibleFormatTag = 0xfffe;
+
+        bool hasID(const juce::uint8* data, const char* id)
+        {
+            return std::memcmp(data, id, 4) == 0;
+        }
+
+       #if SPICE_HAS_MADVISE
+        void advise(const juce::uint8* base, juce::int64 start, juce::int64 end, int advice)
+        {
+            static const auto pageSize = static_cast<juce::int64>(sysconf(_SC_PAGESIZE));
+
+            // madvise wants page-aligned addresses; the mapping itself starts on a page
+            const auto alignedStart = start - start % pageSize;
+
+            if (end > alignedStart)
+                madvise(const_cast<juce::uint8*>(base + alignedStart), static_cast<size_t>(end - alignedStart), advice);
+        }
+       #endif
+    }
+
+    MappedWavReader::MappedWavReader(const juce::File& file)
+        : mapping(std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly, false))
+    {
+        if (mapping->getData() == nullptr)
+        {
+            error = "Could not map " + file.getFullPathName();
+            return;
+        }
+
+        if (! parseHeader())
+            return;
+
+        readAheadFrames = static_cast<int>(sampleRate);
+        interleaved.resize(static_cast<size_t>(conversionFrames * numChannels));
+
+       #if SPICE_HAS_MADVISE
+        advise(static_cast<const juce::uint8*>(mapping->getData()), 0, static_cast<juce::int64>(mapping->getSize()), MADV_SEQUENTIAL);
+       #endif
+    }
+
+    MappedWavReader::~MappedWavReader() = default;
+
+    bool MappedWavReader::parseHeader()
+    {
+        const auto* data = static_cast<const juce::uint8*>(mapping->getData());
+        const auto size = static_cast<juce::int64>(mapping->getSize());
+
+        if (size < 12 || ! (hasID(data, "RIFF") || hasID(data, "RF64") || hasID(data, "BW64")) || ! hasID(data + 8, "WAVE"))
+        {
+            error = "Not a WAV file";
+            return false;
+        }
+
+        juce::int64 ds64DataSize = -1;
+        juce::uint16 formatTag = 0;
+        int blockAlign = 0;
+        juce::int64 dataSize = -1;
+
+        for (juce::int64 offset = 12; offset + 8 <= size;)
+        {
+            const auto* chunk = data + offset;
+            const auto chunkSize = static_cast<juce::int64>(juce::ByteOrder::littleEndianInt(chunk + 4));
+
+            if (hasID(chunk, "ds64") && offset + 8 + 24 <= size)
+            {
+                // RF64: the 32-bit sizes are 0xffffffff and the real ones live here
+                ds64DataSize = static_cast<juce::int64>(juce::ByteOrder::littleEndianInt64(chunk + 16));
+            }
+            else if (hasID(chunk, "fmt ") && chunkSize >= 16 && offset + 8 + 16 <= size)
+            {
+                formatTag = juce::ByteOrder::littleEndianShort(chunk + 8);
+                numChannels = juce::ByteOrder::littleEndianShort(chunk + 10);
+                sampleRate = juce::ByteOrder::littleEndianInt(chunk + 12);
+                blockAlign = juce::ByteOrder::littleEndianShort(chunk + 20);
+                bitsPerSample = juce::ByteOrder::littleEndianShort(chunk + 22);
+
+                // WAVE_FORMAT_EXTENSIBLE keeps the real format tag in the subformat GUID
+                if (formatTag == extensibleFormatTag && chunkSize >= 40 && offset + 8 + 40 <= size)
+                    formatTag = juce::ByteOrder::littleEndianShort(chunk + 32);
+            }
+            else if (hasID(chunk, "data"))
+            {
+                dataOffset = offset + 8;
+                dataSize = (chunkSize == 0xffffffff && ds64DataSize >= 0) ? ds64DataSize : chunkSize;
+                break;
+            }
+
+            offset += 8 + chunkSize + (chunkSize & 1);
+        }
+
+        if (formatTag == 0 || dataSize < 0)
+        {
+            error = "WAV file without a format or data chunk";
+            return false;
+        }
+
+        if (formatTag == pcmFormatTag && bitsPerSample == 8)        format = SampleFormat::uint8;
+        else if (formatTag == pcmFormatTag && bitsPerSample == 16)  format = SampleFormat::int16;
+        else if (formatTag == pcmFormatTag && bitsPerSample == 24)  format = SampleFormat::int24;
+        else if (formatTag == pcmFormatTag && bitsPerSample == 32)  format = SampleFormat::int32;
+        else if (formatTag == floatFormatTag && bitsPerSample == 32) format = SampleFormat::float32;
+        else if (formatTag == floatFormatTag && bitsPerSample == 64) format = SampleFormat::float64;
+        else
+        {
+            error = "Unsupported WAV encoding (format " + juce::String(formatTag) + ", " + juce::String(bitsPerSample) + " bits)";
+            return false;
+        }
+
+        bytesPerFrame = numChannels * getBytesPerSample(format);
+
+        // Padded containers such as 24 bits in 32 are rare enough to leave to JUCE's reader
+        if (numChannels < 1 || blockAlign != bytesPerFrame || sampleRate <= 0.0)
+        {
+            error = "Unsupported WAV frame layout";
+            return false;
+        }
+
+        // A truncated recording still plays up to its last complete frame
+        lengthInSamples = juce::jmin(dataSize, size - dataOffset) / bytesPerFrame;
+        return true;
+    }
+
+    const juce::uint8* MappedWavReader::getFrame(juce::int64 frame) const
+    {
+        return static_cast<const juce::uint8*>(mapping->getData()) + dataOffset + frame * bytesPerFrame;
+    }
+
+    void MappedWavReader::read(juce::AudioBuffer<float>& destination, int destinationStart, juce::int64 startFrame, int numFrames)
+    {
+        jassert(openedOk() && destination.getNumChannels() >= numChannels);
+        jassert(destinationStart + numFrames <= destination.getNumSamples());
+
+        const auto available = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numFrames),
+                                                             lengthInSamples - startFrame));
+
+        for (int done = 0; done < available;)
+        {
+            const auto count = juce::jmin(conversionFrames, available - done);
+            convertToFloat(format, getFrame(startFrame + done), interleaved.data(), static_cast<size_t>(count * numChannels));
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* output = destination.getWritePointer(channel, destinationStart + done);
+                const auto* input = interleaved.data() + channel;
+
+                for (int i = 0; i < count; ++i)
+                    output[i] = input[i * numChannels];
+            }
+
+            done += count;
+        }
+
+        if (available < numFrames)
+            for (int channel = 0; channel < numChannels; ++channel)
+                destination.clear(channel, destinationStart + available, numFrames - available);
+    }
+
+    int MappedWavReader::readNext(juce::AudioBuffer<float>& destination, int numFrames)
+    {
+        adviseReadAhead(position + numFrames);
+        read(destination, 0, position, numFrames);
+
+        const auto numRead = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numFrames),
+                                                           lengthInSamples - position));
+        position += numFrames;
+        return numRead;
+    }
+
+    void MappedWavReader::adviseReadAhead(juce::int64 endFrame)
+    {
+       #if SPICE_HAS_MADVISE
+        const auto* base = static_cast<const juce::uint8*>(mapping->getData());
+        const auto mappedSize = static_cast<juce::int64>(mapping->getSize());
+        const auto windowBytes = static_cast<juce::int64>(readAheadFrames) * bytesPerFrame;
+
+        // Ask for the next window once reads get within one window of the advised end,
+        // so there is one call per window rather than one per block
+        const auto neededUpTo = juce::jmin(dataOffset + (endFrame + readAheadFrames) * bytesPerFrame, mappedSize);
+
+        if (neededUpTo > advisedUpTo)
+        {
+            const auto newEnd = juce::jmin(neededUpTo + windowBytes, mappedSize);
+            advise(base, advisedUpTo, newEnd, MADV_WILLNEED);
+            advisedUpTo = newEnd;
+        }
+
+        // Drop what lies more than a window behind; the pages are clean, so this only
+        // trims the resident size and a later seek back simply faults them in again
+        const auto consumedUpTo = dataOffset + (position - readAheadFrames) * bytesPerFrame;
+
+        if (windowBytes > 0 && consumedUpTo - releasedUpTo >= windowBytes)
+        {
+            advise(base, releasedUpTo, consumedUpTo, MADV_DONTNEED);
+            releasedUpTo = consumedUpTo;
+        }
+       #else
+        juce::ignoreUnused(endFrame);
+       #endif
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <memory>
+#include <vector>
+#include "SampleConversion.h"
+
+namespace offline
+{
+    /// Streams a PCM or float WAV file, including RF64 files over 4 GB, straight out of a
+    /// memory mapping instead of decoding it into an AudioBuffer.
+    ///
+    /// Sequential reads hint the next readAheadFrames to the OS ahead of time and release
+    /// the pages already consumed, so even hour-long files keep a resident footprint of a
+    /// few megabytes. Samples are converted to float in cache-sized runs by
+    /// convertToFloat(), then split into channels.
+    class MappedWavReader
+    {
+    public:
+        explicit MappedWavReader(const juce::File& file);
+        ~MappedWavReader();
+
+        /// Empty if the file was mapped and its format is supported
+        const juce::String& getError() const { return error; }
+        bool openedOk() const { return error.isEmpty(); }
+
+        double getSampleRate() const { return sampleRate; }
+        int getNumChannels() const { return numChannels; }
+        int getBitsPerSample() const { return bitsPerSample; }
+        bool isFloatingPoint() const { return format == SampleFormat::float32 || format == SampleFormat::float64; }
+        SampleFormat getSampleFormat() const { return format; }
+        juce::int64 getLengthInSamples() const { return lengthInSamples; }
+
+        /// Convert frames to float into the destination's first channels. Frames past the
+        /// end of the file are silence; the destination needs at least getNumChannels().
+        void read(juce::AudioBuffer<float>& destination, int destinationStart, juce::int64 startFrame, int numFrames);
+
+        /// Read the next window of frames from the current position, for feeding a processor
+        /// block by block. Returns the number of frames that came from the file.
+        int readNext(juce::AudioBuffer<float>& destination, int numFrames);
+
+        juce::int64 getPosition() const { return position; }
+        void setPosition(juce::int64 newPosition) { position = juce::jmax(static_cast<juce::int64>(0), newPosition); }
+
+        /// How far ahead of sequential reads the OS is asked to page in, default 1 s
+        void setReadAhead(int numFrames) { readAheadFrames = juce::jmax(0, numFrames); }
+
+    private:
+        bool parseHeader();
+        const juce::uint8* getFrame(juce::int64 frame) const;
+        void adviseReadAhead(juce::int64 endFrame);
+
+        std::unique_ptr<juce::MemoryMappedFile> mapping;
+        juce::String error;
+
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        int bitsPerSample = 0;
+        SampleFormat format = SampleFormat::int16;
+        int bytesPerFrame = 0;
+        juce::int64 dataOffset = 0;
+        juce::int64 lengthInSamples = 0;
+
+        juce::int64 position = 0;
+        int readAheadFrames = 0;
+        juce::int64 advisedUpTo = 0;    // Byte offsets into the mapping
+        juce::int64 releasedUpTo = 0;
+
+        std::vector<float> interleaved;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MappedWavReader)
+    };
+}
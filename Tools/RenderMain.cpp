@@ -0,0 +1,168 @@
+#include <JuceHeader.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "FileRenderer.h"
+#include "RenderParameters.h"
+#include "WorkStealingPool.h"
+
+// Applies a preset or saved plugin state to many audio files at once, one file per core.
+// Outputs keep the input's format, sample rate, bit depth, channel count and length.
+//
+// Usage: spice_render --preset <factory preset name | .spice file | state file>
+//                     --output-dir <directory> [--suffix <text>] [--threads <n>]
+//                     [--block-size <samples>] [--chunk-size <samples>]
+//                     <audio files or directories>...
+
+namespace
+{
+    struct Settings
+    {
+        juce::String preset;
+        juce::File outputDirectory;
+        juce::String suffix;
+        int numThreads = juce::SystemStats::getNumCpus();
+        int blockSize = 512;
+        int chunkSize = 65536;
+        juce::Array<juce::File> inputs;
+    };
+
+    const juce::StringArray valueOptions { "--preset", "--output-dir", "--suffix", "--threads", "--block-size", "--chunk-size" };
+
+    Settings parseArguments(const juce::ArgumentList& arguments)
+    {
+        Settings settings;
+        settings.preset = arguments.getValueForOption("--preset");
+        settings.suffix = arguments.getValueForOption("--suffix");
+
+        if (arguments.containsOption("--output-dir"))
+            settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption("--output-dir"));
+
+        if (arguments.containsOption("--threads"))
+            settings.numThreads = juce::jmax(1, arguments.getValueForOption("--threads").getIntValue());
+
+        if (arguments.containsOption("--block-size"))
+            settings.blockSize = juce::jlimit(16, 8192, arguments.getValueForOption("--block-size").getIntValue());
+
+        if (arguments.containsOption("--chunk-size"))
+            settings.chunkSize = juce::jmax(settings.blockSize, arguments.getValueForOption("--chunk-size").getIntValue());
+
+        // Everything that is neither an option nor an option's value is an input
+        for (int i = 0; i < arguments.size(); ++i)
+        {
+            const auto& argument = arguments[i];
+
+            if (argument.isLongOption())
+            {
+                if (valueOptions.contains(argument.text) && ! argument.text.containsChar('='))
+                    ++i;
+
+                continue;
+            }
+
+            settings.inputs.add(argument.resolveAsFile());
+        }
+
+        return settings;
+    }
+
+    /// The input files, with directories expanded to the audio files directly inside
+    /// them, longest first so the pool finishes with short files
+    juce::Array<juce::File> collectInputFiles(const juce::Array<juce::File>& inputs)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        const auto wildcard = formatManager.getWildcardForAllFormats();
+
+        juce::Array<juce::File> files;
+
+        for (const auto& input : inputs)
+        {
+            if (input.isDirectory())
+                files.addArray(input.findChildFiles(juce::File::findFiles, false, wildcard));
+            else
+                files.addIfNotAlreadyThere(input);
+        }
+
+        std::stable_sort(files.begin(), files.end(),
+                         [](const juce::File& a, const juce::File& b) { return a.getSize() > b.getSize(); });
+        return files;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const auto settings = parseArguments(juce::ArgumentList(argc, argv));
+
+    if (settings.preset.isEmpty() || settings.outputDirectory == juce::File() || settings.inputs.isEmpty())
+    {
+        std::cerr << "Usage: spice_render --preset <name or file> --output-dir <directory> [--suffix <text>]\n"
+                     "                    [--threads <n>] [--block-size <samples>] [--chunk-size <samples>]\n"
+                     "                    <audio files or directories>..." << std::endl;
+        return 1;
+    }
+
+    SpiceParameters parameters;
+    const auto loaded = render::loadParameters(settings.preset, parameters);
+
+    if (loaded.failed())
+    {
+        std::cerr << loaded.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    const auto files = collectInputFiles(settings.inputs);
+
+    if (files.isEmpty())
+    {
+        std::cerr << "No audio files to render" << std::endl;
+        return 1;
+    }
+
+    render::WorkStealingPool pool(juce::jmin(settings.numThreads, files.size()));
+
+    std::vector<std::unique_ptr<render::FileRenderer>> renderers;
+
+    for (int i = 0; i < pool.getNumWorkers(); ++i)
+        renderers.push_back(std::make_unique<render::FileRenderer>(parameters, settings.blockSize, settings.chunkSize));
+
+    // One entry per file, each written only by the worker that renders it
+    std::vector<juce::Result> results(static_cast<size_t>(files.size()), juce::Result::ok());
+    juce::CriticalSection outputLock;
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    pool.run(files.size(), [&](int taskIndex, int workerIndex)
+    {
+        const auto& input = files.getReference(taskIndex);
+        const auto output = settings.outputDirectory.getChildFile(input.getFileNameWithoutExtension() + settings.suffix
+                                                                  + input.getFileExtension());
+
+        auto& result = results[static_cast<size_t>(taskIndex)];
+        result = output == input ? juce::Result::fail("Output would overwrite the input")
+                                 : renderers[static_cast<size_t>(workerIndex)]->render(input, output);
+
+        const juce::ScopedLock sl(outputLock);
+
+        if (result.wasOk())
+            std::cout << "Rendered " << output.getFullPathName() << std::endl;
+        else
+            std::cerr << "Failed " << input.getFullPathName() << ": " << result.getErrorMessage() << std::endl;
+    });
+
+    const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    double secondsRendered = 0.0;
+
+    for (const auto& renderer : renderers)
+        secondsRendered += renderer->getSecondsRendered();
+
+    const auto numFailed = std::count_if(results.begin(), results.end(), [](const juce::Result& r) { return r.failed(); });
+
+    std::cout << files.size() - static_cast<int>(numFailed) << " of " << files.size() << " files, "
+              << juce::String(secondsRendered, 1) << " s of audio in " << juce::String(elapsedSeconds, 1) << " s on "
+              << pool.getNumWorkers() << " threads ("
+              << juce::String(elapsedSeconds > 0.0 ? secondsRendered / elapsedSeconds : 0.0, 1) << "x real time)" << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include "RenderParameters.h"
+#include "StateSerializer.h"
+#include "BinaryData.h"
+
+namespace render
+{
+    namespace
+    {
+        using Setter = void (*)(SpiceParameters&, float);
+
+        struct Field
+        {
+            const char* parameterID;
+            Setter set;
+        };
+
+        // Converted the same way SpiceAudioProcessor::getParameterValues() does
+        const Field fields[] =
+        {
+            { "inputGain",        [](SpiceParameters& p, float v) { p.inputGain = v; } },
+            { "drive",            [](SpiceParameters& p, float v) { p.drive = v; } },
+            { "mix",              [](SpiceParameters& p, float v) { p.mix = v; } },
+            { "output",           [](SpiceParameters& p, float v) { p.output = v; } },
+            { "model",            [](SpiceParameters& p, float v) { p.model = static_cast<int>(v); } },
+            { "tone",             [](SpiceParameters& p, float v) { p.tone = v; } },
+            { "bias",             [](SpiceParameters& p, float v) { p.bias = v; } },
+            { "quality",          [](SpiceParameters& p, float v) { p.quality = static_cast<int>(v); } },
+            { "bypass",           [](SpiceParameters& p, float v) { p.bypass = v > 0.5f; } },
+            { "lowCut",           [](SpiceParameters& p, float v) { p.lowCut = v; } },
+            { "highCut",          [](SpiceParameters& p, float v) { p.highCut = v; } },
+            { "lowCutSlope",      [](SpiceParameters& p, float v) { p.lowCutSlope = static_cast<int>(v); } },
+            { "highCutSlope",     [](SpiceParameters& p, float v) { p.highCutSlope = static_cast<int>(v); } },
+            { "gateEnabled",      [](SpiceParameters& p, float v) { p.gateEnabled = v > 0.5f; } },
+            { "gateThreshold",    [](SpiceParameters& p, float v) { p.gateThreshold = v; } },
+            { "gateHysteresis",   [](SpiceParameters& p, float v) { p.gateHysteresis = v; } },
+            { "gateHold",         [](SpiceParameters& p, float v) { p.gateHold = v; } },
+            { "gateLookahead",    [](SpiceParameters& p, float v) { p.gateLookahead = v; } },
+            { "cabinetEnabled",   [](SpiceParameters& p, float v) { p.cabinetEnabled = v > 0.5f; } },
+            { "cabinetModel",     [](SpiceParameters& p, float v) { p.cabinetModel = static_cast<int>(v); } },
+            { "cabinetPresence",  [](SpiceParameters& p, float v) { p.cabinetPresence = v; } },
+            { "cabinetMix",       [](SpiceParameters& p, float v) { p.cabinetMix = v; } },
+            { "limiterEnabled",   [](SpiceParameters& p, float v) { p.limiterEnabled = v > 0.5f; } },
+            { "midSideEnabled",   [](SpiceParameters& p, float v) { p.midSideEnabled = v > 0.5f; } },
+            { "midGain",          [](SpiceParameters& p, float v) { p.midGain = v; } },
+            { "sideGain",         [](SpiceParameters& p, float v) { p.sideGain = v; } },
+            { "stereoWidth",      [](SpiceParameters& p, float v) { p.stereoWidth = v; } },
+            { "autoGain",         [](SpiceParameters& p, float v) { p.autoGain = v > 0.5f; } },
+            { "autoGainMode",     [](SpiceParameters& p, float v) { p.autoGainMode = static_cast<int>(v); } },
+            { "multibandEnabled", [](SpiceParameters& p, float v) { p.multibandEnabled = v > 0.5f; } },
+            { "lowMidCrossover",  [](SpiceParameters& p, float v) { p.lowMidCrossover = v; } },
+            { "midHighCrossover", [](SpiceParameters& p, float v) { p.midHighCrossover = v; } },
+            { "lowDrive",         [](SpiceParameters& p, float v) { p.bandDrive[0] = v; } },
+            { "midDrive",         [](SpiceParameters& p, float v) { p.bandDrive[1] = v; } },
+            { "highDrive",        [](SpiceParameters& p, float v) { p.bandDrive[2] = v; } },
+            { "lowModel",         [](SpiceParameters& p, float v) { p.bandModel[0] = static_cast<int>(v); } },
+            { "midModel",         [](SpiceParameters& p, float v) { p.bandModel[1] = static_cast<int>(v); } },
+            { "highModel",        [](SpiceParameters& p, float v) { p.bandModel[2] = static_cast<int>(v); } }
+        };
+
+        /// PARAM elements anywhere below the given element, as written by the APVTS
+        void applyParameterElements(const juce::XmlElement& xml, SpiceParameters& parameters)
+        {
+            for (auto* child : xml.getChildIterator())
+            {
+                if (child->hasTagName("PARAM"))
+                    setParameter(parameters, child->getStringAttribute("id"),
+                                 static_cast<float>(child->getDoubleAttribute("value")));
+                else
+                    applyParameterElements(*child, parameters);
+            }
+        }
+
+        juce::Result loadBinaryState(const juce::MemoryBlock& data, SpiceParameters& parameters)
+        {
+            std::vector<std::pair<juce::uint32, float>> values;
+            juce::String presetName;
+
+            if (! StateSerializer::readValues(data.getData(), static_cast<int>(data.getSize()), values, presetName))
+                return juce::Result::fail("The plugin state was saved by a newer version of Spice FX");
+
+            for (const auto& [hash, value] : values)
+                for (const auto& field : fields)
+                    if (StateSerializer::hashParameterID(field.parameterID) == hash)
+                        field.set(parameters, value);
+
+            return juce::Result::ok();
+        }
+
+        juce::Result loadFactoryPreset(const juce::String& name, SpiceParameters& parameters)
+        {
+            auto xml = juce::parseXML(juce::String::createStringFromData(BinaryData::FactoryPresets_xml,
+                                                                          BinaryData::FactoryPresets_xmlSize));
+
+            if (xml != nullptr)
+            {
+                for (auto* preset : xml->getChildWithTagNameIterator("Preset"))
+                {
+                    if (preset->getStringAttribute("name").equalsIgnoreCase(name))
+                    {
+                        applyParameterElements(*preset, parameters);
+                        return juce::Result::ok();
+                    }
+                }
+            }
+
+            return juce::Result::fail("No preset file or factory preset named \"" + name + "\"");
+        }
+    }
+
+    bool setParameter(SpiceParameters& parameters, const juce::String& parameterID, float plainValue)
+    {
+        for (const auto& field : fields)
+        {
+            if (parameterID == field.parameterID)
+            {
+                field.set(parameters, plainValue);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    juce::Result loadParameters(const juce::String& presetOrFile, SpiceParameters& parameters)
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(presetOrFile);
+
+        if (! file.existsAsFile())
+            return loadFactoryPreset(presetOrFile, parameters);
+
+        juce::MemoryBlock data;
+
+        if (! file.loadFileAsData(data))
+            return juce::Result::fail("Could not read " + file.getFullPathName());
+
+        if (StateSerializer::isBinaryState(data.getData(), static_cast<int>(data.getSize())))
+            return loadBinaryState(data, parameters);
+
+        // Sessions saved before the binary format, then plain XML preset files
+        std::unique_ptr<juce::XmlElement> xml(juce::AudioProcessor::getXmlFromBinary(data.getData(), static_cast<int>(data.getSize())));
+
+        if (xml == nullptr)
+            xml = juce::parseXML(data.toString());
+
+        if (xml == nullptr)
+            return juce::Result::fail(file.getFullPathName() + " is neither a preset nor a plugin state");
+
+        applyParameterElements(*xml, parameters);
+        return juce::Result::ok();
+    }
+}
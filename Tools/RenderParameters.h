@@ -0,0 +1,16 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSP/SpiceEngine.h"
+
+namespace render
+{
+    /// Read the engine parameters from a saved .spice preset, a plugin state blob (binary
+    /// or the older XML form) or, if no such file exists, the factory preset of that name.
+    /// Parameters the source does not list keep the plugin's defaults.
+    juce::Result loadParameters(const juce::String& presetOrFile, SpiceParameters& parameters);
+
+    /// Set one parameter by its plugin parameter ID. Returns false for IDs the engine
+    /// does not use (e.g. the morph controls).
+    bool setParameter(SpiceParameters& parameters, const juce::String& parameterID, float plainValue);
+}
@@ -0,0 +1,261 @@
+#include "SampleConversion.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+// Samples are read and written with memcpy in native order; every platform JUCE builds
+// for is little-endian, like the files
+#if ! JUCE_LITTLE_ENDIAN
+ #error "The offline sample conversion assumes a little-endian host"
+#endif
+
+namespace offline
+{
+    namespace
+    {
+        constexpr float int16Scale = 1.0f / 32768.0f;
+        constexpr float int32Scale = 1.0f / 2147483648.0f;
+
+        // Largest float below 2^31; 2^31 itself would overflow to the most negative int32
+        constexpr float int32Limit = 2147483520.0f;
+
+        void int16ToFloat(const juce::int16* source, float* destination, size_t numSamples) noexcept
+        {
+            size_t i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS
+            const auto scale = _mm_set1_ps(int16Scale);
+
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                const auto samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+                // Unpacking into the high halves and shifting back sign-extends to 32 bits
+                const auto low = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), samples), 16);
+                const auto high = _mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), samples), 16);
+
+                _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+                _mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+            }
+           #elif JUCE_USE_ARM_NEON
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                const auto samples = vld1q_s16(source + i);
+                vst1q_f32(destination + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), int16Scale));
+                vst1q_f32(destination + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), int16Scale));
+            }
+           #endif
+
+            for (; i < numSamples; ++i)
+                destination[i] = static_cast<float>(source[i]) * int16Scale;
+        }
+
+        void int24ToFloat(const juce::uint8* source, float* destination, size_t numSamples) noexcept
+        {
+            if (numSamples == 0)
+                return;
+
+            // One unaligned 32-bit load per sample, shifted so the sample's sign bit becomes bit
+            // 31. The load reads one byte past the sample, so the last sample is done bytewise.
+            for (size_t i = 0; i + 1 < numSamples; ++i)
+            {
+                juce::uint32 word;
+                std::memcpy(&word, source + i * 3, sizeof(word));
+                destination[i] = static_cast<float>(static_cast<juce::int32>(word << 8)) * int32Scale;
+            }
+
+            const auto* last = source + (numSamples - 1) * 3;
+            const auto value = static_cast<juce::int32>(static_cast<juce::uint32>(last[0]) << 8
+                                                        | static_cast<juce::uint32>(last[1]) << 16
+                                                        | static_cast<juce::uint32>(last[2]) << 24);
+            destination[numSamples - 1] = static_cast<float>(value) * int32Scale;
+        }
+
+        void int32ToFloat(const juce::int32* source, float* destination, size_t numSamples) noexcept
+        {
+            size_t i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS
+            const auto scale = _mm_set1_ps(int32Scale);
+
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                const auto samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+                _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(samples), scale));
+            }
+           #elif JUCE_USE_ARM_NEON
+            for (; i + 4 <= numSamples; i += 4)
+                vst1q_f32(destination + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(source + i)), int32Scale));
+           #endif
+
+            for (; i < numSamples; ++i)
+                destination[i] = static_cast<float>(source[i]) * int32Scale;
+        }
+
+        void floatToInt16(const float* source, juce::int16* destination, size_t numSamples) noexcept
+        {
+            size_t i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS
+            const auto scale = _mm_set1_ps(32768.0f);
+
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                // Round to nearest, then let the saturating pack do the clipping
+                const auto low = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(source + i), scale));
+                const auto high = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(source + i + 4), scale));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packs_epi32(low, high));
+            }
+           #endif
+
+            for (; i < numSamples; ++i)
+            {
+                const auto value = std::lrint(juce::jlimit(-32768.0f, 32767.0f, source[i] * 32768.0f));
+                destination[i] = static_cast<juce::int16>(value);
+            }
+        }
+
+        void floatToInt24(const float* source, juce::uint8* destination, size_t numSamples) noexcept
+        {
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                const auto value = static_cast<juce::int32>(std::lrint(juce::jlimit(-8388608.0f, 8388607.0f, source[i] * 8388608.0f)));
+                destination[i * 3]     = static_cast<juce::uint8>(value);
+                destination[i * 3 + 1] = static_cast<juce::uint8>(value >> 8);
+                destination[i * 3 + 2] = static_cast<juce::uint8>(value >> 16);
+            }
+        }
+
+        void floatToInt32(const float* source, juce::int32* destination, size_t numSamples) noexcept
+        {
+            size_t i = 0;
+
+           #if JUCE_USE_SSE_INTRINSICS
+            const auto scale = _mm_set1_ps(2147483648.0f);
+            const auto lowest = _mm_set1_ps(-2147483648.0f);
+            const auto highest = _mm_set1_ps(int32Limit);
+
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                const auto scaled = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(source + i), scale), lowest), highest);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_cvtps_epi32(scaled));
+            }
+           #endif
+
+            for (; i < numSamples; ++i)
+                destination[i] = static_cast<juce::int32>(std::lrint(juce::jlimit(-2147483648.0f, int32Limit, source[i] * 2147483648.0f)));
+        }
+    }
+
+    int getBytesPerSample(SampleFormat format) noexcept
+    {
+        switch (format)
+        {
+            case SampleFormat::uint8:   return 1;
+            case SampleFormat::int16:   return 2;
+            case SampleFormat::int24:   return 3;
+            case SampleFormat::int32:   return 4;
+            case SampleFormat::float32: return 4;
+            case SampleFormat::float64: return 8;
+        }
+
+        return 0;
+    }
+
+    void convertToFloat(SampleFormat format, const void* source, float* destination, size_t numSamples) noexcept
+    {
+        switch (format)
+        {
+            case SampleFormat::uint8:
+            {
+                const auto* samples = static_cast<const juce::uint8*>(source);
+
+                for (size_t i = 0; i < numSamples; ++i)
+                    destination[i] = (static_cast<float>(samples[i]) - 128.0f) * (1.0f / 128.0f);
+
+                break;
+            }
+
+            case SampleFormat::int16:
+                int16ToFloat(static_cast<const juce::int16*>(source), destination, numSamples);
+                break;
+
+            case SampleFormat::int24:
+                int24ToFloat(static_cast<const juce::uint8*>(source), destination, numSamples);
+                break;
+
+            case SampleFormat::int32:
+                int32ToFloat(static_cast<const juce::int32*>(source), destination, numSamples);
+                break;
+
+            case SampleFormat::float32:
+                std::memcpy(destination, source, numSamples * sizeof(float));
+                break;
+
+            case SampleFormat::float64:
+            {
+                const auto* samples = static_cast<const juce::uint8*>(source);
+
+                for (size_t i = 0; i < numSamples; ++i)
+                {
+                    double value;
+                    std::memcpy(&value, samples + i * sizeof(double), sizeof(double));
+                    destination[i] = static_cast<float>(value);
+                }
+
+                break;
+            }
+        }
+    }
+
+    void convertFromFloat(SampleFormat format, const float* source, void* destination, size_t numSamples) noexcept
+    {
+        switch (format)
+        {
+            case SampleFormat::uint8:
+            {
+                auto* samples = static_cast<juce::uint8*>(destination);
+
+                for (size_t i = 0; i < numSamples; ++i)
+                    samples[i] = static_cast<juce::uint8>(std::lrint(juce::jlimit(0.0f, 255.0f, source[i] * 128.0f + 128.0f)));
+
+                break;
+            }
+
+            case SampleFormat::int16:
+                floatToInt16(source, static_cast<juce::int16*>(destination), numSamples);
+                break;
+
+            case SampleFormat::int24:
+                floatToInt24(source, static_cast<juce::uint8*>(destination), numSamples);
+                break;
+
+            case SampleFormat::int32:
+                floatToInt32(source, static_cast<juce::int32*>(destination), numSamples);
+                break;
+
+            case SampleFormat::float32:
+                std::memcpy(destination, source, numSamples * sizeof(float));
+                break;
+
+            case SampleFormat::float64:
+            {
+                auto* samples = static_cast<juce::uint8*>(destination);
+
+                for (size_t i = 0; i < numSamples; ++i)
+                {
+                    const auto value = static_cast<double>(source[i]);
+                    std::memcpy(samples + i * sizeof(double), &value, sizeof(double));
+                }
+
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cstddef>
+
+namespace offline
+{
+    /// Little-endian PCM sample encodings of the offline WAV reader and writer
+    enum class SampleFormat
+    {
+        uint8,
+        int16,
+        int24,
+        int32,
+        float32,
+        float64
+    };
+
+    int getBytesPerSample(SampleFormat format) noexcept;
+
+    /// Convert packed samples to float, with integer full scale at +-1 (the scaling JUCE's
+    /// own readers use). SSE2 or NEON does the bulk of the 16-bit, 32-bit and float formats.
+    void convertToFloat(SampleFormat format, const void* source, float* destination, size_t numSamples) noexcept;
+
+    /// Convert float to packed samples, rounding to nearest and clipping at full scale
+    void convertFromFloat(SampleFormat format, const float* source, void* destination, size_t numSamples) noexcept;
+}
@@ -0,0 +1,93 @@
+#include "WorkStealingPool.h"
+
+namespace render
+{
+    class WorkStealingPool::Worker : public juce::Thread
+    {
+    public:
+        Worker(WorkStealingPool& ownerPool, int index)
+            : juce::Thread("Render worker " + juce::String(index + 1)),
+              pool(ownerPool),
+              workerIndex(index)
+        {
+        }
+
+        void run() override
+        {
+            int task = 0;
+
+            // No tasks are added while the workers run, so empty queues everywhere means done
+            while (pool.popOwnTask(workerIndex, task) || pool.stealTask(workerIndex, task))
+                pool.currentJob(task, workerIndex);
+        }
+
+    private:
+        WorkStealingPool& pool;
+        const int workerIndex;
+    };
+
+    WorkStealingPool::WorkStealingPool(int numWorkers)
+    {
+        for (int i = 0; i < juce::jmax(1, numWorkers); ++i)
+        {
+            queues.push_back(std::make_unique<Queue>());
+            workers.push_back(std::make_unique<Worker>(*this, i));
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        for (auto& worker : workers)
+            worker->stopThread(-1);
+    }
+
+    void WorkStealingPool::run(int numTasks, Job job)
+    {
+        currentJob = std::move(job);
+
+        for (int task = 0; task < numTasks; ++task)
+            queues[static_cast<size_t>(task) % queues.size()]->tasks.push_back(task);
+
+        for (auto& worker : workers)
+            worker->startThread();
+
+        for (auto& worker : workers)
+            worker->waitForThreadToExit(-1);
+
+        currentJob = nullptr;
+    }
+
+    bool WorkStealingPool::popOwnTask(int workerIndex, int& task)
+    {
+        auto& queue = *queues[static_cast<size_t>(workerIndex)];
+        const juce::SpinLock::ScopedLockType sl(queue.lock);
+
+        if (queue.tasks.empty())
+            return false;
+
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    bool WorkStealingPool::stealTask(int workerIndex, int& task)
+    {
+        const auto numQueues = static_cast<int>(queues.size());
+
+        // Start with the next worker along, so thieves spread over different victims
+        for (int offset = 1; offset < numQueues; ++offset)
+        {
+            auto& queue = *queues[static_cast<size_t>((workerIndex + offset) % numQueues)];
+            const juce::SpinLock::ScopedLockType sl(queue.lock);
+
+            if (! queue.tasks.empty())
+            {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace render
+{
+    /// Runs a fixed set of independent tasks on a group of worker threads.
+    ///
+    /// Tasks are dealt round-robin into one queue per worker, in the order given, so callers
+    /// should pass the longest tasks first. A worker takes tasks from the front of its own
+    /// queue and, once that is empty, steals from the back of the others', which keeps every
+    /// core busy until the last task without workers contending on one shared queue.
+    class WorkStealingPool
+    {
+    public:
+        /// Called with the task index and the index of the worker running it
+        using Job = std::function<void(int taskIndex, int workerIndex)>;
+
+        explicit WorkStealingPool(int numWorkers);
+        ~WorkStealingPool();
+
+        int getNumWorkers() const { return static_cast<int>(workers.size()); }
+
+        /// Run the job for tasks 0 .. numTasks-1 and return once all of them are done
+        void run(int numTasks, Job job);
+
+    private:
+        class Worker;
+
+        struct Queue
+        {
+            juce::SpinLock lock;
+            std::deque<int> tasks;
+        };
+
+        bool popOwnTask(int workerIndex, int& task);
+        bool stealTask(int workerIndex, int& task);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::unique_ptr<Worker>> workers;
+        Job currentJob;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WorkStealingPool)
+    };
+}